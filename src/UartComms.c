@@ -1,460 +1,3077 @@
-//!
-//! @file 		UartComms.c
-//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
-//! @date 		12/09/2012
-//! @brief 		See UartComms.h
-//! @details
-//!		<b>Last Modified:			</b> 07/11/2012					\n
-//!		<b>Version:					</b> v1.0.2						\n
-//!		<b>Company:					</b> CladLabs					\n
-//!		<b>Project:					</b> Free Code Modules			\n
-//!		<b>Language:				</b> C							\n
-//!		<b>Compiler:				</b> GCC						\n
-//! 	<b>uC Model:				</b> PSoC5						\n
-//!		<b>Computer Architecture:	</b> ARM						\n
-//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
-//!		<b>Documentation Format:	</b> Doxygen					\n
-//!		<b>License:					</b> GPLv3						\n
-//!	
-//!		See the Doxygen documentation or UartComms.h for a detailed description on this module.
-//!
-
-//===============================================================================================//
-//========================================= INCLUDES ============================================//
-//===============================================================================================//
-
-// Standard PSoC includes
-#include <device.h>
-
-// FreeRTOS includes
-#include "FreeRTOS.h"
-#include "task.h"
-#include "queue.h"
-#include "semphr.h"
-
-// User includes
-#include "PublicDefinesAndTypeDefs.h"
-#include "Config.h"
-#include "UartComms.h"
-#include "UartDebug.h"
-
-//===============================================================================================//
-//============================================ GUARDS ===========================================//
-//===============================================================================================//
-
-#ifdef __cplusplus
-	extern "C" {
-#endif
-
-#ifndef configENABLE_TASK_UART_COMMS
-	#error Please define the switch configENABLE_TASK_UART_COMMS
-#endif
-
-#ifndef configPRINT_DEBUG_UART_COMMS
-	#error Please define the switch configPRINT_DEBUG_UART_COMMS
-#endif
-
-#ifndef configALLOW_SLEEP_UART_COMMS
-	#error Please define the switch configALLOW_SLEEP_UART_COMMS
-#endif
-
-//===============================================================================================//
-//==================================== PRIVATE DEFINES ==========================================//
-//===============================================================================================//
-
-
-#define TX_QUEUE_SIZE 							(1)		//!< Queue size is 1, messages are sent byte by byte across the queue.
-#define RX_QUEUE_SIZE 							(1)		//!< Queue size is 1, messages are sent byte by byte across the queue.
-#define TX_QUEUE_MAX_WAIT_TIME_MS 				(1000)	//!< Max time (in ms) to wait for putting character onto tx queue before error occurs
-//! Max time (in ms) to wait for another task to finish putting a string onto the tx queue
-//! Since only the DEBUG task is using this UART, the semaphore should never have to be
-//! waited on.
-#define	TX_SEMAPHORE_MAX_WAIT_TIME_MS 			(1000)
-//! Time to wait for another char to arrive on tx queue before the UART module is slept.
-#define TIME_TO_WAIT_FOR_ANOTHER_CHAR_BEFORE_SLEEPING_MS (5)
-
-//===============================================================================================//
-//=================================== PRIVATE TYPEDEF's =========================================//
-//===============================================================================================//
-
-// none
-
-//===============================================================================================//
-//============================= PRIVATE VARIABLES/STRUCTURES ====================================//
-//===============================================================================================//
-
-static xTaskHandle _txTaskHandle = 0;			//!< Handle for the TX task
-static xSemaphoreHandle _xTxMutexSemaphore = 0;	//!< Mutex semaphore for allowing only one task to write to the tx buffer at once
-static uint8 _uartDebugSleepLockCount = 0;				//! Used by the functions UartComms_SleepLock() and UartComms_SleepUnlock() to keep track of how many time the uart has been locked from sleeping.
-
-//! RX queue. Uart interrupt places characters on this queue as soon as they are received.
-static xQueueHandle _xRxQueue;
-
-//! Tx queue. Place characters on here to send them to the DEBUG module.
-static xQueueHandle _xTxQueue;
-
-//! Variable is TRUE if uart is asleep, otherwise FALSE.
-static bool_t _isAsleep = FALSE;
-
-//! Holds configurable UART parameters
-struct{
-	bool_t allowUartSleep;
-} _uartCommsParameters =
-{
-	.allowUartSleep = configALLOW_SLEEP_UART_COMMS
-};
-
-//===============================================================================================//
-//================================== PRIVATE FUNCTION PROTOTYPES ================================//
-//===============================================================================================//
-
-// General functions
-void UartComms_TxTask(void *pvParameters);
-
-// ISR's
-CY_ISR_PROTO(UartComms_UartRxIsr);
-
-//===============================================================================================//
-//===================================== PUBLIC FUNCTIONS ========================================//
-//===============================================================================================//
-
-
-void UartComms_Start(uint32 txTaskStackSize, uint8 txTaskPriority)
-{
-	#if(configENABLE_TASK_UART_COMMS == 1)
-		// Create the tx task
-		xTaskCreate(	&vUartComms_TxTask,
-						(signed portCHAR *) "Comms Uart TX Task",
-						txTaskStackSize,
-						NULL,
-						txTaskPriority,
-						&_txTaskHandle);
-	#endif
-					
-	// Create TX Queue
-	_xTxQueue = xQueueCreate(configUART_COMMS_TX_QUEUE_LENGTH, TX_QUEUE_SIZE);
-	
-	// Create RX Queue
-	_xRxQueue = xQueueCreate(configUART_COMMS_RX_QUEUE_LENGTH, RX_QUEUE_SIZE);
-	
-	// Create TX mutex semaphore
-	_xTxMutexSemaphore = xSemaphoreCreateMutex();
-	
-	// Start the debug UART. This is a Cpyress API call.
-	UartCpComms_Start();
-	
-}
-
-
-xTaskHandle UartComms_ReturnTxTaskHandle(void)
-{
-	return _txTaskHandle;
-}
-
-
-bool_t UartComms_PutString(const char* string)
-{
-	// Take semaphore to allow placing things on queue
-	if(xSemaphoreTake(_xTxMutexSemaphore, TX_SEMAPHORE_MAX_WAIT_TIME_MS/portTICK_RATE_MS) == pdFAIL)
-	{
-		#if(configPRINT_DEBUG_UART_COMMS == 1)
-			static char *msgTimeoutWaitingForTxQueueSemaphore = "UART_COMMS: Timeout waiting for tx queue semaphore.\r\n";
-			UartComms_PutString(msgTimeoutWaitingForTxQueueSemaphore);	
-		#endif
-		return FALSE;
-	}
-	
-	//! @todo Add error handling
-	
-	// Put characters onto tx queue one-by-one
-	while(*string != '\0')
-	{
-		// Put char on back of queue one-by-one
-		xQueueSendToBack(_xTxQueue, string, TX_QUEUE_MAX_WAIT_TIME_MS/portTICK_RATE_MS);
-		// Increment string
-		string++;
-		//! @todo Add error handling if queue fail
-	}
-	
-	// Return semaphore
-	xSemaphoreGive(_xTxMutexSemaphore);
-	
-	return TRUE;
-}
-
-
-void UartComms_GetChar(char* singleChar)
-{
-	xQueueReceive(_xRxQueue, singleChar, portMAX_DELAY);
-}
-
-
-bool_t UartComms_IsAsleep(void)
-{
-	if(_isAsleep == TRUE)
-		return TRUE;
-	else
-		return FALSE;
-}
-
-
-void UartComms_SleepLock(void)
-{
-	// Stop context switch since UART_COMMS_Wakeup() is not thread-safe
-	taskENTER_CRITICAL();
-	//vTaskSuspendAll();
-	// Wakeup UART if sleep lock was on 0 (a hence sleeping) as long as sleep is allowed
-	if((_isAsleep == TRUE) && (_uartCommsParameters.allowUartSleep == TRUE))
-	{
-		// Set flag to false to prevent multiple wake-ups
-		_isAsleep = FALSE;
-		// Cypress APU call
-		UartCpComms_Wakeup();
-		#if(configPRINT_DEBUG_UART_COMMS == 1)
-			static char *msgWakingUartComms = "UART_COMMS: Woke up comms UART.\r\n";
-			UartComms_PutString(msgWakingUartComms);	
-		#endif
-		
-	}
-		
-	// Increment sleep lock count. If statement should never be false, but added just as a
-	// precaution.
-	if(_uartDebugSleepLockCount != 255)
-		_uartDebugSleepLockCount++;
-	
-	// Allow context switch again
-	//xTaskResumeAll(); 
-	taskEXIT_CRITICAL();
-}
-
-
-void UartComms_SleepUnlock(void)
-{
-	// Prevent contect switch since UART_COMMS_Sleep() is not thread-safe
-	taskENTER_CRITICAL();
-	//vTaskSuspendAll();
-	// Decrement sleep lock count. If statement should never be false, but added just as a
-	// precaution
-	if(_uartDebugSleepLockCount != 0)
-		_uartDebugSleepLockCount--;
-		
-	// Sleep UART if sleepLockCount has reached 0
-	if((_uartDebugSleepLockCount == 0) && (_isAsleep == FALSE))
-	{
-		if(_uartCommsParameters.allowUartSleep == TRUE)
-		{
-			/*
-			#if(configPRINT_DEBUG_UART_COMMS == 1)
-				static char *msgSleepingUartComms = "UART_COMMS: Sleeping UART DEBUG.\r\n";
-				UartComms_PutString(msgSleepingUartComms);	
-				// Wait for message to complete since sleeping itself
-				while(!(UART_COMMS_ReadTxStatus() & UART_COMMS_TX_STS_COMPLETE));
-			#endif
-			*/
-			
-			// Sleep UART. Cypress API call.
-			UartCpComms_Sleep();
-			// Set flag to true so UartComms_SleepLock() knows to wake up device
-			_isAsleep = TRUE;
-		}
-		else
-		{
-			/* @debug Repeatedly prints itself
-			#if(configPRINT_DEBUG_UART_COMMS == 1)
-				static char *msgUartCommsSleepDisabled = "UART_COMMS: UART DEBUG sleep disabled. Keeping awake.\r\n";
-				UartComms_PutString(msgUartCommsSleepDisabled);	
-			#endif
-			*/
-		}
-	}
-	
-	// Allow context switch again
-	//xTaskResumeAll(); 
-	taskEXIT_CRITICAL();
-}
-
-//===============================================================================================//
-//==================================== PRIVATE FUNCTIONS ========================================//
-//===============================================================================================//
-
-//======================================== TASK FUNCTIONS =======================================//
-
-//! @brief 		DEBUG UART TX task
-//! @param		*pvParameters Void pointer (not used)
-//! @note		Not thread-safe. Do not call from any task, this function is a task that
-//!				is called by the FreeRTOS kernel
-//! @private
-void UartComms_TxTask(void *pvParameters)
-{
-	#if(configPRINT_DEBUG_UART_COMMS == 1)
-		static char* msgUartCommsTxTaskStarted = "UART_COMMS: Comms Uart TX task started.\r\n";
-		UartDebug_PutString(msgUartCommsTxTaskStarted);	
-	#endif
-
-	// Start USART RX interrupt, store in vector table the function address of UartComms_UartRxISR()
-	// This must be done in the task, since the interrupt calls xQueueSendToBackFromISR() which 
-	// must not be called before the scheduler starts (freeRTOS restriction).
-	IsrCpUartCommsRx_StartEx(UartComms_UartRxIsr);	
-	
-	typedef enum
-	{
-		ST_INIT,	//!< Initial state
-		ST_IDLE,	//!< Idle state. UART could be asleep in this state
-		ST_SENDING	//!< Sending state. UART is prevented from sleeping in this state until timeout
-	}txTaskState_t;
-	
-	txTaskState_t txTaskState = ST_INIT;
-
-	// Infinite task loop
-	for(;;)
-	{
-		//! Holds received character from the #xUartCommsTxQueue
-		char singleChar;
-		
-		// State machine
-		switch(txTaskState)
-		{
-			case ST_INIT:
-			{
-				// Allow UART to initially sleep if allowed to
-				//UartComms_SleepLock();
-				UartComms_SleepUnlock();
-				// Go to idle state
-				txTaskState = ST_IDLE;
-				break;
-			}
-			case ST_IDLE:
-			{
-				// Now UART is asleep, wait indefinetly for next char
-				xQueueReceive(_xTxQueue, &singleChar, portMAX_DELAY);
-
-				// Prevent UART from sleeping and wake-up if neccessary
-				UartComms_SleepLock();
-				// Goto sending state
-				txTaskState = ST_SENDING;
-				break;
-			}
-			case ST_SENDING:
-			{
-				// Send char using Cypress API.
-				// This function will not return untill there is room to put character on buffer
-				//! @todo Implement this in a blocking fashion?
-				UartCpComms_PutChar(singleChar);
-				
-				if(xQueueReceive(_xTxQueue, &singleChar, TIME_TO_WAIT_FOR_ANOTHER_CHAR_BEFORE_SLEEPING_MS/portTICK_RATE_MS) == pdFAIL)
-				{
-					// Wait until UART has completely finished sending the message
-					// (both the hardware buffer and the byte sent flag are set)
-					//while(!(UART_COMMS_ReadTxStatus() & (UART_COMMS_TX_STS_FIFO_EMPTY | UART_COMMS_TX_STS_COMPLETE)));	//(software wait)
-					while(!(UartCpComms_ReadTxStatus() & UartCpComms_TX_STS_COMPLETE));
-					//CyDelay(95);
-					// Now it is safe to unlock the UART to allow for sleeping
-					UartComms_SleepUnlock();
-					// Go back to idle state
-					txTaskState = ST_IDLE;
-				}
-				break;
-			}
-		}
-		// Finished, now loop for next message
-	}
-}
-
-//===============================================================================================//
-//============================================ ISR's ============================================//
-//===============================================================================================//
-
-//! @brief 		ISR called when UART rx buffer has new character
-//! @private
-CY_ISR(UartComms_UartRxIsr)
-{
-	// Check to see if we just slept, if so, wake up peripherals
-	//! @todo Get rid of this
-	//if(PowerMgmt_AreWeSleeping() == TRUE)
-	//	PowerMgmt_WakeUp();
-	
-	static portBASE_TYPE xHigherPriorityTaskWoken;
-	// Set to false on interrupt entry
-	xHigherPriorityTaskWoken = FALSE;
-
-	// Get received byte (lower 8-bits) and error info from UART (higher 8-bits) (total 16-bits)
-	do
-	{
-		uint16_t byte = UartCpComms_GetByte();
-		
-		// Mask error info
-		uint8_t status = (byte >> 8);
-		
-		// Check for error
-		if(status == (UartCpComms_RX_STS_BREAK | UartCpComms_RX_STS_PAR_ERROR | UartCpComms_RX_STS_STOP_ERROR 
-			| UartCpComms_RX_STS_OVERRUN | UartCpComms_RX_STS_SOFT_BUFF_OVER))
-		{
-			// UART error has occured
-			//Main_SetErrorLed();
-			#if(configPRINT_DEBUG_UartCpComms == 1)
-				if(status == UartCpComms_RX_STS_MRKSPC)
-				{
-					static char* msgErrorMarkOrSpaceWasReceivedInParityBit = "DEBUG_RX_INT: Error: Mark or space was received in parity bit.\r\n";
-					UartDebug_PutString(msgErrorMarkOrSpaceWasReceivedInParityBit);	
-				}
-				else if(status == UartCpComms_RX_STS_BREAK)
-				{
-					static char* msgBreakWasDetected = "DEBUG_RX_INT: Error: Break was detected.\r\n";
-					UartDebug_PutString(msgBreakWasDetected);	
-				}
-				else if(status == UartCpComms_RX_STS_PAR_ERROR)
-				{
-					static char* msgErorrParity = "DEBUG_RX_INT: Error: Parity error was detected.\r\n";
-					UartDebug_PutString(msgErorrParity);	
-				}
-				else if(status == UartCpComms_RX_STS_STOP_ERROR)
-				{
-					static char* msgErorrStop = "DEBUG_RX_INT: Error: Stop error was detected.\r\n";
-					UartDebug_PutString(msgErorrStop);	
-				}
-				else if(status == UartCpComms_RX_STS_OVERRUN)
-				{
-					static char* msgErrorFifoRxBufferOverrun = "DEBUG_RX_INT: Error: FIFO RX buffer was overrun.\r\n";
-					UartDebug_PutString(msgErrorFifoRxBufferOverrun);	
-				}
-				else if(status == UartCpComms_RX_STS_FIFO_NOTEMPTY)
-				{
-					static char* msgErrorRxBufferNotEmpty = "DEBUG_RX_INT: Error: RX buffer not empty.\r\n";
-					UartDebug_PutString(msgErrorRxBufferNotEmpty);	
-				}
-				else if(status == UartCpComms_RX_STS_ADDR_MATCH)
-				{
-					static char* msgErrorAddressMatch = "DEBUG_RX_INT: Error: Address match.\r\n";
-					UartDebug_PutString(msgErrorAddressMatch);	
-				}
-				else if(status == UartCpComms_RX_STS_SOFT_BUFF_OVER)
-				{
-					static char* msgErrorSoftwareBufferOverflowed = "DEBUG_RX_INT: Error: RX software buffer ovverflowed.\r\n";
-					UartDebug_PutString(msgErrorSoftwareBufferOverflowed);	
-				}
-			#endif
-		}
-		else
-		{
-			// Put byte in queue (ISR safe function)
-			xQueueSendToBackFromISR(_xRxQueue, &byte, &xHigherPriorityTaskWoken);
-		}
-	}
-	while((UartCpComms_ReadRxStatus() & UartCpComms_RX_STS_FIFO_NOTEMPTY) != 0x00);
-	
-	// Force a context swicth if interrupt unblocked a task with a higher or equal priority
-	// to the currently running task
-	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
-}
-
-//===============================================================================================//
-//========================================= GRAVEYARD ===========================================//
-//===============================================================================================//
-
-// none
-
-#ifdef __cplusplus
-	} // extern "C" {
-#endif
-
-// EOF
+//!
+//! @file 		UartComms.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		12/09/2012
+//! @brief 		See UartComms.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v2.15.1					\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!	
+//!		See the Doxygen documentation or UartComms.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// Platform includes (pulls in <device.h> on the PSoC)
+#include "UartCommsBackend.h"
+
+// System includes
+#include <string.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+// User includes
+#include "PublicDefinesAndTypeDefs.h"
+#include "Config.h"
+#include "UartComms.h"
+#include "UartDebug.h"
+#if(UART_COMMS_HOST_BUILD == 0)
+	#include "UartCommsBackendPsoc.h"
+#endif
+
+// Needed for UartComms_DumpTrace()
+#if((UART_COMMS_HOST_BUILD == 1) && (configUART_COMMS_ENABLE_TRACE == 1))
+	#include <stdio.h>
+#endif
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifndef configENABLE_TASK_UART_COMMS
+	#error Please define the switch configENABLE_TASK_UART_COMMS
+#endif
+
+#ifndef configPRINT_DEBUG_UART_COMMS
+	#error Please define the switch configPRINT_DEBUG_UART_COMMS
+#endif
+
+#ifndef configALLOW_SLEEP_UART_COMMS
+	#error Please define the switch configALLOW_SLEEP_UART_COMMS
+#endif
+
+// Optional settings
+#ifndef configUART_COMMS_MIN_IDLE_TIMEOUT_MS
+	//! Shortest time (in ms) to keep the UART awake after a burst before sleeping it
+	#define configUART_COMMS_MIN_IDLE_TIMEOUT_MS	(2)
+#endif
+
+#ifndef configUART_COMMS_MAX_IDLE_TIMEOUT_MS
+	//! Power budget. Longest time (in ms) to keep the UART awake after a burst when the next
+	//! one is predicted to arrive soon. Set equal to configUART_COMMS_MIN_IDLE_TIMEOUT_MS for
+	//! a fixed timeout.
+	#define configUART_COMMS_MAX_IDLE_TIMEOUT_MS	(50)
+#endif
+
+#ifndef configUART_COMMS_COALESCE
+	//! Set to 1 for ports to start in coalescing mode (see UartComms_SetCoalescing())
+	#define configUART_COMMS_COALESCE				(0)
+#endif
+
+#ifndef configUART_COMMS_COALESCE_THRESHOLD
+	//! In coalescing mode, staged bytes are sent once there are at least this many
+	#define configUART_COMMS_COALESCE_THRESHOLD		(configUART_COMMS_COALESCE_BUFFER_SIZE*3/4)
+#endif
+
+#ifndef configUART_COMMS_COALESCE_DEADLINE_MS
+	//! In coalescing mode, staged bytes are sent at most this long (in ms) after the first was staged
+	#define configUART_COMMS_COALESCE_DEADLINE_MS	(10)
+#endif
+
+#ifndef configUART_COMMS_COMPRESS
+	//! Set to 1 for ports to start with compression on (see UartComms_SetCompression())
+	#define configUART_COMMS_COMPRESS				(0)
+#endif
+
+#ifndef configUART_COMMS_COMPRESS_DEADLINE_MS
+	//! With compression on, a block is sent at most this long (in ms) after its first byte was staged
+	#define configUART_COMMS_COMPRESS_DEADLINE_MS	(50)
+#endif
+
+#ifndef configUART_COMMS_TRACE
+	//! Set to 1 for ports to start with tracing on (see UartComms_SetTracing())
+	#define configUART_COMMS_TRACE					(0)
+#endif
+
+#ifndef configUART_COMMS_FLOW_CONTROL
+	//! Flow control mode ports start with (see UartComms_SetFlowControl())
+	#define configUART_COMMS_FLOW_CONTROL			(UART_COMMS_FLOW_CONTROL_NONE)
+#endif
+
+#ifndef configUART_COMMS_RX_FLOW_HIGH_WATERMARK_PERCENT
+	//! With flow control on, the other end is told to stop once the rx buffer is this full (in %)
+	#define configUART_COMMS_RX_FLOW_HIGH_WATERMARK_PERCENT	(75)
+#endif
+
+#ifndef configUART_COMMS_RX_FLOW_LOW_WATERMARK_PERCENT
+	//! The other end is told to carry on once the rx buffer has drained to this (in %)
+	#define configUART_COMMS_RX_FLOW_LOW_WATERMARK_PERCENT	(25)
+#endif
+
+#ifndef configUART_COMMS_WAKE_LEAD_TIME_MS
+	//! How long (in ms) before an announced write (see UartComms_AnnounceWrite()) to wake the UART
+	#define configUART_COMMS_WAKE_LEAD_TIME_MS		(1)
+#endif
+
+#ifndef configUART_COMMS_BAUD_DRAIN_TIMEOUT_MS
+	//! Longest time (in ms) to wait for everything written to be sent before changing the baud
+	//! rate. Must be longer than configUART_COMMS_MAX_IDLE_TIMEOUT_MS.
+	#define configUART_COMMS_BAUD_DRAIN_TIMEOUT_MS	(200)
+#endif
+
+#ifndef configUART_COMMS_BAUD_SETTLE_MS
+	//! Time (in ms) received bytes are ignored for after changing the baud rate
+	#define configUART_COMMS_BAUD_SETTLE_MS			(5)
+#endif
+
+#ifndef configUART_COMMS_BAUD_PROBE_TIMEOUT_MS
+	//! Longest time (in ms) the initiator probes a new baud rate for before going back to the old one
+	#define configUART_COMMS_BAUD_PROBE_TIMEOUT_MS	(200)
+#endif
+
+#ifndef configUART_COMMS_BAUD_PROBE_INTERVAL_MS
+	//! Time (in ms) between probes of a new baud rate
+	#define configUART_COMMS_BAUD_PROBE_INTERVAL_MS	(20)
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Number of bytes the RX ISR collects on the stack before copying them into the rx buffer
+#define RX_ISR_BATCH_SIZE						(16)
+#define TX_BUFFER_MAX_WAIT_TIME_MS 				(1000)	//!< Max time (in ms) to wait for room in the tx buffer before error occurs
+//! Max time (in ms) to wait for the last byte to leave the UART before it is allowed to sleep
+#define TX_COMPLETE_MAX_WAIT_MS					(10)
+//! Shortest time (in ticks) the UART is kept awake after a burst
+#define MIN_IDLE_TIMEOUT						(configUART_COMMS_MIN_IDLE_TIMEOUT_MS/portTICK_RATE_MS)
+//! Longest time (in ticks) the UART is kept awake after a burst waiting for the next one
+#define MAX_IDLE_TIMEOUT						(configUART_COMMS_MAX_IDLE_TIMEOUT_MS/portTICK_RATE_MS)
+//! Longest time (in ticks) a byte stays in the staging buffer in coalescing mode
+#define COALESCE_DEADLINE						(configUART_COMMS_COALESCE_DEADLINE_MS/portTICK_RATE_MS)
+//! Longest time (in ticks) a byte stays in the staging buffer with compression on
+#define COMPRESS_DEADLINE						(configUART_COMMS_COMPRESS_DEADLINE_MS/portTICK_RATE_MS)
+//! How long (in ticks) before an announced write the UART is woken
+#define WAKE_LEAD_TIME							(configUART_COMMS_WAKE_LEAD_TIME_MS/portTICK_RATE_MS)
+//! Baud rate negotiation timing, in ticks (see the settings above)
+#define BAUD_DRAIN_TIMEOUT						(configUART_COMMS_BAUD_DRAIN_TIMEOUT_MS/portTICK_RATE_MS)
+#define BAUD_SETTLE_TIME						(configUART_COMMS_BAUD_SETTLE_MS/portTICK_RATE_MS + 1)
+#define BAUD_PROBE_TIMEOUT						(configUART_COMMS_BAUD_PROBE_TIMEOUT_MS/portTICK_RATE_MS)
+#define BAUD_PROBE_INTERVAL						(configUART_COMMS_BAUD_PROBE_INTERVAL_MS/portTICK_RATE_MS + 1)
+
+//! Time (in ticks, rounded up) for one byte to leave the shift register at baudRate (10 bits)
+#define BAUD_BYTE_TIME(baudRate)				((10*configTICK_RATE_HZ)/(baudRate) + 1)
+
+//! Types of baud rate negotiation message, the first byte of the payload. The rest is 32-bit
+//! words, least significant byte first.
+#define BAUD_MSG_REQUEST						(0x01)	//!< Initiator's rates
+#define BAUD_MSG_ACCEPT							(0x02)	//!< Rate picked from them
+#define BAUD_MSG_REJECT							(0x03)	//!< None of them are supported
+#define BAUD_MSG_PROBE							(0x04)	//!< Nonce, sent at the new rate
+#define BAUD_MSG_PROBE_ACK						(0x05)	//!< Nonce of the probe being answered
+#define BAUD_MSG_IDLE							(0x06)	//!< Idle rate the sender is dropping to
+//! Largest baud rate negotiation message
+#define BAUD_MSG_MAX_SIZE						(1 + 4*configUART_COMMS_BAUD_MAX_RATES)
+//! Bit of a message type in the typeMask given to UartComms_BaudWaitFor()
+#define BAUD_MSG_BIT(type)						((uint32)1 << (type))
+
+//! Number of bytes in the rx buffer at which the other end is told to stop sending
+#define RX_FLOW_HIGH_WATERMARK(port)			((port)->rxBufferSize*configUART_COMMS_RX_FLOW_HIGH_WATERMARK_PERCENT/100)
+//! Number of bytes in the rx buffer at which the other end is told to carry on
+#define RX_FLOW_LOW_WATERMARK(port)				((port)->rxBufferSize*configUART_COMMS_RX_FLOW_LOW_WATERMARK_PERCENT/100)
+//! Software flow control bytes (DC1 and DC3)
+#define FLOW_CONTROL_XON						(0x11)
+#define FLOW_CONTROL_XOFF						(0x13)
+//! How often (in ticks) the TX task looks at CTS while the other end has said stop, CTS has
+//! no interrupt
+#define TX_FLOW_CONTROL_POLL_PERIOD				(1)
+
+//! UART_COMMS_RX_STS_x flags which the RX ISR records as errors
+#define RX_ERROR_FLAGS							(UART_COMMS_RX_STS_BREAK | UART_COMMS_RX_STS_PAR_ERROR \
+												| UART_COMMS_RX_STS_STOP_ERROR | UART_COMMS_RX_STS_OVERRUN \
+												| UART_COMMS_RX_STS_SOFT_BUFF_OVER)
+//! UART_COMMS_RX_STS_x flags which mean the byte itself is bad, and is discarded. Overruns only
+//! mean earlier bytes were lost.
+#define RX_CORRUPT_FLAGS						(UART_COMMS_RX_STS_BREAK | UART_COMMS_RX_STS_PAR_ERROR \
+												| UART_COMMS_RX_STS_STOP_ERROR)
+
+//! Wraps statements which update UartComms_Port_t.stats, so they compile out with the stats
+#if(configUART_COMMS_ENABLE_STATS == 1)
+	#define STATS(statement)					do { statement; } while(0)
+#else
+	#define STATS(statement)
+#endif
+
+//! Most delimiters UartComms_ReadUntil() searches for a word at a time, more are searched for a
+//! byte at a time
+#define RX_SWAR_MAX_DELIMITERS					(4)
+
+//! TRUE if byte is set in a 256 bit delimiter map
+#define RX_IS_DELIMITER(map, byte)				((((map)[(byte) >> 5] >> ((byte) & 31)) & 1) != 0)
+
+//! TRUE if the port compresses bulk writes
+#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+	#define TX_IS_COMPRESSING(port)				((port)->txIsCompressing)
+#else
+	#define TX_IS_COMPRESSING(port)				(FALSE)
+#endif
+
+//! Storage for a semaphore created with UartComms_CreateSemaphore(), only used with static allocation
+#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+	#define SEMAPHORE_BUFFER(buffer)			(&(buffer))
+#else
+	#define SEMAPHORE_BUFFER(buffer)			(NULL)
+#endif
+
+//! Backend used if UartComms_SetBackend() is not called. On a host there is no default,
+//! the emulator has to be initialised with UartCommsBackendPosix_Init() first.
+#if(UART_COMMS_HOST_BUILD == 1)
+	#define DEFAULT_BACKEND						(NULL)
+#else
+	#define DEFAULT_BACKEND						(&UartCommsBackendPsoc_UartCpComms)
+#endif
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! Tags of the records in the tx buffer
+typedef enum
+{
+	TX_RECORD_COPIED,			//!< Record is the data to send
+	TX_RECORD_ZERO_COPY,		//!< Record is a UartComms_TxDescriptor_t pointing to the data to send
+	TX_RECORD_CONTINUED			//!< Record is data to send, and the next record of the chain follows it
+} txRecordTag_t;
+
+//! How UartComms_TxReserve() reserves a record
+typedef enum
+{
+	TX_RESERVE_SINGLE,			//!< Record on its own
+	TX_RESERVE_CHAIN_FIRST,		//!< First record of a chain, which holds the lane until UartCommsRecordBuffer_EndChain()
+	TX_RESERVE_CHAIN_NEXT		//!< Next record of the chain
+} txReserve_t;
+
+//! TX states of a port (UartComms_Port_t.txState)
+typedef enum
+{
+	ST_IDLE,					//!< Idle state. UART could be asleep in this state
+	ST_AWAITING_ANNOUNCED_WRITE,//!< Woken early for an announced write, waiting for it
+	ST_SENDING,					//!< TX ISR is sending a descriptor
+	ST_LINGERING,				//!< Nothing to send, waiting a short time for more before sleeping
+	ST_WAITING_FOR_COMPLETE		//!< Waiting for the last byte to leave the UART
+} txState_t;
+
+// Compile-time checks on the sizes set in Config.h, so a bad size fails the build rather than
+// the port at run time
+UART_COMMS_STATIC_ASSERT(UART_COMMS_IS_POWER_OF_TWO(configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE)
+	&& (configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE >= 16), urgentBufferSizeIsNotAPowerOfTwoOrIsOutOfRange)
+UART_COMMS_STATIC_ASSERT(UART_COMMS_TX_MAX_RECORD_LENGTH(configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE)
+	>= configUART_COMMS_TX_MIN_LINE_LENGTH, urgentBufferIsTooSmallForMinLineLength)
+#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+	UART_COMMS_STATIC_ASSERT((configUART_COMMS_COMPRESS_BLOCK_SIZE > 0)
+		&& (configUART_COMMS_COMPRESS_BLOCK_SIZE <= UART_COMMS_LZSS_MAX_BLOCK_SIZE), compressBlockSizeIsOutOfRange)
+#endif
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	UART_COMMS_STATIC_ASSERT(UART_COMMS_IS_POWER_OF_TWO(configUART_COMMS_RX_FRAME_QUEUE_SIZE)
+		&& (configUART_COMMS_RX_FRAME_QUEUE_SIZE >= 2 + 1 + configUART_COMMS_RX_FRAME_MAX_SIZE), rxFrameQueueSizeIsNotAPowerOfTwoOrIsOutOfRange)
+	// The RX ISR keeps a bit per channel in a uint32
+	UART_COMMS_STATIC_ASSERT((configUART_COMMS_NUM_RX_CHANNELS >= 1) && (configUART_COMMS_NUM_RX_CHANNELS <= 32), numRxChannelsIsOutOfRange)
+#endif
+#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+	UART_COMMS_STATIC_ASSERT(configUART_COMMS_BAUD_CHANNEL < configUART_COMMS_NUM_RX_CHANNELS, baudChannelIsOutOfRange)
+	UART_COMMS_STATIC_ASSERT((configUART_COMMS_BAUD_MAX_RATES > 0)
+		&& (BAUD_MSG_MAX_SIZE <= configUART_COMMS_RX_FRAME_MAX_SIZE), baudMaxRatesIsOutOfRange)
+#endif
+
+//===============================================================================================//
+//============================= PRIVATE VARIABLES/STRUCTURES ====================================//
+//===============================================================================================//
+
+//! Every started port, newest first. Only changed by UartComms_Start(), before the scheduler starts.
+static UartComms_Port_t *_firstPort = NULL;
+
+#if(configUART_COMMS_SHARED_TX_TASK == 1)
+	//! TX task which services every port
+	static UartComms_TxTaskInfo_t _sharedTxTask;
+#endif
+
+//===============================================================================================//
+//================================== PRIVATE FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+// General functions
+static xSemaphoreHandle UartComms_CreateSemaphore(void *buffer);
+static uint8* UartComms_TxReserve(UartComms_Port_t *port, uint8 lane, uint32 numBytes, txReserve_t reserve);
+static bool_t UartComms_TxWriteChain(UartComms_Port_t *port, uint8 lane, const uint8 *data, uint32 numBytes);
+static void UartComms_TxCommit(UartComms_Port_t *port, uint8 lane, uint8 *record, uint32 numBytes, txRecordTag_t tag);
+static void UartComms_TxCountWaitTime(UartComms_Port_t *port, portTickType timeWaited);
+static void UartComms_TxCountDrop(UartComms_Port_t *port, uint8 lane, uint32 numBytes);
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	static bool_t UartComms_TxPutFrame(UartComms_Port_t *port, uint8 lane, const uint8 *header, uint32 headerLength, const uint8 *payload, uint32 numBytes, bool_t isDelimited);
+#endif
+static const uint8* UartComms_TxPeekRecord(UartComms_Port_t *port, uint8 lane, uint32 *numBytes, uint8 *tag, portTickType *commitTime);
+static void UartComms_TxCountSent(UartComms_Port_t *port, uint8 lane, uint32 numWrites, uint32 numBytes, portTickType latencyTotal, portTickType latencyMax);
+static bool_t UartComms_TxReceiveDescriptor(UartComms_Port_t *port, uint8 lane, portTickType now);
+static bool_t UartComms_TxNextDescriptor(UartComms_Port_t *port, portTickType now, bool_t isSleepDue);
+static portTickType UartComms_TxCoalesceTimeLeft(const UartComms_Port_t *port, portTickType now);
+#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+	static void UartComms_TxCompressStaging(UartComms_Port_t *port);
+#endif
+static void UartComms_TxSendDescriptor(UartComms_Port_t *port);
+static void UartComms_TxFreeRecord(UartComms_Port_t *port, uint8 lane);
+static void UartComms_TxStartTimer(UartComms_Port_t *port, portTickType now, portTickType period);
+static portTickType UartComms_TxTimeUntilAnnouncedWrite(const UartComms_Port_t *port, portTickType now);
+static portTickType UartComms_TxTimeLeft(const UartComms_Port_t *port, portTickType now);
+static void UartComms_TxLearnIdleGap(UartComms_Port_t *port, portTickType now);
+static portTickType UartComms_TxPredictIdleTimeout(UartComms_Port_t *port);
+static void UartComms_TxStartBurst(UartComms_Port_t *port, portTickType now, bool_t hasSleepLock);
+static void UartComms_TxService(UartComms_Port_t *port, portTickType now);
+static bool_t UartComms_TxIsPeerStopped(const UartComms_Port_t *port);
+static void UartComms_TxSendPendingFlowByte(UartComms_Port_t *port);
+static portTickType UartComms_TxFlowControlTimeLeft(const UartComms_Port_t *port);
+static bool_t UartComms_SendFlowControlByte(UartComms_Port_t *port, uint8 byte);
+static bool_t UartComms_RxSetThrottle(UartComms_Port_t *port, bool_t isThrottled);
+static void UartComms_RxReleaseThrottle(UartComms_Port_t *port);
+static uint32 UartComms_RxFindDelimiter(const uint8 *data, uint32 numBytes, const char *delimiters, uint32 numDelimiters, const uint32 *delimiterMap);
+#if(configUART_COMMS_ENABLE_TRACE == 1)
+	static void UartComms_Trace(UartComms_Port_t *port, uint8 direction, portTickType now, const uint8 *data, uint32 numBytes);
+#endif
+#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+	static bool_t UartComms_BaudSend(UartComms_Port_t *port, uint8 type, const uint32 *words, uint8 numWords);
+	static uint8 UartComms_BaudWaitFor(UartComms_Port_t *port, uint32 typeMask, uint32 *words, uint8 *numWords, portTickType timeout);
+	static bool_t UartComms_BaudIsSupported(const UartComms_Port_t *port, uint32 baudRate);
+	static bool_t UartComms_BaudIsTxDrained(const UartComms_Port_t *port);
+	static bool_t UartComms_BaudChange(UartComms_Port_t *port, uint32 baudRate);
+	static bool_t UartComms_BaudProbe(UartComms_Port_t *port);
+	static bool_t UartComms_BaudServeRequest(UartComms_Port_t *port, const uint32 *rates, uint8 numRates);
+	static portTickType UartComms_BaudIdleTimeLeft(const UartComms_Port_t *port, portTickType now);
+#endif
+void UartComms_TxTask(void *pvParameters);
+
+// ISR's
+static void UartComms_UartRxIsr(void *arg);
+static void UartComms_RxIsrWriteBatch(UartComms_Port_t *port, const uint8 *batch, uint32 batchLength);
+static void UartComms_RxIsrRecordError(UartComms_Port_t *port, uint8 status);
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	static uint32 UartComms_RxIsrDecodeFrame(UartComms_Port_t *port, uint8 byte, uint8 status);
+#endif
+#if(configUART_COMMS_ENABLE_STATS == 1)
+	static void UartComms_RxCountErrors(UartComms_Port_t *port, uint8 status);
+#endif
+static void UartComms_UartTxIsr(void *arg);
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+
+void UartComms_SetBackend(UartComms_Port_t *port, const UartComms_Backend_t *backend)
+{
+	port->backend = backend;
+}
+
+
+bool_t UartComms_Start(UartComms_Port_t *port, uint32 txTaskStackSize, uint8 txTaskPriority)
+{
+	bool_t isCreated = TRUE;
+	uint8 lane;
+	#if(configUART_COMMS_ENABLE_FRAMING == 1)
+		uint8 channel;
+	#endif
+
+	if(port->backend == NULL)
+		port->backend = DEFAULT_BACKEND;
+
+	port->allowSleep = configALLOW_SLEEP_UART_COMMS;
+	port->txOverflowPolicy = configUART_COMMS_TX_OVERFLOW_POLICY;
+	port->txIsCoalescing = configUART_COMMS_COALESCE;
+	#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+		port->txIsCompressing = configUART_COMMS_COMPRESS;
+	#endif
+	#if(configUART_COMMS_ENABLE_TRACE == 1)
+		UartCommsTrace_Init(&port->trace, port->traceStorage, sizeof(port->traceStorage), (uint32)xTaskGetTickCount());
+		port->isTracing = configUART_COMMS_TRACE;
+	#endif
+	port->flowControl = configUART_COMMS_FLOW_CONTROL;
+	port->txState = ST_IDLE;
+
+	// Assume gaps between bursts are long until shown otherwise, so the UART sleeps quickly
+	port->txIdleGapAverage = 2*MAX_IDLE_TIMEOUT*16;
+	port->txIdleGapDeviation = 0;
+	port->txIdleTimeout = MIN_IDLE_TIMEOUT;
+
+	// Pick the TX task, and create it if it doesn't exist yet
+	#if(configUART_COMMS_SHARED_TX_TASK == 1)
+		port->txTask = &_sharedTxTask;
+	#else
+		port->txTask = &port->ownTxTask;
+	#endif
+
+	if(port->txTask->wakeSemaphore == 0)
+	{
+		port->txTask->wakeSemaphore = UartComms_CreateSemaphore(SEMAPHORE_BUFFER(port->txTask->wakeSemaphoreBuffer));
+		if(port->txTask->wakeSemaphore == 0)
+			return FALSE;
+
+		#if(configENABLE_TASK_UART_COMMS == 1)
+			// Create the tx task
+			#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+				(void)txTaskStackSize;
+				port->txTask->handle = xTaskCreateStatic(
+							&UartComms_TxTask,
+							"Comms Uart TX Task",
+							configUART_COMMS_TX_TASK_STACK_SIZE,
+							port->txTask,
+							txTaskPriority,
+							port->txTask->stack,
+							&port->txTask->taskBuffer);
+			#else
+				if(xTaskCreate(	&UartComms_TxTask,
+								(signed portCHAR *) "Comms Uart TX Task",
+								txTaskStackSize,
+								port->txTask,
+								txTaskPriority,
+								&port->txTask->handle) != pdPASS)
+					return FALSE;
+			#endif
+		#endif
+	}
+					
+	// Create TX buffers, and the semaphores used to signal space
+	for(lane = 0; lane < UART_COMMS_NUM_TX_PRIORITIES; lane++)
+	{
+		UartCommsRecordBuffer_Init(&port->txLanes[lane].buffer, port->txLanes[lane].storage, port->txLanes[lane].size);
+		port->txLanes[lane].chainSemaphore = UartComms_CreateSemaphore(SEMAPHORE_BUFFER(port->txLanes[lane].chainSemaphoreBuffer));
+		if(port->txLanes[lane].chainSemaphore == 0)
+			isCreated = FALSE;
+	}
+	port->txSpaceSemaphore = UartComms_CreateSemaphore(SEMAPHORE_BUFFER(port->txSpaceSemaphoreBuffer));
+	if(port->txSpaceSemaphore == 0)
+		isCreated = FALSE;
+	
+	// Create RX buffer, and the semaphore used to signal data
+	UartCommsRingBuffer_Init(&port->rxBuffer, port->rxBufferStorage, port->rxBufferSize);
+	UartCommsRingBuffer_Init(&port->rxErrorEvents, port->rxErrorEventStorage, sizeof(port->rxErrorEventStorage));
+	port->rxDataSemaphore = UartComms_CreateSemaphore(SEMAPHORE_BUFFER(port->rxDataSemaphoreBuffer));
+	if(port->rxDataSemaphore == 0)
+		isCreated = FALSE;
+
+	#if(configUART_COMMS_ENABLE_FRAMING == 1)
+		// Create the frame decoder and queue, and the semaphore used to signal frames
+		UartCommsFrameDecoder_Init(&port->rxFrameDecoder, &port->rxFrameBuffer[2], sizeof(port->rxFrameBuffer) - 2);
+		for(channel = 0; channel < configUART_COMMS_NUM_RX_CHANNELS; channel++)
+		{
+			UartComms_RxChannel_t *rxChannel = &port->rxChannels[channel];
+			UartCommsRingBuffer_Init(&rxChannel->frames, rxChannel->storage, sizeof(rxChannel->storage));
+			rxChannel->semaphore = UartComms_CreateSemaphore(SEMAPHORE_BUFFER(rxChannel->semaphoreBuffer));
+			if(rxChannel->semaphore == 0)
+				isCreated = FALSE;
+		}
+	#endif
+
+	// Out of heap. Don't let the TX task or the RX ISR near a half-made port.
+	if(isCreated == FALSE)
+		return FALSE;
+	
+	// Let the TX task find the port
+	port->nextPort = _firstPort;
+	_firstPort = port;
+	
+	// Start the UART, ready to receive
+	port->backend->start(port->backend->context);
+	if(port->flowControl == UART_COMMS_FLOW_CONTROL_RTS_CTS)
+		port->backend->setRts(port->backend->context, 1);
+
+	return TRUE;
+}
+
+
+xTaskHandle UartComms_ReturnTxTaskHandle(UartComms_Port_t *port)
+{
+	return port->txTask->handle;
+}
+
+
+bool_t UartComms_PutString(UartComms_Port_t *port, const char* string)
+{
+	return UartComms_WritePriority(port, (const uint8*)string, strlen(string), UART_COMMS_TX_PRIORITY_BULK);
+}
+
+
+bool_t UartComms_PutStringPriority(UartComms_Port_t *port, const char* string, UartComms_TxPriority_t priority)
+{
+	return UartComms_WritePriority(port, (const uint8*)string, strlen(string), priority);
+}
+
+
+bool_t UartComms_Write(UartComms_Port_t *port, const uint8* data, uint32 numBytes)
+{
+	return UartComms_WritePriority(port, data, numBytes, UART_COMMS_TX_PRIORITY_BULK);
+}
+
+
+bool_t UartComms_WritePriority(
+	UartComms_Port_t *port,
+	const uint8* data,
+	uint32 numBytes,
+	UartComms_TxPriority_t priority)
+{
+	uint8 lane = (uint8)priority;
+	uint8 *record;
+
+	if(numBytes == 0)
+		return TRUE;
+
+	if(numBytes > UartComms_GetMaxWriteLength(port, priority))
+		return UartComms_TxWriteChain(port, lane, data, numBytes);
+
+	record = UartComms_TxReserve(port, lane, numBytes, TX_RESERVE_SINGLE);
+	if(record == NULL)
+		return FALSE;
+
+	memcpy(record, data, numBytes);
+	UartComms_TxCommit(port, lane, record, numBytes, TX_RECORD_COPIED);
+
+	return TRUE;
+}
+
+
+uint32 UartComms_GetMaxWriteLength(UartComms_Port_t *port, UartComms_TxPriority_t priority)
+{
+	return UartCommsRecordBuffer_MaxRecordLength(&port->txLanes[(uint8)priority].buffer) - UART_COMMS_TX_RECORD_TIME_SIZE;
+}
+
+
+bool_t UartComms_PutBufferZeroCopy(
+	UartComms_Port_t *port,
+	const uint8* data,
+	uint32 numBytes,
+	UartComms_TxCompleteCallback_t callback,
+	void *callbackArg)
+{
+	UartComms_TxDescriptor_t descriptor;
+	uint8 *record;
+
+	descriptor.data = data;
+	descriptor.numBytes = numBytes;
+	descriptor.callback = callback;
+	descriptor.callbackArg = callbackArg;
+
+	// Only the descriptor goes in the tx buffer, in order with all other bulk writes
+	record = UartComms_TxReserve(port, UART_COMMS_TX_PRIORITY_BULK, sizeof(descriptor), TX_RESERVE_SINGLE);
+	if(record == NULL)
+		return FALSE;
+
+	memcpy(record, &descriptor, sizeof(descriptor));
+	UartComms_TxCommit(port, UART_COMMS_TX_PRIORITY_BULK, record, sizeof(descriptor), TX_RECORD_ZERO_COPY);
+
+	return TRUE;
+}
+
+
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	bool_t UartComms_PutFrame(UartComms_Port_t *port, const uint8* payload, uint32 numBytes)
+	{
+		return UartComms_TxPutFrame(port, UART_COMMS_TX_PRIORITY_BULK, NULL, 0, payload, numBytes, FALSE);
+	}
+
+
+	bool_t UartComms_PutChannelFrame(
+		UartComms_Port_t *port,
+		uint8 channel,
+		const uint8* payload,
+		uint32 numBytes)
+	{
+		return UartComms_TxPutFrame(port, UART_COMMS_TX_PRIORITY_BULK, &channel, sizeof(channel), payload, numBytes, FALSE);
+	}
+
+
+	void UartComms_SetRxChannels(UartComms_Port_t *port, bool_t isEnabled)
+	{
+		taskENTER_CRITICAL();
+		port->rxIsUsingChannels = isEnabled;
+		// A frame half way through decoding would go to the wrong place
+		UartCommsFrameDecoder_Abort(&port->rxFrameDecoder);
+		taskEXIT_CRITICAL();
+	}
+
+
+	void UartComms_SetRxFraming(UartComms_Port_t *port, bool_t isEnabled)
+	{
+		// Stops the RX ISR using the decoder while it is changed
+		taskENTER_CRITICAL();
+		port->rxIsFraming = isEnabled;
+		// Anything already being decoded may have started before this, skip to the next frame
+		UartCommsFrameDecoder_Abort(&port->rxFrameDecoder);
+		taskEXIT_CRITICAL();
+	}
+
+
+	bool_t UartComms_ReadFrame(
+		UartComms_Port_t *port,
+		uint8* frame,
+		uint32 maxNumBytes,
+		uint32 *numBytes,
+		portTickType timeout)
+	{
+		return UartComms_ReadChannelFrame(port, 0, frame, maxNumBytes, numBytes, timeout);
+	}
+
+
+	bool_t UartComms_ReadChannelFrame(
+		UartComms_Port_t *port,
+		uint8 channel,
+		uint8* frame,
+		uint32 maxNumBytes,
+		uint32 *numBytes,
+		portTickType timeout)
+	{
+		UartComms_RxChannel_t *rxChannel;
+		portTickType startTime = xTaskGetTickCount();
+
+		// Same rule as the RX ISR uses to route frames
+		if(channel >= configUART_COMMS_NUM_RX_CHANNELS)
+			return FALSE;
+		rxChannel = &port->rxChannels[channel];
+
+		for(;;)
+		{
+			portTickType timeLeft = portMAX_DELAY;
+
+			// The ISR writes the length and payload of a frame in one go
+			if(UartCommsRingBuffer_Count(&rxChannel->frames) != 0)
+			{
+				uint16 length;
+
+				UartCommsRingBuffer_Read(&rxChannel->frames, (uint8*)&length, sizeof(length));
+				if(length > maxNumBytes)
+				{
+					UartCommsRingBuffer_Read(&rxChannel->frames, frame, maxNumBytes);
+					UartCommsRingBuffer_Consume(&rxChannel->frames, length - maxNumBytes);
+					*numBytes = maxNumBytes;
+				}
+				else
+					*numBytes = UartCommsRingBuffer_Read(&rxChannel->frames, frame, length);
+				return TRUE;
+			}
+
+			if(timeout == 0)
+				return FALSE;
+
+			// Nothing yet, wait for the ISR. The semaphore may have been left given by frames
+			// which have already been read, in which case this loops round again.
+			if(timeout != portMAX_DELAY)
+			{
+				portTickType timeWaited = xTaskGetTickCount() - startTime;
+				if(timeWaited >= timeout)
+					return FALSE;
+				timeLeft = timeout - timeWaited;
+			}
+
+			if((xSemaphoreTake(rxChannel->semaphore, timeLeft) == pdFAIL)
+				&& (UartCommsRingBuffer_Count(&rxChannel->frames) == 0))
+				return FALSE;
+		}
+	}
+#endif
+
+
+void UartComms_SetTxOverflowPolicy(UartComms_Port_t *port, UartComms_TxOverflowPolicy_t policy)
+{
+	port->txOverflowPolicy = policy;
+}
+
+
+bool_t UartComms_SetFlowControl(UartComms_Port_t *port, UartComms_FlowControl_t mode)
+{
+	if((mode == UART_COMMS_FLOW_CONTROL_RTS_CTS)
+		&& ((port->backend->setRts == NULL) || (port->backend->readCts == NULL)))
+		return FALSE;
+
+	// A UART which is asleep can't receive, so wake it up. It is kept awake while flow
+	// control is on (see UartComms_SleepUnlock()).
+	UartComms_SleepLock(port);
+
+	taskENTER_CRITICAL();
+	// Let the other end go before switching, it may never be told under the new mode
+	if(port->rxIsThrottled == TRUE)
+		UartComms_RxSetThrottle(port, FALSE);
+	port->flowControl = mode;
+	port->txIsPeerStopped = FALSE;
+	if(mode == UART_COMMS_FLOW_CONTROL_RTS_CTS)
+		port->backend->setRts(port->backend->context, 1);
+	taskEXIT_CRITICAL();
+
+	UartComms_SleepUnlock(port);
+
+	// A send stopped under the old mode may be able to carry on, and an XON may be waiting
+	xSemaphoreGive(port->txTask->wakeSemaphore);
+	return TRUE;
+}
+
+
+void UartComms_SetCoalescing(UartComms_Port_t *port, bool_t isEnabled)
+{
+	port->txIsCoalescing = isEnabled;
+	// Anything still staged is sent by the TX task
+	xSemaphoreGive(port->txTask->wakeSemaphore);
+}
+
+
+#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+	void UartComms_SetCompression(UartComms_Port_t *port, bool_t isEnabled)
+	{
+		port->txIsCompressing = isEnabled;
+		// Anything still staged is sent by the TX task
+		xSemaphoreGive(port->txTask->wakeSemaphore);
+	}
+#endif
+
+
+#if(configUART_COMMS_ENABLE_LOG == 1)
+	bool_t UartComms_LogArgs(
+		UartComms_Port_t *port,
+		UartCommsLog_FormatId_t formatId,
+		const uint32 *args,
+		uint32 numArgs)
+	{
+		static const uint8 header[1] = { configUART_COMMS_LOG_CHANNEL };
+		uint8 record[UART_COMMS_LOG_RECORD_SIZE(UART_COMMS_LOG_MAX_ARGS)];
+		uint32 recordLength;
+
+		if(numArgs > UART_COMMS_LOG_MAX_ARGS)
+			return FALSE;
+
+		recordLength = UartCommsLog_EncodeRecord(record, (uint16)formatId, xTaskGetTickCount(), args, numArgs);
+		if(UartComms_TxPutFrame(port, UART_COMMS_TX_PRIORITY_BULK, header, sizeof(header), record, recordLength, TRUE) == FALSE)
+			return FALSE;
+
+		#if(configUART_COMMS_ENABLE_STATS == 1)
+		{
+			uint32 numBytes = 1 + UartCommsFrame_EncodeWithHeader(header, sizeof(header), record, recordLength, NULL);
+			taskENTER_CRITICAL();
+			port->stats.numLogRecords++;
+			port->stats.numLogBytes += numBytes;
+			taskEXIT_CRITICAL();
+		}
+		#endif
+		return TRUE;
+	}
+#endif
+
+
+#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+	void UartComms_SetBaudRates(UartComms_Port_t *port, const uint32 *rates, uint8 numRates, uint32 idleRate)
+	{
+		if(numRates > configUART_COMMS_BAUD_MAX_RATES)
+			numRates = configUART_COMMS_BAUD_MAX_RATES;
+
+		port->baudRates = rates;
+		port->numBaudRates = numRates;
+		port->baudIdleRate = idleRate;
+		port->baudRate = idleRate;
+	}
+
+
+	void UartComms_SetBaudIdleTimeout(UartComms_Port_t *port, portTickType timeout)
+	{
+		port->baudIdleTimeout = timeout;
+	}
+
+
+	bool_t UartComms_NegotiateBaudRate(UartComms_Port_t *port, portTickType timeout)
+	{
+		uint32 words[configUART_COMMS_BAUD_MAX_RATES];
+		uint8 numWords;
+		uint32 oldRate = port->baudRate;
+		bool_t isAgreed = FALSE;
+
+		if((port->backend->setBaudRate == NULL) || (port->numBaudRates == 0))
+			return FALSE;
+
+		// Both ends have to stay awake to hear each other
+		UartComms_SleepLock(port);
+
+		if((UartComms_BaudSend(port, BAUD_MSG_REQUEST, port->baudRates, port->numBaudRates) == TRUE)
+			&& (UartComms_BaudWaitFor(port, BAUD_MSG_BIT(BAUD_MSG_ACCEPT) | BAUD_MSG_BIT(BAUD_MSG_REJECT),
+				words, &numWords, timeout) == BAUD_MSG_ACCEPT)
+			&& (numWords == 1) && (UartComms_BaudIsSupported(port, words[0]) == TRUE))
+		{
+			uint32 newRate = words[0];
+
+			if(newRate == oldRate)
+				isAgreed = TRUE;
+			else
+			{
+				// The other end has already changed (or is about to), so from here on a failure
+				// means going back to the old rate, which it does too once the probes stop
+				if((UartComms_BaudChange(port, newRate) == TRUE) && (UartComms_BaudProbe(port) == TRUE))
+				{
+					isAgreed = TRUE;
+					STATS(taskENTER_CRITICAL(); port->stats.numBaudSwitches++; taskEXIT_CRITICAL());
+				}
+				else
+				{
+					if(port->baudRate != oldRate)
+						UartComms_BaudChange(port, oldRate);
+					STATS(taskENTER_CRITICAL(); port->stats.numBaudFallbacks++; taskEXIT_CRITICAL());
+				}
+			}
+		}
+
+		UartComms_SleepUnlock(port);
+		return isAgreed;
+	}
+
+
+	bool_t UartComms_ServeBaudRate(UartComms_Port_t *port, portTickType timeout)
+	{
+		uint32 words[configUART_COMMS_BAUD_MAX_RATES];
+		uint8 numWords;
+		bool_t isChanged = FALSE;
+		portTickType idleTimeLeft = UartComms_BaudIdleTimeLeft(port, xTaskGetTickCount());
+
+		if(idleTimeLeft == 0)
+		{
+			// Quiet for long enough, tell the other end and drop to the idle rate. The message
+			// is sent before the rate changes.
+			UartComms_SleepLock(port);
+			if(UartComms_BaudSend(port, BAUD_MSG_IDLE, &port->baudIdleRate, 1) == TRUE)
+				isChanged = UartComms_BaudChange(port, port->baudIdleRate);
+			UartComms_SleepUnlock(port);
+			return isChanged;
+		}
+		if(idleTimeLeft < timeout)
+			timeout = idleTimeLeft;
+
+		switch(UartComms_BaudWaitFor(port, BAUD_MSG_BIT(BAUD_MSG_REQUEST) | BAUD_MSG_BIT(BAUD_MSG_PROBE)
+			| BAUD_MSG_BIT(BAUD_MSG_IDLE), words, &numWords, timeout))
+		{
+			case BAUD_MSG_REQUEST:
+				isChanged = UartComms_BaudServeRequest(port, words, numWords);
+				break;
+			case BAUD_MSG_PROBE:
+				// A probe repeated because our answer was lost, answer it again
+				if(numWords == 1)
+					UartComms_BaudSend(port, BAUD_MSG_PROBE_ACK, words, 1);
+				break;
+			case BAUD_MSG_IDLE:
+				if((numWords == 1) && (words[0] == port->baudIdleRate) && (port->baudRate != port->baudIdleRate))
+				{
+					UartComms_SleepLock(port);
+					isChanged = UartComms_BaudChange(port, port->baudIdleRate);
+					UartComms_SleepUnlock(port);
+				}
+				break;
+			default:
+				break;
+		}
+
+		return isChanged;
+	}
+
+
+	uint32 UartComms_GetBaudRate(UartComms_Port_t *port)
+	{
+		return port->baudRate;
+	}
+#endif
+
+
+#if(configUART_COMMS_ENABLE_TRACE == 1)
+	void UartComms_SetTracing(UartComms_Port_t *port, bool_t isEnabled)
+	{
+		port->isTracing = isEnabled;
+	}
+
+
+	uint32 UartComms_ReadTrace(UartComms_Port_t *port, uint8 *data, uint32 maxNumBytes)
+	{
+		return UartCommsTrace_Read(&port->trace, data, maxNumBytes);
+	}
+
+
+	#if(UART_COMMS_HOST_BUILD == 1)
+		bool_t UartComms_DumpTrace(UartComms_Port_t *port, const char *fileName)
+		{
+			uint8 data[256];
+			uint32 numBytes;
+			bool_t isWritten = TRUE;
+			FILE *file = fopen(fileName, "ab");
+
+			if(file == NULL)
+				return FALSE;
+
+			// Appending, so the file position is its length
+			fseek(file, 0, SEEK_END);
+			if(ftell(file) == 0)
+			{
+				uint8 header[UART_COMMS_TRACE_FILE_HEADER_SIZE];
+				UartCommsTrace_EncodeFileHeader(header, configTICK_RATE_HZ);
+				if(fwrite(header, 1, sizeof(header), file) != sizeof(header))
+					isWritten = FALSE;
+			}
+
+			while((numBytes = UartCommsTrace_Read(&port->trace, data, sizeof(data))) != 0)
+			{
+				if(fwrite(data, 1, numBytes, file) != numBytes)
+					isWritten = FALSE;
+			}
+
+			if(fclose(file) != 0)
+				isWritten = FALSE;
+			return isWritten;
+		}
+	#endif
+#endif
+
+
+void UartComms_Flush(UartComms_Port_t *port)
+{
+	port->txIsFlushRequested = TRUE;
+	xSemaphoreGive(port->txTask->wakeSemaphore);
+}
+
+
+void UartComms_AnnounceWrite(UartComms_Port_t *port, portTickType ticksUntilWrite)
+{
+	taskENTER_CRITICAL();
+	port->txAnnounceTime = xTaskGetTickCount();
+	port->txAnnounceDelay = ticksUntilWrite;
+	port->txIsWriteAnnounced = TRUE;
+	taskEXIT_CRITICAL();
+
+	xSemaphoreGive(port->txTask->wakeSemaphore);
+}
+
+
+portTickType UartComms_GetIdleTimeout(UartComms_Port_t *port)
+{
+	return port->txIdleTimeout;
+}
+
+
+uint32 UartComms_GetNumDroppedTx(UartComms_Port_t *port)
+{
+	return port->txNumDropped;
+}
+
+
+bool_t UartComms_GetRxErrorEvent(UartComms_Port_t *port, UartComms_RxErrorEvent_t *event)
+{
+	// The ISR only ever writes whole events
+	if(UartCommsRingBuffer_Count(&port->rxErrorEvents) < sizeof(*event))
+		return FALSE;
+
+	UartCommsRingBuffer_Read(&port->rxErrorEvents, (uint8*)event, sizeof(*event));
+	return TRUE;
+}
+
+
+const char* UartComms_RxErrorFlagToString(uint8 flag)
+{
+	switch(flag)
+	{
+		case UART_COMMS_RX_STS_BREAK:
+			return "Break was detected";
+		case UART_COMMS_RX_STS_PAR_ERROR:
+			return "Parity error was detected";
+		case UART_COMMS_RX_STS_STOP_ERROR:
+			return "Stop error was detected";
+		case UART_COMMS_RX_STS_OVERRUN:
+			return "FIFO RX buffer was overrun";
+		case UART_COMMS_RX_STS_SOFT_BUFF_OVER:
+			return "RX software buffer overflowed";
+		default:
+			return NULL;
+	}
+}
+
+
+uint32 UartComms_ReportRxErrors(UartComms_Port_t *port)
+{
+	UartComms_RxErrorEvent_t event;
+	uint32 numEvents = 0;
+
+	while(UartComms_GetRxErrorEvent(port, &event) == TRUE)
+	{
+		numEvents++;
+
+		#if(configPRINT_DEBUG_UART_COMMS == 1)
+		{
+			uint8 flag;
+
+			// One line per flag
+			for(flag = 0x01; flag != 0x00; flag <<= 1)
+			{
+				const char *description = UartComms_RxErrorFlagToString(event.status & flag);
+				if(description != NULL)
+				{
+					UartDebug_PutString("UART_COMMS: RX error: ");
+					UartDebug_PutString(description);
+					UartDebug_PutString(".\r\n");
+				}
+			}
+		}
+		#endif
+	}
+
+	return numEvents;
+}
+
+
+void UartComms_GetStats(UartComms_Port_t *port, UartComms_Stats_t *stats, bool_t reset)
+{
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		// Stops the ISR's from counting half way through
+		taskENTER_CRITICAL();
+
+		// Include the time asleep so far
+		if(port->isAsleep == TRUE)
+		{
+			portTickType now = xTaskGetTickCount();
+			port->stats.timeAsleep += now - port->sleepStartTime;
+			port->sleepStartTime = now;
+		}
+
+		*stats = port->stats;
+		if(reset == TRUE)
+			memset(&port->stats, 0, sizeof(port->stats));
+
+		taskEXIT_CRITICAL();
+	#else
+		(void)port;
+		(void)reset;
+		memset(stats, 0, sizeof(*stats));
+	#endif
+}
+
+
+void UartComms_GetChar(UartComms_Port_t *port, char* singleChar)
+{
+	UartComms_Read(port, (uint8*)singleChar, 1, portMAX_DELAY);
+}
+
+
+uint32 UartComms_Read(UartComms_Port_t *port, uint8* data, uint32 maxNumBytes, portTickType timeout)
+{
+	portTickType startTime = xTaskGetTickCount();
+
+	for(;;)
+	{
+		uint32 numBytesRead;
+		portTickType timeLeft = portMAX_DELAY;
+
+		// Copy out everything that is available, up to maxNumBytes
+		numBytesRead = UartComms_ReadNonBlocking(port, data, maxNumBytes);
+		if((numBytesRead != 0) || (maxNumBytes == 0) || (timeout == 0))
+			return numBytesRead;
+
+		// Nothing yet, wait for the ISR. The semaphore may have been left given by bytes which
+		// have already been read, in which case this loops round again.
+		if(timeout != portMAX_DELAY)
+		{
+			portTickType timeWaited = xTaskGetTickCount() - startTime;
+			if(timeWaited >= timeout)
+				return 0;
+			timeLeft = timeout - timeWaited;
+		}
+
+		if(xSemaphoreTake(port->rxDataSemaphore, timeLeft) == pdFAIL)
+			return UartComms_ReadNonBlocking(port, data, maxNumBytes);
+	}
+}
+
+
+uint32 UartComms_ReadUntil(
+	UartComms_Port_t *port,
+	uint8* data,
+	uint32 maxNumBytes,
+	const char* delimiters,
+	portTickType timeout)
+{
+	portTickType startTime = xTaskGetTickCount();
+	uint32 numDelimiters = strlen(delimiters);
+	uint32 numBytesRead = 0;
+	uint32 i;
+
+	// Tell the RX ISR what to wake for. Done before looking, so a delimiter which arrives
+	// after the last look always wakes this.
+	memset(port->rxDelimiterMap, 0, sizeof(port->rxDelimiterMap));
+	for(i = 0; i < numDelimiters; i++)
+	{
+		uint8 delimiter = (uint8)delimiters[i];
+		port->rxDelimiterMap[delimiter >> 5] |= (uint32)1 << (delimiter & 31);
+	}
+	port->rxIsWaitingForDelimiter = TRUE;
+
+	for(;;)
+	{
+		const uint8 *chunk;
+		uint32 chunkLength;
+		bool_t isDelimiterFound = FALSE;
+		portTickType timeLeft = portMAX_DELAY;
+
+		// Copy out everything up to the first delimiter, one contiguous chunk at a time
+		while((numBytesRead < maxNumBytes)
+			&& ((chunkLength = UartCommsRingBuffer_Peek(&port->rxBuffer, &chunk)) != 0))
+		{
+			uint32 delimiterIndex;
+
+			if(chunkLength > maxNumBytes - numBytesRead)
+				chunkLength = maxNumBytes - numBytesRead;
+
+			delimiterIndex = UartComms_RxFindDelimiter(chunk, chunkLength, delimiters, numDelimiters, port->rxDelimiterMap);
+			if(delimiterIndex != chunkLength)
+			{
+				chunkLength = delimiterIndex + 1;
+				isDelimiterFound = TRUE;
+			}
+
+			memcpy(&data[numBytesRead], chunk, chunkLength);
+			UartCommsRingBuffer_Consume(&port->rxBuffer, chunkLength);
+			numBytesRead += chunkLength;
+
+			if(isDelimiterFound == TRUE)
+				break;
+		}
+		UartComms_RxReleaseThrottle(port);
+
+		if((isDelimiterFound == TRUE) || (numBytesRead == maxNumBytes) || (timeout == 0))
+			break;
+
+		// Wait for the ISR. The semaphore may have been left given by bytes which have already
+		// been read, in which case this loops round again.
+		if(timeout != portMAX_DELAY)
+		{
+			portTickType timeWaited = xTaskGetTickCount() - startTime;
+			if(timeWaited >= timeout)
+				break;
+			timeLeft = timeout - timeWaited;
+		}
+
+		xSemaphoreTake(port->rxDataSemaphore, timeLeft);
+	}
+
+	port->rxIsWaitingForDelimiter = FALSE;
+	return numBytesRead;
+}
+
+
+bool_t UartComms_ReadLine(UartComms_Port_t *port, char* line, uint32 maxLength, portTickType timeout)
+{
+	portTickType startTime = xTaskGetTickCount();
+
+	// Room for at least one byte and the null, or a "full" empty line would be returned
+	// forever without reading anything
+	if(maxLength < 2)
+	{
+		if(maxLength == 1)
+			line[0] = '\0';
+		return FALSE;
+	}
+
+	for(;;)
+	{
+		portTickType timeLeft = timeout;
+		uint32 length;
+		char delimiter;
+
+		if((timeout != portMAX_DELAY) && (timeout != 0))
+		{
+			portTickType timeWaited = xTaskGetTickCount() - startTime;
+			timeLeft = (timeWaited >= timeout) ? 0 : timeout - timeWaited;
+		}
+
+		// Leave room for the null
+		length = UartComms_ReadUntil(port, (uint8*)line, maxLength - 1, "\r\n", timeLeft);
+		delimiter = (length != 0) ? line[length - 1] : 0;
+
+		if((delimiter != '\r') && (delimiter != '\n'))
+		{
+			// Line is full, or the timeout expired
+			line[length] = '\0';
+			port->rxIsAfterCr = FALSE;
+			return (length == maxLength - 1) ? TRUE : FALSE;
+		}
+
+		// The '\n' of a "\r\n" is the end of the line already returned
+		if((length == 1) && (delimiter == '\n') && (port->rxIsAfterCr == TRUE))
+		{
+			port->rxIsAfterCr = FALSE;
+			continue;
+		}
+
+		line[length - 1] = '\0';
+		port->rxIsAfterCr = (delimiter == '\r') ? TRUE : FALSE;
+		return TRUE;
+	}
+}
+
+
+uint32 UartComms_ReadNonBlocking(UartComms_Port_t *port, uint8* data, uint32 maxNumBytes)
+{
+	uint32 numBytesRead = UartCommsRingBuffer_Read(&port->rxBuffer, data, maxNumBytes);
+	UartComms_RxReleaseThrottle(port);
+	return numBytesRead;
+}
+
+
+bool_t UartComms_IsAsleep(UartComms_Port_t *port)
+{
+	if(port->isAsleep == TRUE)
+		return TRUE;
+	else
+		return FALSE;
+}
+
+
+void UartComms_SleepLock(UartComms_Port_t *port)
+{
+	// Stop context switch since UART_COMMS_Wakeup() is not thread-safe
+	taskENTER_CRITICAL();
+	//vTaskSuspendAll();
+	// Wakeup UART if sleep lock was on 0 (a hence sleeping) as long as sleep is allowed
+	if((port->isAsleep == TRUE) && (port->allowSleep == TRUE))
+	{
+		// Set flag to false to prevent multiple wake-ups
+		port->isAsleep = FALSE;
+		// Wake-up the hardware
+		port->backend->wakeup(port->backend->context);
+		STATS(port->stats.numWakeups++);
+		STATS(port->stats.timeAsleep += xTaskGetTickCount() - port->sleepStartTime);
+		#if(configPRINT_DEBUG_UART_COMMS == 1)
+			static char *msgWakingUartComms = "UART_COMMS: Woke up comms UART.\r\n";
+			UartComms_PutString(port, msgWakingUartComms);	
+		#endif
+		
+	}
+		
+	// Increment sleep lock count. If statement should never be false, but added just as a
+	// precaution.
+	if(port->sleepLockCount != 255)
+		port->sleepLockCount++;
+	
+	// Allow context switch again
+	//xTaskResumeAll(); 
+	taskEXIT_CRITICAL();
+}
+
+
+void UartComms_SleepUnlock(UartComms_Port_t *port)
+{
+	// Prevent contect switch since UART_COMMS_Sleep() is not thread-safe
+	taskENTER_CRITICAL();
+	//vTaskSuspendAll();
+	// Decrement sleep lock count. If statement should never be false, but added just as a
+	// precaution
+	if(port->sleepLockCount != 0)
+		port->sleepLockCount--;
+		
+	// Sleep UART if sleepLockCount has reached 0. A UART which is asleep can't receive, so
+	// it is kept awake while flow control is on.
+	if((port->sleepLockCount == 0) && (port->isAsleep == FALSE))
+	{
+		if((port->allowSleep == TRUE) && (port->flowControl == UART_COMMS_FLOW_CONTROL_NONE))
+		{
+			/*
+			#if(configPRINT_DEBUG_UART_COMMS == 1)
+				static char *msgSleepingUartComms = "UART_COMMS: Sleeping UART DEBUG.\r\n";
+				UartComms_PutString(port, msgSleepingUartComms);	
+				// Wait for message to complete since sleeping itself
+				while(!(UART_COMMS_ReadTxStatus() & UART_COMMS_TX_STS_COMPLETE));
+			#endif
+			*/
+			
+			// Sleep UART
+			port->backend->sleep(port->backend->context);
+			STATS(port->stats.numSleeps++);
+			STATS(port->sleepStartTime = xTaskGetTickCount());
+			// Set flag to true so UartComms_SleepLock() knows to wake up device
+			port->isAsleep = TRUE;
+		}
+		else
+		{
+			/* @debug Repeatedly prints itself
+			#if(configPRINT_DEBUG_UART_COMMS == 1)
+				static char *msgUartCommsSleepDisabled = "UART_COMMS: UART DEBUG sleep disabled. Keeping awake.\r\n";
+				UartComms_PutString(port, msgUartCommsSleepDisabled);	
+			#endif
+			*/
+		}
+	}
+	
+	// Allow context switch again
+	//xTaskResumeAll(); 
+	taskEXIT_CRITICAL();
+}
+
+//===============================================================================================//
+//==================================== PRIVATE FUNCTIONS ========================================//
+//===============================================================================================//
+
+//===================================== GENERAL FUNCTIONS =======================================//
+
+//! @brief		Creates an empty binary semaphore, in buffer with static allocation, otherwise on the
+//!				FreeRTOS heap
+//! @param		buffer		StaticSemaphore_t to create it in, see SEMAPHORE_BUFFER()
+//! @returns	The semaphore, or 0 if the heap is exhausted
+//! @private
+static xSemaphoreHandle UartComms_CreateSemaphore(void *buffer)
+{
+	xSemaphoreHandle semaphore;
+
+	#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+		// Created empty
+		semaphore = xSemaphoreCreateBinaryStatic((StaticSemaphore_t*)buffer);
+	#else
+		// Binary semaphores are created "given", take it so it starts empty
+		(void)buffer;
+		vSemaphoreCreateBinary(semaphore);
+		if(semaphore != 0)
+			xSemaphoreTake(semaphore, 0);
+	#endif
+
+	return semaphore;
+}
+
+//! @brief		Reserves space for a record in a lane's tx buffer, following the port's overflow policy
+//! @details	While another writer's chain is open the lane is treated as full.
+//! @returns	Where to copy the record to, or NULL if the write was dropped
+//! @private
+static uint8* UartComms_TxReserve(UartComms_Port_t *port, uint8 lane, uint32 numBytes, txReserve_t reserve)
+{
+	portTickType startTime = xTaskGetTickCount();
+	portTickType timeout = TX_BUFFER_MAX_WAIT_TIME_MS/portTICK_RATE_MS;
+	bool_t hasWaited = FALSE;
+	xSemaphoreHandle spaceSemaphore = (reserve == TX_RESERVE_CHAIN_NEXT) ? port->txLanes[lane].chainSemaphore : port->txSpaceSemaphore;
+
+	for(;;)
+	{
+		uint8 *record;
+		portTickType timeWaited;
+
+		if(reserve == TX_RESERVE_SINGLE)
+			record = UartCommsRecordBuffer_Reserve(&port->txLanes[lane].buffer, numBytes + UART_COMMS_TX_RECORD_TIME_SIZE);
+		else
+			record = UartCommsRecordBuffer_ReserveChained(&port->txLanes[lane].buffer, numBytes + UART_COMMS_TX_RECORD_TIME_SIZE,
+				(reserve == TX_RESERVE_CHAIN_FIRST) ? 1 : 0);
+
+		if(record != NULL)
+		{
+			if(hasWaited == TRUE)
+			{
+				UartComms_TxCountWaitTime(port, xTaskGetTickCount() - startTime);
+				// Pass the wake-up on, in case another writer is waiting too and there is room for it
+				// (only the chain's own writer waits on the chain semaphore)
+				if(reserve != TX_RESERVE_CHAIN_NEXT)
+					xSemaphoreGive(port->txSpaceSemaphore);
+			}
+			// Leave room for the commit time
+			return record + UART_COMMS_TX_RECORD_TIME_SIZE;
+		}
+
+		if(port->txOverflowPolicy == UART_COMMS_TX_OVERFLOW_DROP)
+			break;
+
+		// Wait for the TX task to free a record
+		timeWaited = xTaskGetTickCount() - startTime;
+		if((timeWaited >= timeout)
+			|| (xSemaphoreTake(spaceSemaphore, timeout - timeWaited) == pdFAIL))
+			break;
+
+		hasWaited = TRUE;
+	}
+
+	if(hasWaited == TRUE)
+		UartComms_TxCountWaitTime(port, xTaskGetTickCount() - startTime);
+
+	UartComms_TxCountDrop(port, lane, numBytes);
+	return NULL;
+}
+
+
+//! @brief		Puts a write longer than one record in as a chain of records
+//! @details	Every record but the last is tagged TX_RECORD_CONTINUED. The chain holds the lane,
+//!				so no other writer's record lands between them, and the TX task sends them one
+//!				after the other. Only with the block policy, as all but the first record usually
+//!				have to wait for the TX task to send the ones before. If a record can't be put in,
+//!				the rest of the write is dropped and the chain ends where it is.
+//! @returns	TRUE on success, FALSE if the write was dropped (or cut short)
+//! @private
+static bool_t UartComms_TxWriteChain(UartComms_Port_t *port, uint8 lane, const uint8 *data, uint32 numBytes)
+{
+	uint32 maxRecordLength = UartComms_GetMaxWriteLength(port, (UartComms_TxPriority_t)lane);
+	txReserve_t reserve = TX_RESERVE_CHAIN_FIRST;
+	uint32 length;
+	uint8 *record;
+
+	if(port->txOverflowPolicy != UART_COMMS_TX_OVERFLOW_BLOCK)
+	{
+		UartComms_TxCountDrop(port, lane, numBytes);
+		return FALSE;
+	}
+
+	while(numBytes > 0)
+	{
+		length = (numBytes > maxRecordLength) ? maxRecordLength : numBytes;
+		record = UartComms_TxReserve(port, lane, length, reserve);
+		if(record == NULL)
+		{
+			// UartComms_TxReserve() counted this record as dropped, count the rest of the write too
+			STATS(taskENTER_CRITICAL();
+				port->stats.numTxBytesDropped += numBytes - length;
+				port->stats.txLanes[lane].numBytesDropped += numBytes - length;
+				taskEXIT_CRITICAL());
+			break;
+		}
+
+		memcpy(record, data, length);
+		data += length;
+		numBytes -= length;
+		UartComms_TxCommit(port, lane, record, length, (numBytes > 0) ? TX_RECORD_CONTINUED : TX_RECORD_COPIED);
+		reserve = TX_RESERVE_CHAIN_NEXT;
+	}
+
+	if(reserve == TX_RESERVE_CHAIN_FIRST)
+		return FALSE;
+
+	// Let the other writers in. If the chain was cut short, the TX task may be waiting for the
+	// rest of it, so wake it to find it has ended.
+	UartCommsRecordBuffer_EndChain(&port->txLanes[lane].buffer);
+	xSemaphoreGive(port->txSpaceSemaphore);
+	if(numBytes > 0)
+	{
+		xSemaphoreGive(port->txTask->wakeSemaphore);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+//! @brief		Counts a write which was dropped, because there was no room for it or it was too long
+//! @private
+static void UartComms_TxCountDrop(UartComms_Port_t *port, uint8 lane, uint32 numBytes)
+{
+	taskENTER_CRITICAL();
+	port->txNumDropped++;
+	STATS(port->stats.numTxBytesDropped += numBytes);
+	STATS(port->stats.txLanes[lane].numBytesDropped += numBytes);
+	taskEXIT_CRITICAL();
+
+	#if(configUART_COMMS_ENABLE_STATS != 1)
+		(void)lane;
+		(void)numBytes;
+	#endif
+}
+
+
+//! @brief		Adds the time a writer waited for room in the tx buffer to the stats
+//! @private
+static void UartComms_TxCountWaitTime(UartComms_Port_t *port, portTickType timeWaited)
+{
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		taskENTER_CRITICAL();
+		port->stats.txWaitTimeTotal += timeWaited;
+		if(timeWaited > port->stats.txWaitTimeMax)
+			port->stats.txWaitTimeMax = timeWaited;
+		taskEXIT_CRITICAL();
+	#else
+		(void)port;
+		(void)timeWaited;
+	#endif
+}
+
+
+//! @brief		Commits a record to a lane's tx buffer and wakes the TX task
+//! @param		record		As returned by UartComms_TxReserve()
+//! @private
+static void UartComms_TxCommit(UartComms_Port_t *port, uint8 lane, uint8 *record, uint32 numBytes, txRecordTag_t tag)
+{
+	record -= UART_COMMS_TX_RECORD_TIME_SIZE;
+
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+	{
+		// Racy if two writers commit at once, so the high-water marks may be slightly low
+		UartComms_TxLaneStats_t *laneStats = &port->stats.txLanes[lane];
+		uint32 numBytesUsed = UartCommsRecordBuffer_Count(&port->txLanes[lane].buffer);
+		portTickType now = xTaskGetTickCount();
+
+		memcpy(record, &now, sizeof(now));
+
+		if(numBytesUsed > laneStats->bufferHighWaterMark)
+			laneStats->bufferHighWaterMark = numBytesUsed;
+		if(numBytesUsed > port->stats.txBufferHighWaterMark)
+			port->stats.txBufferHighWaterMark = numBytesUsed;
+
+		// Start timing the wake-up latency
+		if((port->isAsleep == TRUE) && (port->txIsWakeRequested == FALSE))
+		{
+			port->txWakeRequestTime = now;
+			port->txIsWakeRequested = TRUE;
+		}
+	}
+	#else
+		(void)lane;
+	#endif
+
+	UartCommsRecordBuffer_Commit(record, numBytes + UART_COMMS_TX_RECORD_TIME_SIZE, (uint8)tag);
+	xSemaphoreGive(port->txTask->wakeSemaphore);
+}
+
+
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	//! @brief		Encodes a frame straight into a lane's tx buffer, as one write
+	//! @param		header		Bytes in front of the payload (the channel ID), may be NULL
+	//! @param		isDelimited	TRUE to start the frame with a delimiter as well, so a receiver
+	//!							sees the end of any text sent before it
+	//! @returns	TRUE on success, FALSE if the frame was dropped
+	//! @private
+	static bool_t UartComms_TxPutFrame(UartComms_Port_t *port, uint8 lane, const uint8 *header, uint32 headerLength, const uint8 *payload, uint32 numBytes, bool_t isDelimited)
+	{
+		uint32 numDelimiters = (isDelimited == TRUE) ? 1 : 0;
+		uint32 encodedLength = numDelimiters + UartCommsFrame_EncodeWithHeader(header, headerLength, payload, numBytes, NULL);
+		uint8 *record;
+
+		// Frames are never split
+		if(encodedLength > UartComms_GetMaxWriteLength(port, (UartComms_TxPriority_t)lane))
+		{
+			UartComms_TxCountDrop(port, lane, encodedLength);
+			return FALSE;
+		}
+
+		record = UartComms_TxReserve(port, lane, encodedLength, TX_RESERVE_SINGLE);
+		if(record == NULL)
+			return FALSE;
+
+		if(isDelimited == TRUE)
+			record[0] = UART_COMMS_FRAME_DELIMITER;
+		UartCommsFrame_EncodeWithHeader(header, headerLength, payload, numBytes, &record[numDelimiters]);
+		UartComms_TxCommit(port, lane, record, encodedLength, TX_RECORD_COPIED);
+
+		return TRUE;
+	}
+#endif
+
+
+//! @brief		Returns the oldest committed record in a lane's tx buffer, without blocking
+//! @param		numBytes		Set to the length of the record
+//! @param		tag				Set to the tag of the record
+//! @param		commitTime		Set to when the record was committed (0 if the stats are compiled out)
+//! @returns	The record, or NULL if there are none
+//! @note		Only call from the TX task
+//! @private
+static const uint8* UartComms_TxPeekRecord(UartComms_Port_t *port, uint8 lane, uint32 *numBytes, uint8 *tag, portTickType *commitTime)
+{
+	const uint8 *record = UartCommsRecordBuffer_Peek(&port->txLanes[lane].buffer, numBytes, tag);
+
+	if(record == NULL)
+		return NULL;
+
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		memcpy(commitTime, record, sizeof(*commitTime));
+	#else
+		*commitTime = 0;
+	#endif
+
+	*numBytes -= UART_COMMS_TX_RECORD_TIME_SIZE;
+	return record + UART_COMMS_TX_RECORD_TIME_SIZE;
+}
+
+
+//! @brief		Adds writes which are about to be sent to a lane's stats
+//! @param		latencyTotal	Sum of the time each write waited since being committed
+//! @param		latencyMax		Longest time one of the writes waited since being committed
+//! @note		Only call from the TX task
+//! @private
+static void UartComms_TxCountSent(UartComms_Port_t *port, uint8 lane, uint32 numWrites, uint32 numBytes, portTickType latencyTotal, portTickType latencyMax)
+{
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		UartComms_TxLaneStats_t *laneStats = &port->stats.txLanes[lane];
+
+		laneStats->numWrites += numWrites;
+		laneStats->numBytes += numBytes;
+		laneStats->latencyTotal += latencyTotal;
+		if(latencyMax > laneStats->latencyMax)
+			laneStats->latencyMax = latencyMax;
+	#else
+		(void)port;
+		(void)lane;
+		(void)numWrites;
+		(void)numBytes;
+		(void)latencyTotal;
+		(void)latencyMax;
+	#endif
+}
+
+
+//! @brief		Gets the next committed write from a lane's tx buffer, without blocking
+//! @returns	TRUE if there was one, otherwise FALSE
+//! @note		Only call from the TX task, while the TX ISR is idle
+//! @private
+static bool_t UartComms_TxReceiveDescriptor(UartComms_Port_t *port, uint8 lane, portTickType now)
+{
+	uint32 recordLength;
+	uint8 tag;
+	portTickType commitTime;
+	const uint8 *record = UartComms_TxPeekRecord(port, lane, &recordLength, &tag, &commitTime);
+
+	if(record == NULL)
+		return FALSE;
+
+	port->txLane = lane;
+	port->txIsChaining = (tag == TX_RECORD_CONTINUED) ? TRUE : FALSE;
+	if(tag == TX_RECORD_ZERO_COPY)
+	{
+		// Data is in the caller's memory, the record can be freed straight away
+		memcpy(&port->txDescriptor, record, sizeof(port->txDescriptor));
+		UartComms_TxFreeRecord(port, lane);
+		port->txIsHoldingRecord = FALSE;
+	}
+	else
+	{
+		// Send straight out of the tx buffer, and free the record once sent
+		port->txDescriptor.data = record;
+		port->txDescriptor.numBytes = recordLength;
+		port->txDescriptor.callback = NULL;
+		port->txDescriptor.callbackArg = NULL;
+		port->txIsHoldingRecord = TRUE;
+	}
+
+	// A chain counts as one write, timed by its last record
+	if(tag == TX_RECORD_CONTINUED)
+		UartComms_TxCountSent(port, lane, 0, port->txDescriptor.numBytes, 0, 0);
+	else
+		UartComms_TxCountSent(port, lane, 1, port->txDescriptor.numBytes, now - commitTime, now - commitTime);
+	return TRUE;
+}
+
+
+//! @brief		Gets the next write to send, urgent lane first, combining small bulk writes in
+//!				coalescing mode or compressing them
+//! @details	In coalescing mode, copied bulk writes are moved from the tx buffer into the staging
+//!				buffer as they arrive. The staging buffer is only sent once it reaches
+//!				configUART_COMMS_COALESCE_THRESHOLD, holds a newline, has passed its deadline,
+//!				a flush is requested, the UART is about to be slept, or the next write doesn't
+//!				fit in it (so writes stay in order). With compression on, the staging buffer holds
+//!				a whole block, and is compressed before it is sent. Newlines don't send it.
+//! @param		isSleepDue		TRUE if the UART will be slept if nothing is sent
+//! @returns	TRUE if there is a write to send, otherwise FALSE
+//! @note		Only call from the TX task, while the TX ISR is idle
+//! @private
+static bool_t UartComms_TxNextDescriptor(UartComms_Port_t *port, portTickType now, bool_t isSleepDue)
+{
+	bool_t isFlushDue = isSleepDue;
+	uint32 stagingSize = (TX_IS_COMPRESSING(port) == TRUE) ? configUART_COMMS_COMPRESS_BLOCK_SIZE : configUART_COMMS_COALESCE_BUFFER_SIZE;
+	const uint8 *record;
+	uint32 recordLength;
+	uint8 tag;
+	portTickType commitTime;
+
+	// Nothing new is started while the baud rate is changing
+	#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+		if(port->txIsHeld == TRUE)
+			return FALSE;
+	#endif
+
+	// The rest of a chain goes before anything else, even urgent writes. The chain is checked
+	// before the buffer, so a chain found ended has no more records to come.
+	if(port->txIsChaining == TRUE)
+	{
+		bool_t isChainOpen = (UartCommsRecordBuffer_IsChained(&port->txLanes[port->txLane].buffer) != 0) ? TRUE : FALSE;
+
+		if(UartComms_TxReceiveDescriptor(port, port->txLane, now) == TRUE)
+			return TRUE;
+		if(isChainOpen == TRUE)
+			return FALSE;
+
+		// Writer cut the chain short
+		port->txIsChaining = FALSE;
+	}
+
+	// Urgent writes go first, even ahead of staged ones
+	if(UartComms_TxReceiveDescriptor(port, UART_COMMS_TX_PRIORITY_URGENT, now) == TRUE)
+		return TRUE;
+
+	if((port->txIsCoalescing == FALSE) && (TX_IS_COMPRESSING(port) == FALSE) && (port->txStagingLength == 0))
+		return UartComms_TxReceiveDescriptor(port, UART_COMMS_TX_PRIORITY_BULK, now);
+
+	// Stage everything which fits
+	while((record = UartComms_TxPeekRecord(port, UART_COMMS_TX_PRIORITY_BULK, &recordLength, &tag, &commitTime)) != NULL)
+	{
+		// Mode may have changed since staging, so the staging buffer can be over stagingSize
+		if((tag != TX_RECORD_COPIED) || (port->txStagingLength + recordLength > stagingSize))
+		{
+			// Send what is staged first
+			isFlushDue = TRUE;
+			break;
+		}
+
+		if(port->txStagingLength == 0)
+		{
+			port->txStagingStartTime = now;
+			STATS(port->txStagingNumWrites = 0);
+			STATS(port->txStagingCommitTimeSum = 0);
+			STATS(port->txStagingOldestCommitTime = commitTime);
+		}
+		memcpy(&port->txStaging[port->txStagingLength], record, recordLength);
+		port->txStagingLength += recordLength;
+		if((TX_IS_COMPRESSING(port) == FALSE) && (memchr(record, '\n', recordLength) != NULL))
+			isFlushDue = TRUE;
+		STATS(port->txStagingNumWrites++);
+		STATS(port->txStagingCommitTimeSum += commitTime);
+
+		UartComms_TxFreeRecord(port, UART_COMMS_TX_PRIORITY_BULK);
+	}
+
+	if(port->txStagingLength == 0)
+	{
+		// Nothing staged, whatever is next is too big to stage, or zero-copy
+		port->txIsFlushRequested = FALSE;
+		return UartComms_TxReceiveDescriptor(port, UART_COMMS_TX_PRIORITY_BULK, now);
+	}
+
+	if((port->txStagingLength >= ((TX_IS_COMPRESSING(port) == TRUE) ? stagingSize : configUART_COMMS_COALESCE_THRESHOLD))
+		|| (port->txIsFlushRequested == TRUE)
+		|| ((port->txIsCoalescing == FALSE) && (TX_IS_COMPRESSING(port) == FALSE))
+		|| (UartComms_TxCoalesceTimeLeft(port, now) == 0))
+		isFlushDue = TRUE;
+
+	if(isFlushDue == FALSE)
+		return FALSE;
+
+	port->txIsFlushRequested = FALSE;
+	port->txDescriptor.data = port->txStaging;
+	port->txDescriptor.numBytes = port->txStagingLength;
+	port->txDescriptor.callback = NULL;
+	port->txDescriptor.callbackArg = NULL;
+	port->txIsHoldingRecord = FALSE;
+	port->txLane = UART_COMMS_TX_PRIORITY_BULK;
+
+	// Tick counts wrap, but the sum of the differences is still right modulo the tick type
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		UartComms_TxCountSent(port, UART_COMMS_TX_PRIORITY_BULK,
+			port->txStagingNumWrites, port->txStagingLength,
+			port->txStagingNumWrites*now - port->txStagingCommitTimeSum,
+			now - port->txStagingOldestCommitTime);
+	#endif
+
+	#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+		if(port->txIsCompressing == TRUE)
+			UartComms_TxCompressStaging(port);
+	#endif
+	return TRUE;
+}
+
+
+#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+	//! @brief		Compresses the staging buffer into a frame, and sends that instead if it is smaller
+	//! @details	The frame starts with a delimiter as well as ending with one, so a receiver sees
+	//!				the end of any raw bytes sent before it (urgent writes, or blocks which didn't
+	//!				compress) and resynchronises on it. A staging buffer bigger than a block (staged
+	//!				while coalescing, with a coalescing buffer bigger than a block, before
+	//!				compression was turned on) is sent as it is.
+	//! @note		Only call from the TX task, with txDescriptor pointing at the staging buffer
+	//! @private
+	static void UartComms_TxCompressStaging(UartComms_Port_t *port)
+	{
+		static const uint8 header[1] = { configUART_COMMS_COMPRESS_CHANNEL };
+		uint32 compressedLength;
+		uint32 frameLength;
+
+		STATS(port->stats.numCompressInBytes += port->txStagingLength);
+
+		// txCompressed and txCompressedFrame only have room for one block
+		if(port->txStagingLength > configUART_COMMS_COMPRESS_BLOCK_SIZE)
+		{
+			STATS(port->stats.numCompressOutBytes += port->txStagingLength);
+			return;
+		}
+
+		compressedLength = UartCommsLzss_Compress(&port->txEncoder, port->txStaging, port->txStagingLength, port->txCompressed);
+		frameLength = 1 + UartCommsFrame_EncodeWithHeader(header, sizeof(header), port->txCompressed, compressedLength, NULL);
+		if(frameLength >= port->txStagingLength)
+		{
+			// Didn't compress, send it as it is
+			STATS(port->stats.numCompressOutBytes += port->txStagingLength);
+			return;
+		}
+
+		port->txCompressedFrame[0] = UART_COMMS_FRAME_DELIMITER;
+		UartCommsFrame_EncodeWithHeader(header, sizeof(header), port->txCompressed, compressedLength, &port->txCompressedFrame[1]);
+		port->txDescriptor.data = port->txCompressedFrame;
+		port->txDescriptor.numBytes = frameLength;
+
+		// The staging buffer is free for the next block straight away
+		port->txStagingLength = 0;
+		STATS(port->stats.numCompressedBlocks++);
+		STATS(port->stats.numCompressOutBytes += frameLength);
+	}
+#endif
+
+
+//! @brief		Returns the number of ticks until the staging buffer has to be sent
+//! @returns	0 if it has to be sent now, portMAX_DELAY if there is nothing staged (or it is being sent)
+//! @private
+static portTickType UartComms_TxCoalesceTimeLeft(const UartComms_Port_t *port, portTickType now)
+{
+	portTickType deadline = (TX_IS_COMPRESSING(port) == TRUE) ? COMPRESS_DEADLINE : COALESCE_DEADLINE;
+	portTickType timeWaited;
+
+	if((port->txStagingLength == 0) || (port->txState == ST_SENDING))
+		return portMAX_DELAY;
+
+	timeWaited = now - port->txStagingStartTime;
+	if(timeWaited >= deadline)
+		return 0;
+	return deadline - timeWaited;
+}
+
+
+//! @brief		Hands the current write to the TX ISR
+//! @details	The TX ISR refills the FIFO each time it has room, and only wakes the TX task once
+//!				the data runs out. Records never wrap, so the data is always contiguous.
+//! @note		Only call from the TX task, while the TX ISR is idle
+//! @private
+static void UartComms_TxSendDescriptor(UartComms_Port_t *port)
+{
+	if(port->txDescriptor.numBytes == 0)
+		return;
+
+	#if(configUART_COMMS_ENABLE_TRACE == 1)
+		if(port->isTracing == TRUE)
+		{
+			// The RX ISR writes to the trace too
+			taskENTER_CRITICAL();
+			UartComms_Trace(port, UART_COMMS_TRACE_DIR_TX, xTaskGetTickCount(), port->txDescriptor.data, port->txDescriptor.numBytes);
+			taskEXIT_CRITICAL();
+		}
+	#endif
+
+	port->txIsrData = port->txDescriptor.data;
+	port->txIsrNumBytesLeft = port->txDescriptor.numBytes;
+	port->txIsrBusy = TRUE;
+
+	// FIFO has room (the ISR is idle), so the interrupt fires straight away
+	port->backend->setTxInterruptMode(port->backend->context, UART_COMMS_TX_STS_FIFO_NOT_FULL);
+}
+
+
+//! @brief		Frees the oldest record in a lane's tx buffer, and wakes a writer waiting for room
+//! @note		Only call from the TX task
+//! @private
+static void UartComms_TxFreeRecord(UartComms_Port_t *port, uint8 lane)
+{
+	UartCommsRecordBuffer_Free(&port->txLanes[lane].buffer);
+	xSemaphoreGive(port->txSpaceSemaphore);
+
+	// The writer putting a chain in waits on its own semaphore, so a writer which can't go
+	// until the chain has ended never takes its wake-up
+	if(UartCommsRecordBuffer_IsChained(&port->txLanes[lane].buffer) != 0)
+		xSemaphoreGive(port->txLanes[lane].chainSemaphore);
+}
+
+
+//! @brief		Starts the port's timer, which the TX task wakes up for
+//! @private
+static void UartComms_TxStartTimer(UartComms_Port_t *port, portTickType now, portTickType period)
+{
+	port->txTimerStart = now;
+	port->txTimerPeriod = period;
+}
+
+
+//! @brief		Returns the number of ticks until the announced write is due, 0 if it is already due
+//! @private
+static portTickType UartComms_TxTimeUntilAnnouncedWrite(const UartComms_Port_t *port, portTickType now)
+{
+	portTickType timeWaited = now - port->txAnnounceTime;
+
+	if(timeWaited >= port->txAnnounceDelay)
+		return 0;
+	return port->txAnnounceDelay - timeWaited;
+}
+
+
+//! @brief		Returns the number of ticks until the TX task next has to service the port
+//! @returns	0 if it has to now, portMAX_DELAY if the port isn't timing anything
+//! @private
+static portTickType UartComms_TxTimeLeft(const UartComms_Port_t *port, portTickType now)
+{
+	portTickType timeWaited;
+
+	if(port->txState == ST_IDLE)
+	{
+		// Wake up in time for an announced write
+		portTickType timeUntilWrite;
+		if(port->txIsWriteAnnounced == FALSE)
+			return portMAX_DELAY;
+		timeUntilWrite = UartComms_TxTimeUntilAnnouncedWrite(port, now);
+		if(timeUntilWrite <= WAKE_LEAD_TIME)
+			return 0;
+		return timeUntilWrite - WAKE_LEAD_TIME;
+	}
+
+	if(port->txState == ST_SENDING)
+	{
+		// Only timing anything while stopped by CTS, which is polled. An XON wakes the TX
+		// task itself.
+		if((port->txIsrBusy == TRUE) || (port->txIsrNumBytesLeft == 0)
+			|| (port->flowControl != UART_COMMS_FLOW_CONTROL_RTS_CTS))
+			return portMAX_DELAY;
+	}
+
+	timeWaited = now - port->txTimerStart;
+	if(timeWaited >= port->txTimerPeriod)
+		return 0;
+	return port->txTimerPeriod - timeWaited;
+}
+
+
+//! @brief		Updates the idle gap predictor with the gap which has just ended
+//! @details	Keeps exponentially weighted moving averages (weight 1/4) of the gap between bursts
+//!				and of its deviation, in 1/16's of a tick.
+//! @private
+static void UartComms_TxLearnIdleGap(UartComms_Port_t *port, portTickType now)
+{
+	portTickType gap = now - port->txIdleStartTime;
+	int32 error;
+
+	// A long sleep only needs to be counted as "too long to stay awake for", capping it stops
+	// it from swamping the average
+	if(gap > 2*MAX_IDLE_TIMEOUT)
+		gap = 2*MAX_IDLE_TIMEOUT;
+
+	error = (int32)(gap*16) - (int32)port->txIdleGapAverage;
+	port->txIdleGapAverage = (uint32)((int32)port->txIdleGapAverage + error/4);
+	if(error < 0)
+		error = -error;
+	port->txIdleGapDeviation = (uint32)((int32)port->txIdleGapDeviation + (error - (int32)port->txIdleGapDeviation)/4);
+}
+
+
+//! @brief		Picks how long to stay awake after a burst before sleeping
+//! @details	If the next burst is predicted (average gap plus two deviations) to start within
+//!				#MAX_IDLE_TIMEOUT, staying awake until then costs less than a sleep/wake transition
+//!				and avoids the wake-up latency. Otherwise the UART is slept after #MIN_IDLE_TIMEOUT.
+//! @private
+static portTickType UartComms_TxPredictIdleTimeout(UartComms_Port_t *port)
+{
+	portTickType predictedGap = (port->txIdleGapAverage + 2*port->txIdleGapDeviation)/16 + 1;
+
+	if(predictedGap > MAX_IDLE_TIMEOUT)
+		return MIN_IDLE_TIMEOUT;
+	if(predictedGap < MIN_IDLE_TIMEOUT)
+		return MIN_IDLE_TIMEOUT;
+	return predictedGap;
+}
+
+
+//! @brief		Starts sending the write just received, and goes to the sending state
+//! @param		hasSleepLock	TRUE if the TX task already holds a sleep lock on the port
+//! @private
+static void UartComms_TxStartBurst(UartComms_Port_t *port, portTickType now, bool_t hasSleepLock)
+{
+	if(port->txState != ST_SENDING)
+		UartComms_TxLearnIdleGap(port, now);
+	port->txIsWriteAnnounced = FALSE;
+
+	if(hasSleepLock == FALSE)
+	{
+		#if(configUART_COMMS_ENABLE_STATS == 1)
+			bool_t wasAsleep = port->isAsleep;
+		#endif
+
+		// Prevent UART from sleeping and wake-up if neccessary
+		UartComms_SleepLock(port);
+
+		#if(configUART_COMMS_ENABLE_STATS == 1)
+			// Time from the first write committed while asleep, to the UART sending it
+			if((wasAsleep == TRUE) && (port->txIsWakeRequested == TRUE))
+			{
+				portTickType latency = now - port->txWakeRequestTime;
+				port->stats.numWakeLatencySamples++;
+				port->stats.wakeLatencyTotal += latency;
+				if(latency > port->stats.wakeLatencyMax)
+					port->stats.wakeLatencyMax = latency;
+			}
+			port->txIsWakeRequested = FALSE;
+		#endif
+	}
+
+	UartComms_TxSendDescriptor(port);
+	port->txState = ST_SENDING;
+}
+
+
+//! @brief		Moves a port's TX state machine on as far as it can go without blocking
+//! @details	Called by the TX task every time it wakes up, for every port it services.
+//! @note		Only call from the TX task
+//! @private
+static void UartComms_TxService(UartComms_Port_t *port, portTickType now)
+{
+	// An XON/XOFF which didn't fit in the hardware FIFO, and the TX ISR isn't running to send it
+	if((port->txPendingFlowByte != 0) && (port->txIsrBusy == FALSE))
+		UartComms_TxSendPendingFlowByte(port);
+
+	for(;;)
+	{
+		switch(port->txState)
+		{
+			case ST_IDLE:
+			{
+				// UART could be asleep, see if there is anything to send
+				if(UartComms_TxNextDescriptor(port, now, FALSE) == TRUE)
+				{
+					UartComms_TxStartBurst(port, now, FALSE);
+					break;
+				}
+
+				// Wake up ahead of an announced write, so it doesn't pay for the wake-up
+				if((port->txIsWriteAnnounced == TRUE) && (UartComms_TxTimeLeft(port, now) == 0))
+				{
+					UartComms_SleepLock(port);
+					STATS(port->stats.numAnnouncedWakeups++);
+					UartComms_TxStartTimer(port, now,
+						UartComms_TxTimeUntilAnnouncedWrite(port, now) + MAX_IDLE_TIMEOUT);
+					port->txState = ST_AWAITING_ANNOUNCED_WRITE;
+					break;
+				}
+				return;
+			}
+			case ST_AWAITING_ANNOUNCED_WRITE:
+			{
+				// Already holding a sleep lock
+				if(UartComms_TxNextDescriptor(port, now, FALSE) == TRUE)
+				{
+					UartComms_TxStartBurst(port, now, TRUE);
+					break;
+				}
+				if(UartComms_TxTimeLeft(port, now) != 0)
+					return;
+
+				// Write never came
+				port->txIsWriteAnnounced = FALSE;
+				UartComms_SleepUnlock(port);
+				port->txState = ST_IDLE;
+				break;
+			}
+			case ST_SENDING:
+			{
+				// Wait for the TX ISR to finish
+				if(port->txIsrBusy == TRUE)
+					return;
+
+				// The TX ISR stopped part way through because the other end said stop. Carry
+				// on once it says go.
+				if(port->txIsrNumBytesLeft != 0)
+				{
+					if(UartComms_TxIsPeerStopped(port) == TRUE)
+					{
+						UartComms_TxStartTimer(port, now, TX_FLOW_CONTROL_POLL_PERIOD);
+						return;
+					}
+					port->txIsrBusy = TRUE;
+					port->backend->setTxInterruptMode(port->backend->context, UART_COMMS_TX_STS_FIFO_NOT_FULL);
+					return;
+				}
+
+				// All bytes are in the hardware FIFO. Free the record and wake a writer waiting
+				// for the space, or let the caller know their buffer can be reused.
+				if(port->txIsHoldingRecord == TRUE)
+				{
+					UartComms_TxFreeRecord(port, port->txLane);
+					port->txIsHoldingRecord = FALSE;
+				}
+				if(port->txDescriptor.data == port->txStaging)
+					port->txStagingLength = 0;
+				if(port->txDescriptor.callback != NULL)
+					port->txDescriptor.callback(port->txDescriptor.data, port->txDescriptor.callbackArg);
+
+				// Keep going if there is more, otherwise stay awake for as long as the next burst
+				// is predicted to take to arrive
+				if(UartComms_TxNextDescriptor(port, now, FALSE) == TRUE)
+				{
+					UartComms_TxSendDescriptor(port);
+					break;
+				}
+				port->txIdleStartTime = now;
+				port->txIdleTimeout = UartComms_TxPredictIdleTimeout(port);
+				UartComms_TxStartTimer(port, now, port->txIdleTimeout);
+				port->txState = ST_LINGERING;
+				break;
+			}
+			case ST_LINGERING:
+			{
+				if(UartComms_TxNextDescriptor(port, now, FALSE) == TRUE)
+				{
+					UartComms_TxStartBurst(port, now, TRUE);
+					break;
+				}
+
+				// Stay awake for an announced write, if it is due within the power budget
+				if(port->txIsWriteAnnounced == TRUE)
+				{
+					portTickType timeUntilWrite = UartComms_TxTimeUntilAnnouncedWrite(port, now);
+					if((timeUntilWrite != 0) && (timeUntilWrite <= MAX_IDLE_TIMEOUT)
+						&& (timeUntilWrite >= UartComms_TxTimeLeft(port, now)))
+						UartComms_TxStartTimer(port, now, timeUntilWrite + MIN_IDLE_TIMEOUT);
+				}
+
+				if(UartComms_TxTimeLeft(port, now) != 0)
+					return;
+
+				// About to sleep, don't leave anything staged
+				if(UartComms_TxNextDescriptor(port, now, TRUE) == TRUE)
+				{
+					UartComms_TxStartBurst(port, now, TRUE);
+					break;
+				}
+
+				// An announced write which is already overdue isn't worth waking up for again
+				if((port->txIsWriteAnnounced == TRUE) && (UartComms_TxTimeUntilAnnouncedWrite(port, now) == 0))
+					port->txIsWriteAnnounced = FALSE;
+
+				// Wait until UART has completely finished sending the message (both the
+				// hardware buffer and the byte sent flag are set). The interrupt fires straight
+				// away if it already has. Gives up after TX_COMPLETE_MAX_WAIT_MS, so a UART which
+				// never reports complete can't keep it awake.
+				port->txIsrBusy = TRUE;
+				UartComms_TxStartTimer(port, now, TX_COMPLETE_MAX_WAIT_MS/portTICK_RATE_MS);
+				port->txState = ST_WAITING_FOR_COMPLETE;
+				port->backend->setTxInterruptMode(port->backend->context, UART_COMMS_TX_STS_COMPLETE);
+				return;
+			}
+			case ST_WAITING_FOR_COMPLETE:
+			{
+				if(port->txIsrBusy == TRUE)
+				{
+					if(UartComms_TxTimeLeft(port, now) != 0)
+						return;
+
+					// Timed out
+					port->backend->setTxInterruptMode(port->backend->context, 0);
+					port->txIsrBusy = FALSE;
+				}
+
+				// Now it is safe to unlock the UART to allow for sleeping
+				UartComms_SleepUnlock(port);
+				// Go back to idle state
+				port->txState = ST_IDLE;
+				break;
+			}
+		}
+	}
+}
+
+//! @brief		Returns TRUE if the other end has said stop, by CTS or XOFF
+//! @note		Safe to call from the TX ISR
+//! @private
+static bool_t UartComms_TxIsPeerStopped(const UartComms_Port_t *port)
+{
+	switch(port->flowControl)
+	{
+		case UART_COMMS_FLOW_CONTROL_RTS_CTS:
+			return (port->backend->readCts(port->backend->context) == 0) ? TRUE : FALSE;
+		case UART_COMMS_FLOW_CONTROL_XON_XOFF:
+			return port->txIsPeerStopped;
+		default:
+			return FALSE;
+	}
+}
+
+//! @brief		Sends the XON/XOFF left by UartComms_SendFlowControlByte(), if the hardware FIFO
+//!				has room now
+//! @note		Only call from the TX task, while the TX ISR is idle
+//! @private
+static void UartComms_TxSendPendingFlowByte(UartComms_Port_t *port)
+{
+	taskENTER_CRITICAL();
+	if((port->txPendingFlowByte != 0)
+		&& ((port->backend->readTxStatus(port->backend->context) & UART_COMMS_TX_STS_FIFO_NOT_FULL) != 0))
+	{
+		port->backend->writeTxData(port->backend->context, port->txPendingFlowByte);
+		port->txPendingFlowByte = 0;
+	}
+	taskEXIT_CRITICAL();
+}
+
+//! @brief		Returns the number of ticks until the TX task has to try sending a pending
+//!				XON/XOFF again, portMAX_DELAY if there isn't one or the TX ISR will send it
+//! @private
+static portTickType UartComms_TxFlowControlTimeLeft(const UartComms_Port_t *port)
+{
+	if((port->txPendingFlowByte != 0) && (port->txIsrBusy == FALSE))
+		return TX_FLOW_CONTROL_POLL_PERIOD;
+	return portMAX_DELAY;
+}
+
+//! @brief		Sends XON or XOFF ahead of anything queued
+//! @details	Written straight into the hardware FIFO if it has room. Otherwise it is left for
+//!				the TX ISR, or the TX task if the ISR is idle, replacing any XON/XOFF still
+//!				waiting, since only the latest one matters.
+//! @returns	TRUE if the TX task has to be woken to send it
+//! @note		Call from the RX ISR, or from a critical section
+//! @private
+static bool_t UartComms_SendFlowControlByte(UartComms_Port_t *port, uint8 byte)
+{
+	if((port->txPendingFlowByte == 0)
+		&& ((port->backend->readTxStatus(port->backend->context) & UART_COMMS_TX_STS_FIFO_NOT_FULL) != 0))
+	{
+		port->backend->writeTxData(port->backend->context, byte);
+		return FALSE;
+	}
+
+	port->txPendingFlowByte = byte;
+	return (port->txIsrBusy == FALSE) ? TRUE : FALSE;
+}
+
+//! @brief		Tells the other end to stop sending (isThrottled = TRUE) or to carry on
+//! @returns	TRUE if the TX task has to be woken to send an XON/XOFF
+//! @note		Call from the RX ISR, or from a critical section
+//! @private
+static bool_t UartComms_RxSetThrottle(UartComms_Port_t *port, bool_t isThrottled)
+{
+	port->rxIsThrottled = isThrottled;
+	if(isThrottled == TRUE)
+	{
+		STATS(port->stats.numRxThrottles++);
+	}
+
+	if(port->flowControl == UART_COMMS_FLOW_CONTROL_RTS_CTS)
+	{
+		port->backend->setRts(port->backend->context, (isThrottled == TRUE) ? 0 : 1);
+		return FALSE;
+	}
+	return UartComms_SendFlowControlByte(port, (isThrottled == TRUE) ? FLOW_CONTROL_XOFF : FLOW_CONTROL_XON);
+}
+
+//! @brief		Tells the other end to carry on once the rx buffer has drained to the low watermark
+//! @note		Call from readers, after taking bytes out of the rx buffer
+//! @private
+static void UartComms_RxReleaseThrottle(UartComms_Port_t *port)
+{
+	bool_t isTxWakeDue = FALSE;
+
+	if((port->rxIsThrottled == FALSE)
+		|| (UartCommsRingBuffer_Count(&port->rxBuffer) > RX_FLOW_LOW_WATERMARK(port)))
+		return;
+
+	// The RX ISR throttles, so look again with it locked out
+	taskENTER_CRITICAL();
+	if(port->rxIsThrottled == TRUE)
+		isTxWakeDue = UartComms_RxSetThrottle(port, FALSE);
+	taskEXIT_CRITICAL();
+
+	if(isTxWakeDue == TRUE)
+		xSemaphoreGive(port->txTask->wakeSemaphore);
+}
+
+//! @brief		Finds the first delimiter in data
+//! @details	For up to #RX_SWAR_MAX_DELIMITERS delimiters, looks at a word at a time: XORing a
+//!				word with a delimiter repeated in every byte makes matching bytes zero, and
+//!				(x - 0x01010101) & ~x & 0x80808080 is non-zero if any byte of x is zero. Only the
+//!				word with a match is then looked at a byte at a time.
+//! @returns	Index of the first delimiter, or numBytes if there isn't one
+//! @private
+static uint32 UartComms_RxFindDelimiter(const uint8 *data, uint32 numBytes, const char *delimiters, uint32 numDelimiters, const uint32 *delimiterMap)
+{
+	uint32 i = 0;
+
+	if(numDelimiters <= RX_SWAR_MAX_DELIMITERS)
+	{
+		uint32 patterns[RX_SWAR_MAX_DELIMITERS];
+		uint32 j;
+
+		for(j = 0; j < numDelimiters; j++)
+			patterns[j] = (uint8)delimiters[j]*0x01010101u;
+
+		// Bytes before the first aligned word
+		for(; (i < numBytes) && (((size_t)&data[i] & 3) != 0); i++)
+		{
+			if(RX_IS_DELIMITER(delimiterMap, data[i]))
+				return i;
+		}
+
+		for(; i + 4 <= numBytes; i += 4)
+		{
+			uint32 word;
+			uint32 hasMatch = 0;
+
+			memcpy(&word, &data[i], sizeof(word));
+
+			for(j = 0; j < numDelimiters; j++)
+			{
+				uint32 x = word ^ patterns[j];
+				hasMatch |= (x - 0x01010101u) & ~x & 0x80808080u;
+			}
+			if(hasMatch != 0)
+				break;
+		}
+	}
+
+	// The word with the match, the bytes after the last whole word, or every byte if there are
+	// too many delimiters
+	for(; i < numBytes; i++)
+	{
+		if(RX_IS_DELIMITER(delimiterMap, data[i]))
+			return i;
+	}
+	return numBytes;
+}
+
+#if(configUART_COMMS_ENABLE_TRACE == 1)
+	//! @brief		Records bytes in the trace ring, counting them in the stats if it is full
+	//! @note		Only call from the RX ISR, or from a critical section
+	//! @private
+	static void UartComms_Trace(UartComms_Port_t *port, uint8 direction, portTickType now, const uint8 *data, uint32 numBytes)
+	{
+		if(UartCommsTrace_Write(&port->trace, direction, (uint32)now, data, numBytes) == 0)
+		{
+			STATS(port->stats.numTraceBytesDropped += numBytes);
+		}
+	}
+#endif
+
+#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+	//! @brief		Sends a baud rate negotiation message in the urgent lane
+	//! @details	Starts with a delimiter, so it is decoded even straight after raw bytes.
+	//! @returns	TRUE on success, FALSE if it was dropped
+	//! @private
+	static bool_t UartComms_BaudSend(UartComms_Port_t *port, uint8 type, const uint32 *words, uint8 numWords)
+	{
+		static const uint8 header[1] = { configUART_COMMS_BAUD_CHANNEL };
+		uint8 message[BAUD_MSG_MAX_SIZE];
+		uint8 i;
+
+		message[0] = type;
+		for(i = 0; i < numWords; i++)
+		{
+			message[1 + 4*i] = (uint8)words[i];
+			message[2 + 4*i] = (uint8)(words[i] >> 8);
+			message[3 + 4*i] = (uint8)(words[i] >> 16);
+			message[4 + 4*i] = (uint8)(words[i] >> 24);
+		}
+
+		return UartComms_TxPutFrame(port, UART_COMMS_TX_PRIORITY_URGENT, header, sizeof(header),
+			message, 1 + 4*(uint32)numWords, TRUE);
+	}
+
+
+	//! @brief		Waits for a baud rate negotiation message of one of the types in typeMask
+	//! @details	Messages of other types are thrown away. A message with more words than
+	//!				configUART_COMMS_BAUD_MAX_RATES is cut short.
+	//! @param		words		configUART_COMMS_BAUD_MAX_RATES words, for the message's words
+	//! @param		timeout		Max time (in ticks) to wait
+	//! @returns	Type of the message, or 0 on timeout
+	//! @private
+	static uint8 UartComms_BaudWaitFor(UartComms_Port_t *port, uint32 typeMask, uint32 *words, uint8 *numWords, portTickType timeout)
+	{
+		portTickType startTime = xTaskGetTickCount();
+		portTickType timeLeft = timeout;
+
+		for(;;)
+		{
+			uint8 message[BAUD_MSG_MAX_SIZE];
+			uint32 length;
+			uint8 i;
+
+			if(UartComms_ReadChannelFrame(port, configUART_COMMS_BAUD_CHANNEL, message, sizeof(message), &length, timeLeft) == FALSE)
+				return 0;
+
+			if((length != 0) && (message[0] < 32) && ((typeMask & BAUD_MSG_BIT(message[0])) != 0))
+			{
+				*numWords = (uint8)((length - 1)/4);
+				for(i = 0; i < *numWords; i++)
+				{
+					words[i] = (uint32)message[1 + 4*i] | ((uint32)message[2 + 4*i] << 8)
+						| ((uint32)message[3 + 4*i] << 16) | ((uint32)message[4 + 4*i] << 24);
+				}
+				return message[0];
+			}
+
+			if(timeout != portMAX_DELAY)
+			{
+				portTickType timeWaited = xTaskGetTickCount() - startTime;
+				timeLeft = (timeWaited >= timeout) ? 0 : timeout - timeWaited;
+			}
+		}
+	}
+
+
+	//! @brief		Returns TRUE if baudRate is the idle rate or one of the port's rates
+	//! @private
+	static bool_t UartComms_BaudIsSupported(const UartComms_Port_t *port, uint32 baudRate)
+	{
+		uint8 i;
+
+		if(baudRate == 0)
+			return FALSE;
+		if(baudRate == port->baudIdleRate)
+			return TRUE;
+		for(i = 0; i < port->numBaudRates; i++)
+		{
+			if(port->baudRates[i] == baudRate)
+				return TRUE;
+		}
+		return FALSE;
+	}
+
+
+	//! @brief		Returns TRUE if everything written has left the tx buffers and the hardware FIFO
+	//! @details	A write being sent stays in its lane until the TX ISR has put all of it into
+	//!				the hardware FIFO. ST_WAITING_FOR_COMPLETE gives up after TX_COMPLETE_MAX_WAIT_MS,
+	//!				which a full FIFO can take longer than at a slow rate, so the FIFO is checked
+	//!				too. Only once the TX state machine is idle, as reading the status clears
+	//!				UART_COMMS_TX_STS_COMPLETE, which it may be waiting for. The last byte can
+	//!				still be in the shift register.
+	//! @note		Call from within a critical section
+	//! @private
+	static bool_t UartComms_BaudIsTxDrained(const UartComms_Port_t *port)
+	{
+		uint8 lane;
+
+		for(lane = 0; lane < UART_COMMS_NUM_TX_PRIORITIES; lane++)
+		{
+			if(UartCommsRecordBuffer_Count(&port->txLanes[lane].buffer) != 0)
+				return FALSE;
+		}
+
+		return ((port->txStagingLength == 0) && (port->txIsrNumBytesLeft == 0) && (port->txPendingFlowByte == 0)
+			&& ((port->txState == ST_IDLE) || (port->txState == ST_AWAITING_ANNOUNCED_WRITE))
+			&& ((port->backend->readTxStatus(port->backend->context) & UART_COMMS_TX_STS_FIFO_EMPTY) != 0)) ? TRUE : FALSE;
+	}
+
+
+	//! @brief		Changes the baud rate once everything written has been sent
+	//! @details	Holds the TX task while the rate changes, and drops whatever is received until
+	//!				configUART_COMMS_BAUD_SETTLE_MS after it has.
+	//! @returns	TRUE if the rate was changed, FALSE if the TX didn't drain in time or the
+	//!				backend couldn't set the rate (the rate is then left as it was)
+	//! @note		Call with a sleep lock held
+	//! @private
+	static bool_t UartComms_BaudChange(UartComms_Port_t *port, uint32 baudRate)
+	{
+		portTickType startTime = xTaskGetTickCount();
+		bool_t isChanged;
+
+		// Anything staged is sent now rather than at its deadline
+		UartComms_Flush(port);
+		for(;;)
+		{
+			taskENTER_CRITICAL();
+			if(UartComms_BaudIsTxDrained(port) == TRUE)
+			{
+				port->txIsHeld = TRUE;
+				taskEXIT_CRITICAL();
+				break;
+			}
+			taskEXIT_CRITICAL();
+
+			if(xTaskGetTickCount() - startTime >= BAUD_DRAIN_TIMEOUT)
+				return FALSE;
+			vTaskDelay(1);
+		}
+
+		// Let the last byte out of the shift register
+		vTaskDelay(BAUD_BYTE_TIME(port->baudRate));
+
+		port->rxIsPaused = TRUE;
+		isChanged = (port->backend->setBaudRate(port->backend->context, baudRate) != 0) ? TRUE : FALSE;
+		if(isChanged == TRUE)
+		{
+			port->baudRate = baudRate;
+			vTaskDelay(BAUD_SETTLE_TIME);
+		}
+
+		// Drop any frame cut in half by the change. The other end drained before it changed
+		// rate, so the next byte it sends starts a frame, and doesn't need a delimiter first.
+		taskENTER_CRITICAL();
+		UartCommsFrameDecoder_Init(&port->rxFrameDecoder, &port->rxFrameBuffer[2], sizeof(port->rxFrameBuffer) - 2);
+		port->rxIsPaused = FALSE;
+		port->txIsHeld = FALSE;
+		taskEXIT_CRITICAL();
+
+		// Writes made while held can go now
+		xSemaphoreGive(port->txTask->wakeSemaphore);
+		return isChanged;
+	}
+
+
+	//! @brief		Sends probes at the new rate until one is answered, or
+	//!				configUART_COMMS_BAUD_PROBE_TIMEOUT_MS is up
+	//! @details	Each probe carries a nonce, so an answer to a probe sent at the old rate
+	//!				isn't taken for one.
+	//! @returns	TRUE if a probe was answered
+	//! @private
+	static bool_t UartComms_BaudProbe(UartComms_Port_t *port)
+	{
+		portTickType startTime = xTaskGetTickCount();
+		uint32 nonce = (uint32)startTime ^ port->baudRate;
+		uint32 words[configUART_COMMS_BAUD_MAX_RATES];
+		uint8 numWords;
+
+		for(;;)
+		{
+			portTickType probeTime = xTaskGetTickCount();
+			portTickType timeWaited = probeTime - startTime;
+
+			if(timeWaited >= BAUD_PROBE_TIMEOUT)
+				return FALSE;
+
+			UartComms_BaudSend(port, BAUD_MSG_PROBE, &nonce, 1);
+
+			// Wait for the answer until the next probe is due
+			for(;;)
+			{
+				portTickType timeSinceProbe = xTaskGetTickCount() - probeTime;
+
+				if(timeSinceProbe >= BAUD_PROBE_INTERVAL)
+					break;
+				if((UartComms_BaudWaitFor(port, BAUD_MSG_BIT(BAUD_MSG_PROBE_ACK), words, &numWords,
+					BAUD_PROBE_INTERVAL - timeSinceProbe) == BAUD_MSG_PROBE_ACK)
+					&& (numWords == 1) && (words[0] == nonce))
+				{
+					return TRUE;
+				}
+			}
+		}
+	}
+
+
+	//! @brief		Answers a request from the other end, and changes to the rate picked
+	//! @details	Picks the highest of the other end's rates which this end supports too, then
+	//!				waits for a probe at that rate. Goes back to the old rate if none comes.
+	//! @returns	TRUE if the rate changed
+	//! @private
+	static bool_t UartComms_BaudServeRequest(UartComms_Port_t *port, const uint32 *rates, uint8 numRates)
+	{
+		uint32 oldRate = port->baudRate;
+		uint32 newRate = 0;
+		uint32 words[configUART_COMMS_BAUD_MAX_RATES];
+		uint8 numWords;
+		bool_t isChanged = FALSE;
+		uint8 i;
+
+		for(i = 0; i < numRates; i++)
+		{
+			if((rates[i] > newRate) && (UartComms_BaudIsSupported(port, rates[i]) == TRUE))
+				newRate = rates[i];
+		}
+
+		if((newRate == 0) || (port->backend->setBaudRate == NULL))
+		{
+			UartComms_BaudSend(port, BAUD_MSG_REJECT, NULL, 0);
+			return FALSE;
+		}
+
+		if((UartComms_BaudSend(port, BAUD_MSG_ACCEPT, &newRate, 1) == FALSE) || (newRate == oldRate))
+			return FALSE;
+
+		// The accept is sent at the old rate, before the change. The initiator may take as long
+		// to drain as this end did before it starts probing.
+		UartComms_SleepLock(port);
+		if((UartComms_BaudChange(port, newRate) == TRUE)
+			&& (UartComms_BaudWaitFor(port, BAUD_MSG_BIT(BAUD_MSG_PROBE), words, &numWords,
+				BAUD_DRAIN_TIMEOUT + BAUD_PROBE_TIMEOUT) == BAUD_MSG_PROBE)
+			&& (numWords == 1))
+		{
+			UartComms_BaudSend(port, BAUD_MSG_PROBE_ACK, words, 1);
+			isChanged = TRUE;
+			STATS(taskENTER_CRITICAL(); port->stats.numBaudSwitches++; taskEXIT_CRITICAL());
+		}
+		else
+		{
+			if(port->baudRate != oldRate)
+				UartComms_BaudChange(port, oldRate);
+			STATS(taskENTER_CRITICAL(); port->stats.numBaudFallbacks++; taskEXIT_CRITICAL());
+		}
+		UartComms_SleepUnlock(port);
+
+		return isChanged;
+	}
+
+
+	//! @brief		Returns the number of ticks until the link has been quiet for the idle timeout
+	//! @returns	0 if it is time to drop to the idle rate, portMAX_DELAY if there is no idle
+	//!				timeout or the port is already at the idle rate
+	//! @private
+	static portTickType UartComms_BaudIdleTimeLeft(const UartComms_Port_t *port, portTickType now)
+	{
+		portTickType timeQuiet;
+		portTickType rxTimeQuiet;
+
+		if((port->baudIdleTimeout == 0) || (port->baudRate == port->baudIdleRate))
+			return portMAX_DELAY;
+
+		// Still sending, look again after the timeout
+		if(port->txState != ST_IDLE)
+			return port->baudIdleTimeout;
+
+		timeQuiet = now - port->txIdleStartTime;
+		rxTimeQuiet = now - port->rxLastByteTime;
+		if(rxTimeQuiet < timeQuiet)
+			timeQuiet = rxTimeQuiet;
+
+		if(timeQuiet >= port->baudIdleTimeout)
+			return 0;
+		return port->baudIdleTimeout - timeQuiet;
+	}
+#endif
+
+//======================================== TASK FUNCTIONS =======================================//
+
+//! @brief 		UART TX task
+//! @details	Services every port whose txTask is pvParameters. Sleeps until a producer or ISR
+//!				wakes it, or a port's timer expires.
+//! @param		*pvParameters 	The UartComms_TxTaskInfo_t of this task
+//! @note		Not thread-safe. Do not call from any task, this function is a task that
+//!				is called by the FreeRTOS kernel
+//! @private
+void UartComms_TxTask(void *pvParameters)
+{
+	UartComms_TxTaskInfo_t *txTask = (UartComms_TxTaskInfo_t*)pvParameters;
+	UartComms_Port_t *port;
+
+	#if(configPRINT_DEBUG_UART_COMMS == 1)
+		static char* msgUartCommsTxTaskStarted = "UART_COMMS: Comms Uart TX task started.\r\n";
+		UartDebug_PutString(msgUartCommsTxTaskStarted);	
+	#endif
+
+	for(port = _firstPort; port != NULL; port = port->nextPort)
+	{
+		if(port->txTask != txTask)
+			continue;
+
+		// Start USART RX interrupt, which will call UartComms_UartRxISR()
+		// This must be done in the task, since the interrupt calls xSemaphoreGiveFromISR() which 
+		// must not be called before the scheduler starts (freeRTOS restriction).
+		port->backend->startRxIsr(port->backend->context, &UartComms_UartRxIsr, port);
+
+		// Start USART TX interrupt, which will call UartComms_UartTxIsr(). It stays disabled
+		// until there is something to send.
+		port->backend->setTxInterruptMode(port->backend->context, 0);
+		port->backend->startTxIsr(port->backend->context, &UartComms_UartTxIsr, port);
+
+		// Allow UART to initially sleep if allowed to
+		UartComms_SleepUnlock(port);
+	}
+
+	// Infinite task loop
+	for(;;)
+	{
+		portTickType now = xTaskGetTickCount();
+		portTickType timeout = portMAX_DELAY;
+
+		for(port = _firstPort; port != NULL; port = port->nextPort)
+		{
+			portTickType timeLeft;
+
+			if(port->txTask != txTask)
+				continue;
+
+			UartComms_TxService(port, now);
+
+			timeLeft = UartComms_TxTimeLeft(port, now);
+			if(timeLeft < timeout)
+				timeout = timeLeft;
+			timeLeft = UartComms_TxCoalesceTimeLeft(port, now);
+			if(timeLeft < timeout)
+				timeout = timeLeft;
+			timeLeft = UartComms_TxFlowControlTimeLeft(port);
+			if(timeLeft < timeout)
+				timeout = timeLeft;
+		}
+
+		// Sleep until there is more to do
+		xSemaphoreTake(txTask->wakeSemaphore, timeout);
+	}
+}
+
+//===============================================================================================//
+//============================================ ISR's ============================================//
+//===============================================================================================//
+
+//! @brief 		ISR called when UART rx buffer has new character
+//! @param		arg		The UartComms_Port_t
+//! @private
+static void UartComms_UartRxIsr(void *arg)
+{
+	// Check to see if we just slept, if so, wake up peripherals
+	//! @todo Get rid of this
+	//if(PowerMgmt_AreWeSleeping() == TRUE)
+	//	PowerMgmt_WakeUp();
+	
+	UartComms_Port_t *port = (UartComms_Port_t*)arg;
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	// Bytes are collected here and copied into the rx buffer in bulk
+	uint8 batch[RX_ISR_BATCH_SIZE];
+	uint32 batchLength = 0;
+
+	// Used to decide whether the reader needs waking. The reader is woken when the buffer goes
+	// empty to non-empty, or the number of bytes in it crosses this watermark.
+	uint32 wakeWatermark = port->rxBufferSize/2;
+	uint32 numBytesBefore = UartCommsRingBuffer_Count(&port->rxBuffer);
+	uint32 numBytesAfter;
+	uint32 numBytesRead = 0;
+	uint32 channelsQueued = 0;
+	bool_t isWaitingForDelimiter = port->rxIsWaitingForDelimiter;
+	bool_t isDelimiterReceived = FALSE;
+	bool_t isTxWakeDue = FALSE;
+	#if(configUART_COMMS_ENABLE_TRACE == 1)
+		// Every byte read is traced, including ones discarded below
+		uint8 traceBatch[RX_ISR_BATCH_SIZE];
+		uint32 traceLength = 0;
+		bool_t isTracing = port->isTracing;
+		portTickType now = (isTracing == TRUE) ? xTaskGetTickCountFromISR() : 0;
+	#endif
+
+	// Get received byte (lower 8-bits) and error info from UART (higher 8-bits) (total 16-bits)
+	#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+		port->rxLastByteTime = xTaskGetTickCountFromISR();
+	#endif
+
+	do
+	{
+		uint16_t byte = port->backend->getByte(port->backend->context);
+		
+		// Mask error info
+		uint8_t status = (byte >> 8);
+
+		numBytesRead++;
+		STATS(UartComms_RxCountErrors(port, status));
+
+		#if(configUART_COMMS_ENABLE_TRACE == 1)
+			if(isTracing == TRUE)
+			{
+				traceBatch[traceLength++] = (uint8)byte;
+				if(traceLength == RX_ISR_BATCH_SIZE)
+				{
+					UartComms_Trace(port, UART_COMMS_TRACE_DIR_RX, now, traceBatch, traceLength);
+					traceLength = 0;
+				}
+			}
+		#endif
+
+		// Whatever arrives while the baud rate is changing is noise
+		#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+			if(port->rxIsPaused == TRUE)
+				continue;
+		#endif
+		
+		// Record errors for a task to report later, printing from here would block
+		if((status & RX_ERROR_FLAGS) != 0)
+			UartComms_RxIsrRecordError(port, status);
+
+		#if(configUART_COMMS_ENABLE_FRAMING == 1)
+			if(port->rxIsFraming == TRUE)
+			{
+				channelsQueued |= UartComms_RxIsrDecodeFrame(port, (uint8)byte, status);
+				continue;
+			}
+		#endif
+
+		// Corrupted bytes are discarded
+		if((status & RX_CORRUPT_FLAGS) == 0)
+		{
+			// XON/XOFF from the other end are acted on here, not passed on
+			if((port->flowControl == UART_COMMS_FLOW_CONTROL_XON_XOFF)
+				&& (((uint8)byte == FLOW_CONTROL_XON) || ((uint8)byte == FLOW_CONTROL_XOFF)))
+			{
+				port->txIsPeerStopped = ((uint8)byte == FLOW_CONTROL_XOFF) ? TRUE : FALSE;
+				if(port->txIsPeerStopped == FALSE)
+					isTxWakeDue = TRUE;
+				continue;
+			}
+
+			if((isWaitingForDelimiter == TRUE) && RX_IS_DELIMITER(port->rxDelimiterMap, (uint8)byte))
+				isDelimiterReceived = TRUE;
+
+			batch[batchLength++] = (uint8)byte;
+			if(batchLength == RX_ISR_BATCH_SIZE)
+			{
+				UartComms_RxIsrWriteBatch(port, batch, batchLength);
+				batchLength = 0;
+			}
+		}
+	}
+	while((port->backend->readRxStatus(port->backend->context) & UART_COMMS_RX_STS_FIFO_NOTEMPTY) != 0x00);
+
+	if(batchLength != 0)
+		UartComms_RxIsrWriteBatch(port, batch, batchLength);
+
+	#if(configUART_COMMS_ENABLE_TRACE == 1)
+		if(traceLength != 0)
+			UartComms_Trace(port, UART_COMMS_TRACE_DIR_RX, now, traceBatch, traceLength);
+	#endif
+
+	// Wake the reader at most once for the whole FIFO. A reader only ever blocks on an empty
+	// buffer, so there is no need to wake it unless the buffer was empty, or it has filled
+	// past the watermark. UartComms_ReadUntil() only needs waking for a delimiter.
+	numBytesAfter = UartCommsRingBuffer_Count(&port->rxBuffer);
+
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		port->stats.numRxIsrCalls++;
+		if(numBytesRead > port->stats.rxIsrMaxBytes)
+			port->stats.rxIsrMaxBytes = numBytesRead;
+		if(numBytesAfter > port->stats.rxBufferHighWaterMark)
+			port->stats.rxBufferHighWaterMark = numBytesAfter;
+	#endif
+
+	// Tell the other end to stop before the rx buffer overflows
+	if((port->flowControl != UART_COMMS_FLOW_CONTROL_NONE) && (port->rxIsThrottled == FALSE)
+		&& (numBytesAfter >= RX_FLOW_HIGH_WATERMARK(port)))
+	{
+		if(UartComms_RxSetThrottle(port, TRUE) == TRUE)
+			isTxWakeDue = TRUE;
+	}
+
+	// Let the TX task carry on after an XON, or send an XOFF which didn't fit in the FIFO
+	if(isTxWakeDue == TRUE)
+		xSemaphoreGiveFromISR(port->txTask->wakeSemaphore, &xHigherPriorityTaskWoken);
+
+	if(((isWaitingForDelimiter == FALSE) && (numBytesBefore == 0) && (numBytesAfter != 0))
+		|| (isDelimiterReceived == TRUE)
+		|| ((numBytesBefore < wakeWatermark) && (numBytesAfter >= wakeWatermark)))
+	{
+		xSemaphoreGiveFromISR(port->rxDataSemaphore, &xHigherPriorityTaskWoken);
+	}
+
+	// Wake each channel's reader once, however many frames it got
+	#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	{
+		uint8 channel;
+		for(channel = 0; channelsQueued != 0; channel++, channelsQueued >>= 1)
+		{
+			if((channelsQueued & 1) != 0)
+				xSemaphoreGiveFromISR(port->rxChannels[channel].semaphore, &xHigherPriorityTaskWoken);
+		}
+	}
+	#else
+		(void)channelsQueued;
+	#endif
+	
+	// Force a context swicth if interrupt unblocked a task with a higher or equal priority
+	// to the currently running task
+	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+}
+
+//! @brief		Copies a batch of received bytes into the rx buffer
+//! @details	Bytes which don't fit are dropped, and counted in the stats.
+//! @note		Only call from the RX ISR
+//! @private
+static void UartComms_RxIsrWriteBatch(UartComms_Port_t *port, const uint8 *batch, uint32 batchLength)
+{
+	uint32 numBytesWritten = UartCommsRingBuffer_Write(&port->rxBuffer, batch, batchLength);
+
+	STATS(port->stats.numRxBytes += numBytesWritten);
+	STATS(port->stats.numRxBytesDropped += batchLength - numBytesWritten);
+	(void)numBytesWritten;
+}
+
+//! @brief		Records a received byte's error flags in the error event ring
+//! @details	Constant time, an event which doesn't fit is dropped and counted in the stats.
+//! @note		Only call from the RX ISR
+//! @private
+static void UartComms_RxIsrRecordError(UartComms_Port_t *port, uint8 status)
+{
+	UartComms_RxErrorEvent_t event;
+
+	if(UartCommsRingBuffer_Space(&port->rxErrorEvents) < sizeof(event))
+	{
+		STATS(port->stats.numRxErrorEventsDropped++);
+		return;
+	}
+
+	event.time = xTaskGetTickCountFromISR();
+	event.status = status;
+	UartCommsRingBuffer_Write(&port->rxErrorEvents, (const uint8*)&event, sizeof(event));
+}
+
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	//! @brief		Feeds a received byte to the frame decoder, and queues the frame it completes
+	//!				on its channel
+	//! @details	A frame with a byte lost (overrun) or corrupted in it is dropped. Frames which
+	//!				don't fit in their frame queue, or have no channel, are dropped and counted
+	//!				in the stats.
+	//! @returns	Bit n set if a frame was queued on channel n
+	//! @note		Only call from the RX ISR
+	//! @private
+	static uint32 UartComms_RxIsrDecodeFrame(UartComms_Port_t *port, uint8 byte, uint8 status)
+	{
+		UartCommsFrame_Result_t result;
+		uint8 *frame = &port->rxFrameBuffer[2];
+		uint8 channel = 0;
+		UartCommsRingBuffer_t *frames;
+		uint16 length;
+
+		if((status & (RX_CORRUPT_FLAGS | UART_COMMS_RX_STS_OVERRUN)) != 0)
+		{
+			UartCommsFrameDecoder_Abort(&port->rxFrameDecoder);
+			STATS(port->stats.numRxFrameErrors++);
+			// An overrun only means bytes before this one were lost
+			if((status & RX_CORRUPT_FLAGS) != 0)
+				return 0;
+		}
+
+		result = UartCommsFrameDecoder_Feed(&port->rxFrameDecoder, byte);
+		if(result == UART_COMMS_FRAME_ERROR)
+		{
+			STATS(port->stats.numRxFrameErrors++);
+		}
+		if(result != UART_COMMS_FRAME_COMPLETE)
+			return 0;
+
+		length = (uint16)port->rxFrameDecoder.length;
+		if(port->rxIsUsingChannels == TRUE)
+		{
+			// Strip the channel ID, the length then goes where it and the byte before it were
+			if((length == 0) || (frame[0] >= configUART_COMMS_NUM_RX_CHANNELS))
+			{
+				STATS(port->stats.numRxFramesUnrouted++);
+				return 0;
+			}
+			channel = frame[0];
+			frame++;
+			length--;
+		}
+
+		frames = &port->rxChannels[channel].frames;
+		if(UartCommsRingBuffer_Space(frames) < sizeof(length) + length)
+		{
+			STATS(port->stats.numRxFramesDropped++);
+			return 0;
+		}
+
+		// The payload is already in place after the length
+		memcpy(frame - sizeof(length), &length, sizeof(length));
+		UartCommsRingBuffer_Write(frames, frame - sizeof(length), sizeof(length) + length);
+		STATS(port->stats.numRxFrames++);
+		return (uint32)1 << channel;
+	}
+#endif
+
+#if(configUART_COMMS_ENABLE_STATS == 1)
+	//! @brief		Counts every error flag set in the status of a received byte
+	//! @note		Only call from the RX ISR
+	//! @private
+	static void UartComms_RxCountErrors(UartComms_Port_t *port, uint8 status)
+	{
+		if(status & UART_COMMS_RX_STS_BREAK)
+			port->stats.numBreakErrors++;
+		if(status & UART_COMMS_RX_STS_PAR_ERROR)
+			port->stats.numParityErrors++;
+		if(status & UART_COMMS_RX_STS_STOP_ERROR)
+			port->stats.numStopErrors++;
+		if(status & UART_COMMS_RX_STS_OVERRUN)
+			port->stats.numOverrunErrors++;
+		if(status & UART_COMMS_RX_STS_SOFT_BUFF_OVER)
+			port->stats.numSoftBufferOverflows++;
+	}
+#endif
+
+//! @brief 		ISR called when the UART TX FIFO has room (while sending) or the last byte has
+//!				left the UART (while waiting for completion)
+//! @details	Refills the hardware FIFO in one burst, and only wakes the TX task once the data
+//!				it was given has run out, or the UART has finished.
+//! @param		arg		The UartComms_Port_t
+//! @private
+static void UartComms_UartTxIsr(void *arg)
+{
+	UartComms_Port_t *port = (UartComms_Port_t*)arg;
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+	uint8 status = port->backend->readTxStatus(port->backend->context);
+
+	STATS(port->stats.numTxIsrCalls++);
+
+	// XON/XOFF go ahead of everything else
+	if((port->txPendingFlowByte != 0) && ((status & UART_COMMS_TX_STS_FIFO_NOT_FULL) != 0))
+	{
+		port->backend->writeTxData(port->backend->context, port->txPendingFlowByte);
+		port->txPendingFlowByte = 0;
+		status = port->backend->readTxStatus(port->backend->context);
+	}
+
+	if((port->txIsrNumBytesLeft != 0) && (UartComms_TxIsPeerStopped(port) == TRUE))
+	{
+		// The other end has said stop. The TX task carries on once it says go.
+		STATS(port->stats.numTxFlowStops++);
+	}
+	else if(port->txIsrNumBytesLeft != 0)
+	{
+		const uint8 *data = port->txIsrData;
+		uint32 numBytesLeft = port->txIsrNumBytesLeft;
+
+		// Fill the FIFO
+		while((numBytesLeft != 0) && ((status & UART_COMMS_TX_STS_FIFO_NOT_FULL) != 0))
+		{
+			port->backend->writeTxData(port->backend->context, *data++);
+			numBytesLeft--;
+			status = port->backend->readTxStatus(port->backend->context);
+		}
+
+		#if(configUART_COMMS_ENABLE_STATS == 1)
+		{
+			uint32 numBytesWritten = port->txIsrNumBytesLeft - numBytesLeft;
+			port->stats.numTxBytes += numBytesWritten;
+			if(numBytesWritten > port->stats.txIsrMaxBytes)
+				port->stats.txIsrMaxBytes = numBytesWritten;
+		}
+		#endif
+
+		port->txIsrData = data;
+		port->txIsrNumBytesLeft = numBytesLeft;
+
+		// More to send, wait for the next interrupt
+		if(numBytesLeft != 0)
+			return;
+	}
+	else if((status & UART_COMMS_TX_STS_COMPLETE) == 0)
+	{
+		// Waiting for completion, but not complete yet
+		return;
+	}
+
+	// Either the data has run out, the other end has said stop, or the UART has finished. Hand
+	// back to the TX task.
+	port->backend->setTxInterruptMode(port->backend->context, 0);
+	port->txIsrBusy = FALSE;
+	xSemaphoreGiveFromISR(port->txTask->wakeSemaphore, &xHigherPriorityTaskWoken);
+
+	// Force a context swicth if interrupt unblocked a task with a higher or equal priority
+	// to the currently running task
+	portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+}
+
+//===============================================================================================//
+//========================================= GRAVEYARD ===========================================//
+//===============================================================================================//
+
+// none
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+// EOF
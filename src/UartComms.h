@@ -1,121 +1,1277 @@
-//!
-//! @file 		UartComms.h
-//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
-//! @date 		12/09/2012
-//! @brief 		Used for receiving/sending comms messages across the dedicated UART
-//! @details
-//!		<b>Last Modified:			</b> 07/11/2012					\n
-//!		<b>Version:					</b> v1.0.2						\n
-//!		<b>Company:					</b> CladLabs					\n
-//!		<b>Project:					</b> Free Code Modules			\n
-//!		<b>Language:				</b> C							\n
-//!		<b>Compiler:				</b> GCC						\n
-//! 	<b>uC Model:				</b> PSoC5						\n
-//!		<b>Computer Architecture:	</b> ARM						\n
-//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
-//!		<b>Documentation Format:	</b> Doxygen					\n
-//!		<b>License:					</b> GPLv3						\n
-//!	
-//!		Used for comms uart communication in an RTOS
-//!		environment. Uses queues to allow multiple
-//!		calls to the UART at once. Doesn't support calls from
-//!		an ISR. Designed for the PSoC architecture.
-//!
-//! 	CHANGELOG:
-//!			v1.0.1 -> Removed '_' prefix from header guard constant.
-//!				Added C++ header guard. Added warning not to call
-//!				Uart_PutString() from an ISR. Moved documentation into
-//!				.h file.
-//!			v1.0.2 -> Fixed comments (see .c to .h)
-//!		
-
-//===============================================================================================//
-//============================================ GUARDS ===========================================//
-//===============================================================================================//
-
-#ifndef UART_COMMS_H
-#define UART_COMMS_H
-
-#ifdef __cplusplus
-	extern "C" {
-#endif
-
-//===============================================================================================//
-//==================================== PUBLIC DEFINES ===========================================//
-//===============================================================================================//
-
-// none
-
-//===============================================================================================//
-//====================================== PUBLIC TYPEDEFS ========================================//
-//===============================================================================================//
-
-// none
-
-//===============================================================================================//
-//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
-//===============================================================================================//
-
-// See the function definitions in UartComms.c for more information
-
-//! @brief		Start-up function. Call from main() before starting scheduler
-//! @note		Not thread-safe. Do not call from any task!
-//! @sa			main()
-//! @public
-void 		UartComms_Start(uint32 txTaskStackSize, uint8 txTaskPriority);
-
-//! @brief		Puts null-terminated string onto tx queue
-//! @details	This is a blocking function which will not return until the entire string has been
-//!				put onto the queue. It will block if another task is currently putting stuff on the
-//!				queue (and hence the semaphore taken), or the tx queue is full (hence the UART is busy).
-//! @warning	Do not call from an ISR!
-//! @note		Thread-safe
-//! @public
-bool_t 		UartComms_PutString(const char* string);
-
-//! @brief		
-//! @details	Blocks until character is received
-//! @note		Not-thread safe.
-//! @public
-void 		UartComms_GetChar(char* singleChar);
-
-//! @brief		Used to prevent the DEBUG UART from sleeping
-//! @details	Can be called from any task, up to 255 times. The UART will be prevented from sleeping
-//! 			until a similar number of UartComms_SleepUnlock() calls have been made.
-//! @note		Thread-safe
-//! @sa			UartComms_SleepUnlock()
-//! @public
-void 		UartComms_SleepLock(void);
-
-//! @brief		Used to allow the DEBUG UART to sleep
-//! @details	Can be called from any task, up to 255 times. This function needs to be called
-//!				as many times as UartComms_SleepLock was called before the UART will be allowed
-//!				to sleep.
-//! @note		Thread-safe
-//! @sa			UartComms_SleepLock()
-//! @public
-void 		UartComms_SleepUnlock(void);
-
-//! @brief 		Returns sleep state of the UART
-//! @public
-bool_t 		UartComms_IsAsleep(void);
-
-//! @brief		Returns the handle for the TX task
-//! @returns	Handle of the TX task
-//! @note		Thread-safe
-//! @public
-xTaskHandle UartComms_ReturnTxTaskHandle(void);
-
-//===============================================================================================//
-//=================================== PUBLIC VARIABLES/STRUCTURES ===============================//
-//===============================================================================================//
-
-// none
-
-#ifdef __cplusplus
-	} // extern "C" {
-#endif
-
-#endif // #ifndef UART_COMMS_H
-
-// EOF
+//!
+//! @file 		UartComms.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		12/09/2012
+//! @brief 		Used for receiving/sending comms messages across the dedicated UART
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v2.15.1					\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!	
+//!		Used for comms uart communication in an RTOS
+//!		environment. Uses a multi-producer record buffer to allow multiple
+//!		calls to the UART at once, without any task waiting on another. Doesn't
+//!		support calls from an ISR. Designed for the PSoC architecture.
+//!
+//!		Every write reserves space in the tx buffer, copies the data in and commits it.
+//!		The TX task sends committed writes in the order they were reserved. A write is
+//!		never interleaved with another. A write longer than UartComms_GetMaxWriteLength()
+//!		(a little under half the tx buffer) is split into a chain of records, which holds
+//!		the lane until all of it is sent (see UartComms_PutString()). Large static
+//!		payloads are cheaper to send with UartComms_PutBufferZeroCopy(). When the tx
+//!		buffer is full, a write either blocks until there is room
+//!		(UART_COMMS_TX_OVERFLOW_BLOCK) or is dropped straight away
+//!		(UART_COMMS_TX_OVERFLOW_DROP), see UartComms_SetTxOverflowPolicy(). With the drop
+//!		policy, writing never blocks, so it is safe from time-critical tasks.
+//!
+//!		In coalescing mode (see UartComms_SetCoalescing()) the TX task copies small writes
+//!		into a staging buffer and sends them together, once configUART_COMMS_COALESCE_THRESHOLD
+//!		bytes are staged, a newline is staged, configUART_COMMS_COALESCE_DEADLINE_MS has passed
+//!		since the first byte was staged, or UartComms_Flush() is called.
+//!
+//!		Every port has two TX lanes, each with its own tx buffer. Writes go to the bulk lane
+//!		unless made with UartComms_PutStringPriority() or UartComms_WritePriority(). The TX
+//!		task always sends whatever is in the urgent lane first, and only switches lanes
+//!		between writes, so an urgent message only ever waits for the write already being sent.
+//!		Only the bulk lane is coalesced.
+//!
+//!		Binary protocols can use the frame layer instead of raw bytes. UartComms_PutFrame()
+//!		adds a CRC, COBS encodes the frame and queues it as one write. Once
+//!		UartComms_SetRxFraming() is on, the RX ISR decodes received bytes as they arrive,
+//!		resynchronises on delimiters, drops frames which fail the CRC, and queues good ones
+//!		for UartComms_ReadFrame(), which wakes once per frame rather than once per byte.
+//!
+//!		Several tasks can share the RX stream through frame channels. The first byte of a
+//!		channel frame is its channel ID (0 to configUART_COMMS_NUM_RX_CHANNELS - 1). With
+//!		UartComms_SetRxChannels() on, the RX ISR queues each frame on its own channel's
+//!		queue, so each task blocks only on its channel with UartComms_ReadChannelFrame()
+//!		and no dispatcher task is needed. Channel 0 is the queue UartComms_ReadFrame() reads.
+//!
+//!		High volume text can be compressed on the way out (see UartComms_SetCompression()).
+//!		The TX task then stages bulk writes into blocks of up to
+//!		configUART_COMMS_COMPRESS_BLOCK_SIZE bytes, compresses each block on its own (LZSS,
+//!		see UartCommsLzss.h) and sends it as a frame on channel configUART_COMMS_COMPRESS_CHANNEL,
+//!		with a delimiter in front so a receiver can resynchronise. A block which doesn't
+//!		compress is sent as it is. Urgent writes are never compressed. tools/UartCommsLzssTool.c
+//!		decodes the stream on a host.
+//!
+//!		With configUART_COMMS_ENABLE_TRACE set to 1, a port can record what crosses the wire
+//!		(see UartComms_SetTracing()). The RX ISR records every byte it reads from the FIFO and
+//!		the TX task every write it hands to the TX ISR, each with its direction and tick
+//!		count, in a compact trace ring (UartCommsTrace.h). The trace is read out with
+//!		UartComms_ReadTrace(), or on a host saved with UartComms_DumpTrace(), and can be played
+//!		back into the RX path of the POSIX backend (UartCommsBackendPosix_StartReplay()) or
+//!		printed and replayed with tools/UartCommsTraceTool.c.
+//!
+//!		With configUART_COMMS_ENABLE_LOG set to 1, tasks can log with UartComms_Log() instead
+//!		of formatting text themselves. Only the format ID (from a table of format strings,
+//!		see UartCommsLog.h), the tick count and the raw arguments are sent, as a frame on
+//!		channel configUART_COMMS_LOG_CHANNEL with a delimiter in front, so log records and
+//!		plain text can share the bulk lane. tools/UartCommsLogTool.c formats the records on
+//!		a host, from the same table.
+//!
+//!		With configUART_COMMS_ENABLE_BAUD_NEGOTIATION set to 1, the two ends of a link can
+//!		agree on a faster baud rate at run time (see UartComms_NegotiateBaudRate()). Both start
+//!		at a slow rate they are sure of. The initiator sends the rates it supports as a frame
+//!		on channel configUART_COMMS_BAUD_CHANNEL, and the other end (in
+//!		UartComms_ServeBaudRate()) picks the highest one it supports too. Both then finish
+//!		sending, ignore what they receive while the backend changes the rate, and the
+//!		initiator sends probe frames at the new rate until one is answered. If none is, both
+//!		go back to the old rate. Once the link has been quiet for a while both can drop back
+//!		to a slow, low power rate (see UartComms_SetBaudIdleTimeout()).
+//!
+//!		Flow control (see UartComms_SetFlowControl()) is either RTS/CTS, if the backend has
+//!		the lines, or XON/XOFF. The RX ISR tells the other end to stop once the rx buffer
+//!		reaches its high watermark, and the reader tells it to go again once the buffer has
+//!		drained to its low watermark. While the other end has said stop, the TX ISR stops
+//!		refilling the hardware FIFO and the TX task waits until it may carry on.
+//!
+//!		Every UART is a port (UartComms_Port_t), defined at file scope with
+//!		UART_COMMS_PORT_DEFINE(), which also sizes its buffers at compile time. Every
+//!		function takes the port as its first argument.
+//!
+//!		All hardware access goes through a UartComms_Backend_t (see UartCommsBackend.h).
+//!		The PSoC backend is used by default. On a host, initialise the emulated UART in
+//!		UartCommsBackendPosix.h and pass it to UartComms_SetBackend() before calling
+//!		UartComms_Start(), the rest of the API works unchanged.
+//!
+//!		By default every port gets its own TX task. Set configUART_COMMS_SHARED_TX_TASK
+//!		to 1 to service all ports from one TX task (and one stack).
+//!
+//!		With configUART_COMMS_STATIC_ALLOCATION set to 1, nothing comes from the FreeRTOS
+//!		heap. Semaphores and the TX task (with its stack) are created in storage inside the
+//!		port, so UartComms_Start() cannot fail. Buffer sizes are checked at compile time, and
+//!		a port which would use more than configUART_COMMS_PORT_RAM_BUDGET bytes (see
+//!		UART_COMMS_PORT_FOOTPRINT()) fails to compile.
+//!
+//!		Usage:
+//!			UART_COMMS_PORT_DEFINE(uartCommsPort, 256, 128)
+//!			...
+//!			UartComms_SetBackend(&uartCommsPort, &UartCommsBackendPsoc_UartCpComms);
+//!			UartComms_Start(&uartCommsPort, 200, tskIDLE_PRIORITY + 2);
+//!			...
+//!			UartComms_PutString(&uartCommsPort, "Hello\r\n");
+//!
+//! 	CHANGELOG:
+//!			v1.0.1 -> Removed '_' prefix from header guard constant.
+//!				Added C++ header guard. Added warning not to call
+//!				Uart_PutString() from an ISR. Moved documentation into
+//!				.h file.
+//!			v1.0.2 -> Fixed comments (see .c to .h)
+//!			v1.1.0 -> Hardware access moved behind UartComms_Backend_t. Added
+//!				UartComms_SetBackend() and a POSIX/Linux host backend. Fixed
+//!				UartComms_Start() referring to non-existent vUartComms_TxTask().
+//!			v1.2.0 -> TX queue of single bytes replaced with a ring buffer which is
+//!				written in bulk and drained in chunks. Added UartComms_Write().
+//!				configUART_COMMS_TX_QUEUE_LENGTH is now the ring buffer size in bytes
+//!				(rounded up to a power of two).
+//!			v1.3.0 -> Writes are now queued as descriptors. Added
+//!				UartComms_PutBufferZeroCopy() which sends straight from the caller's
+//!				memory and calls back when done.
+//!			v1.4.0 -> RX queue of single bytes replaced with a ring buffer which the
+//!				RX ISR fills once per interrupt. Added UartComms_Read() and
+//!				UartComms_ReadNonBlocking().
+//!			v1.5.0 -> Ring buffers are lock-free (acquire/release indices in separate
+//!				cache lines). RX ISR only wakes the reader on an empty to non-empty
+//!				transition or when the buffer crosses a watermark.
+//!			v1.6.0 -> TX is interrupt driven. The TX ISR refills the hardware FIFO and
+//!				the TX task blocks instead of busy-waiting for the FIFO or for
+//!				the last byte to be sent.
+//!			v2.0.0 -> (breaking) All state moved into a UartComms_Port_t, passed to
+//!				every function, so one driver can run several UARTs. Buffers are
+//!				sized per port with UART_COMMS_PORT_DEFINE().
+//!				configUART_COMMS_TX_QUEUE_LENGTH and configUART_COMMS_RX_QUEUE_LENGTH
+//!				are no longer used. Added configUART_COMMS_SHARED_TX_TASK.
+//!			v2.1.0 -> Tx mutex and descriptor queue replaced with a lock-free
+//!				multi-producer record buffer. Added UartComms_SetTxOverflowPolicy(),
+//!				UartComms_GetNumDroppedTx() and configUART_COMMS_TX_OVERFLOW_POLICY.
+//!				configUART_COMMS_TX_DESCRIPTOR_QUEUE_LENGTH is no longer used.
+//!			v2.2.0 -> Added runtime statistics (UartComms_GetStats()), which can be
+//!				compiled out with configUART_COMMS_ENABLE_STATS. Bytes dropped by the
+//!				RX ISR are now counted instead of silently ignored.
+//!			v2.3.0 -> RX ISR no longer prints errors. It records them in an error event
+//!				ring instead, read with UartComms_GetRxErrorEvent() or printed with
+//!				UartComms_ReportRxErrors(). Fixed errors only being detected when every
+//!				error flag was set at once. Only bytes with a break, parity or stop
+//!				error are discarded.
+//!			v2.4.0 -> Fixed 5ms idle timeout before sleeping replaced with one predicted
+//!				from the gaps between bursts (configUART_COMMS_MIN_IDLE_TIMEOUT_MS to
+//!				configUART_COMMS_MAX_IDLE_TIMEOUT_MS). Added UartComms_AnnounceWrite(),
+//!				UartComms_GetIdleTimeout() and wake-up latency stats.
+//!			v2.5.0 -> Added an opt-in coalescing mode (UartComms_SetCoalescing()),
+//!				which combines small writes before sending them, and UartComms_Flush().
+//!			v2.6.0 -> Added an urgent TX lane (UartComms_PutStringPriority(),
+//!				UartComms_WritePriority()) which the TX task drains before the bulk lane,
+//!				and per-lane stats including the time from commit to send.
+//!			v2.7.0 -> Added a frame layer (COBS with a CRC-16, see UartCommsFrame.h).
+//!				UartComms_PutFrame() sends a frame, UartComms_SetRxFraming() makes the RX
+//!				ISR decode frames, which are read with UartComms_ReadFrame().
+//!			v2.8.0 -> Added frame channels. UartComms_PutChannelFrame() tags a frame with
+//!				a channel ID, and with UartComms_SetRxChannels() on the RX ISR routes
+//!				frames straight into per-channel queues, read with
+//!				UartComms_ReadChannelFrame().
+//!			v2.9.0 -> Added UartComms_ReadUntil() and UartComms_ReadLine(), which scan the
+//!				rx buffer a word at a time and are only woken by the RX ISR when a
+//!				delimiter arrives (or the rx buffer crosses its watermark).
+//!			v2.10.0 -> Added RTS/CTS and XON/XOFF flow control (UartComms_SetFlowControl()),
+//!				driven by rx buffer watermarks.
+//!			v2.11.0 -> Added configUART_COMMS_STATIC_ALLOCATION, compile-time buffer size and
+//!				RAM budget checks, and UART_COMMS_PORT_FOOTPRINT(). UartComms_Start() returns
+//!				FALSE if it couldn't create its semaphores or task.
+//!			v2.12.0 -> Added an optional compression stage for the bulk lane
+//!				(configUART_COMMS_ENABLE_COMPRESSION, UartComms_SetCompression()).
+//!			v2.13.0 -> Added an optional wire trace (configUART_COMMS_ENABLE_TRACE,
+//!				UartComms_SetTracing(), UartComms_ReadTrace(), UartComms_DumpTrace()).
+//!			v2.13.1 -> Fixed a writer waiting for room in a full tx buffer spinning
+//!				instead of blocking, which starved a lower priority TX task.
+//!			v2.14.0 -> Added binary logging with deferred formatting (configUART_COMMS_ENABLE_LOG,
+//!				UartComms_Log()).
+//!			v2.15.0 -> Added baud rate negotiation with probe-verified switching and fallback
+//!				(configUART_COMMS_ENABLE_BAUD_NEGOTIATION, UartComms_NegotiateBaudRate()).
+//!			v2.15.1 -> A write longer than UartComms_GetMaxWriteLength() is sent as a chain of
+//!				records, which holds the lane until the last one is sent, instead of as
+//!				separate writes, which could be interleaved with other writes. Such writes
+//!				are dropped with UART_COMMS_TX_OVERFLOW_DROP. Added
+//!				UartComms_GetMaxWriteLength() and configUART_COMMS_TX_MIN_LINE_LENGTH.
+//!				UartComms_ReadChannelFrame() returns FALSE for a channel out of range.
+//!				Fixed a staging buffer bigger than a compression block overflowing the
+//!				compressed block buffers, when compression is turned on while coalescing.
+//!				The buffer sizes given to UART_COMMS_PORT_DEFINE(),
+//!				configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE and
+//!				configUART_COMMS_RX_FRAME_QUEUE_SIZE must be powers of two (they were
+//!				rounded up, so the power of two checks could never fail).
+//!				UartComms_ReadLine() returns FALSE if maxLength is less than 2, instead of
+//!				returning an empty line without reading.
+//!				The compression, trace, log and baud rate negotiation counters in
+//!				UartComms_Stats_t are only there when their feature is turned on.
+//!		
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_H
+#define UART_COMMS_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+// User includes
+#include "PublicDefinesAndTypeDefs.h"
+#include "Config.h"
+#include "UartCommsRingBuffer.h"
+#include "UartCommsRecordBuffer.h"
+#include "UartCommsFrame.h"
+#include "UartCommsLzss.h"
+#include "UartCommsTrace.h"
+#include "UartCommsLog.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+#ifndef configUART_COMMS_TX_OVERFLOW_POLICY
+	//! Overflow policy ports start with, see UartComms_SetTxOverflowPolicy()
+	#define configUART_COMMS_TX_OVERFLOW_POLICY	(UART_COMMS_TX_OVERFLOW_BLOCK)
+#endif
+
+#ifndef configUART_COMMS_ENABLE_STATS
+	//! Set to 1 to keep runtime statistics (see UartComms_GetStats()), 0 to compile them out
+	#define configUART_COMMS_ENABLE_STATS		(1)
+#endif
+
+#ifndef configUART_COMMS_RX_ERROR_EVENT_QUEUE_LENGTH
+	//! Number of RX error events kept per port, rounded up so the ring is a power of two bytes
+	#define configUART_COMMS_RX_ERROR_EVENT_QUEUE_LENGTH	(8)
+#endif
+
+#ifndef configUART_COMMS_COALESCE_BUFFER_SIZE
+	//! Size of each port's staging buffer for coalescing mode, in bytes
+	#define configUART_COMMS_COALESCE_BUFFER_SIZE	(64)
+#endif
+
+#ifndef configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE
+	//! Size of each port's urgent lane tx buffer in bytes, a power of two (min 16)
+	#define configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE	(128)
+#endif
+
+#ifndef configUART_COMMS_TX_MIN_LINE_LENGTH
+	//! Longest write (in bytes) both TX lanes must send as one record, checked at compile time
+	//! against their tx buffer sizes. Longer writes are sent as a chain of records, which holds
+	//! the lane, so make it at least as long as a typical line.
+	#define configUART_COMMS_TX_MIN_LINE_LENGTH	(48)
+#endif
+
+#ifndef configUART_COMMS_ENABLE_FRAMING
+	//! Set to 1 to include the frame layer (see UartComms_PutFrame()), 0 to compile it out
+	#define configUART_COMMS_ENABLE_FRAMING		(1)
+#endif
+
+#ifndef configUART_COMMS_RX_FRAME_MAX_SIZE
+	//! Largest payload of a received frame, in bytes. Longer frames are dropped.
+	#define configUART_COMMS_RX_FRAME_MAX_SIZE	(64)
+#endif
+
+#ifndef configUART_COMMS_RX_FRAME_QUEUE_SIZE
+	//! Size of each channel's queue of received frames in bytes (each frame takes 2 bytes more
+	//! than its payload), a power of two
+	#define configUART_COMMS_RX_FRAME_QUEUE_SIZE	(256)
+#endif
+
+#ifndef configUART_COMMS_NUM_RX_CHANNELS
+	//! Number of frame channels (and frame queues) per port, 1 to 32
+	#define configUART_COMMS_NUM_RX_CHANNELS	(4)
+#endif
+
+#ifndef configUART_COMMS_SHARED_TX_TASK
+	//! Set to 1 to service all ports from a single TX task, 0 to give every port its own
+	#define configUART_COMMS_SHARED_TX_TASK		(0)
+#endif
+
+#ifndef configUART_COMMS_ENABLE_COMPRESSION
+	//! Set to 1 to include the compression stage (see UartComms_SetCompression()), 0 to compile it out
+	#define configUART_COMMS_ENABLE_COMPRESSION	(0)
+#endif
+
+#ifndef configUART_COMMS_COMPRESS_BLOCK_SIZE
+	//! Bulk bytes compressed together, up to UART_COMMS_LZSS_MAX_BLOCK_SIZE. Bigger blocks
+	//! compress better but take more RAM, and longer to fill.
+	#define configUART_COMMS_COMPRESS_BLOCK_SIZE	(256)
+#endif
+
+#ifndef configUART_COMMS_COMPRESS_CHANNEL
+	//! Channel ID (first byte of the payload) of compressed block frames
+	#define configUART_COMMS_COMPRESS_CHANNEL	(0xFF)
+#endif
+
+#ifndef configUART_COMMS_ENABLE_TRACE
+	//! Set to 1 to include the wire trace (see UartComms_SetTracing()), 0 to compile it out
+	#define configUART_COMMS_ENABLE_TRACE		(0)
+#endif
+
+#ifndef configUART_COMMS_TRACE_BUFFER_SIZE
+	//! Size of each port's trace ring in bytes, rounded up to a power of two. Every record
+	//! takes 3 bytes plus its data.
+	#define configUART_COMMS_TRACE_BUFFER_SIZE	(1024)
+#endif
+
+#ifndef configUART_COMMS_ENABLE_LOG
+	//! Set to 1 to include binary logging (see UartComms_Log()), 0 to compile it out
+	#define configUART_COMMS_ENABLE_LOG			(0)
+#endif
+
+#ifndef configUART_COMMS_LOG_CHANNEL
+	//! Channel ID (first byte of the payload) of log record frames
+	#define configUART_COMMS_LOG_CHANNEL		(0xFE)
+#endif
+
+#if((configUART_COMMS_ENABLE_LOG == 1) && (configUART_COMMS_ENABLE_FRAMING != 1))
+	#error "configUART_COMMS_ENABLE_LOG needs configUART_COMMS_ENABLE_FRAMING set to 1"
+#endif
+
+#if((configUART_COMMS_ENABLE_LOG == 1) && (configUART_COMMS_ENABLE_COMPRESSION == 1) \
+	&& (configUART_COMMS_LOG_CHANNEL == configUART_COMMS_COMPRESS_CHANNEL))
+	#error "configUART_COMMS_LOG_CHANNEL and configUART_COMMS_COMPRESS_CHANNEL must be different"
+#endif
+
+#ifndef configUART_COMMS_ENABLE_BAUD_NEGOTIATION
+	//! Set to 1 to include baud rate negotiation (see UartComms_NegotiateBaudRate()), 0 to compile it out
+	#define configUART_COMMS_ENABLE_BAUD_NEGOTIATION	(0)
+#endif
+
+#ifndef configUART_COMMS_BAUD_CHANNEL
+	//! Channel ID of baud rate negotiation frames, less than configUART_COMMS_NUM_RX_CHANNELS.
+	//! No other frames may be sent on it.
+	#define configUART_COMMS_BAUD_CHANNEL		(configUART_COMMS_NUM_RX_CHANNELS - 1)
+#endif
+
+#ifndef configUART_COMMS_BAUD_MAX_RATES
+	//! Most baud rates a port can be given with UartComms_SetBaudRates()
+	#define configUART_COMMS_BAUD_MAX_RATES		(8)
+#endif
+
+#if((configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1) && (configUART_COMMS_ENABLE_FRAMING != 1))
+	#error "configUART_COMMS_ENABLE_BAUD_NEGOTIATION needs configUART_COMMS_ENABLE_FRAMING set to 1"
+#endif
+
+//! Size of the staging buffer, which also holds the block being collected for compression
+#if((configUART_COMMS_ENABLE_COMPRESSION == 1) && (configUART_COMMS_COMPRESS_BLOCK_SIZE > configUART_COMMS_COALESCE_BUFFER_SIZE))
+	#define UART_COMMS_TX_STAGING_SIZE			(configUART_COMMS_COMPRESS_BLOCK_SIZE)
+#else
+	#define UART_COMMS_TX_STAGING_SIZE			(configUART_COMMS_COALESCE_BUFFER_SIZE)
+#endif
+
+#ifndef configUART_COMMS_STATIC_ALLOCATION
+	//! Set to 1 to create semaphores and the TX task in storage inside the port (needs FreeRTOS
+	//! v9 or later with configSUPPORT_STATIC_ALLOCATION), 0 to use the FreeRTOS heap
+	#define configUART_COMMS_STATIC_ALLOCATION	(0)
+#endif
+
+#ifndef configUART_COMMS_TX_TASK_STACK_SIZE
+	//! Stack size (in words) of the TX task with static allocation, which ignores the
+	//! txTaskStackSize given to UartComms_Start()
+	#define configUART_COMMS_TX_TASK_STACK_SIZE	(200)
+#endif
+
+#ifndef configUART_COMMS_PORT_RAM_BUDGET
+	//! Most RAM (in bytes) a port may use (see UART_COMMS_PORT_FOOTPRINT()), 0 for no limit
+	#define configUART_COMMS_PORT_RAM_BUDGET	(0)
+#endif
+
+#if((configUART_COMMS_STATIC_ALLOCATION == 1) && (configSUPPORT_STATIC_ALLOCATION != 1))
+	#error "configUART_COMMS_STATIC_ALLOCATION needs configSUPPORT_STATIC_ALLOCATION set to 1"
+#endif
+
+//! @brief		Fails to compile (with name in the error) if condition is false
+#define UART_COMMS_STATIC_ASSERT(condition, name) \
+	typedef char name[(condition) ? 1 : -1];
+
+//! TRUE if x is a (non-zero) power of two
+#define UART_COMMS_IS_POWER_OF_TWO(x)			(((x) != 0) && (((x) & ((x) - 1)) == 0))
+
+//! Bytes at the start of every tx record holding its commit time, used for the lane latency stats
+#if(configUART_COMMS_ENABLE_STATS == 1)
+	#define UART_COMMS_TX_RECORD_TIME_SIZE		(sizeof(portTickType))
+#else
+	#define UART_COMMS_TX_RECORD_TIME_SIZE		(0)
+#endif
+
+//! @brief		Longest write a TX lane with a tx buffer of bufferSize bytes sends as one record
+//! @details	Same as UartComms_GetMaxWriteLength(), for compile-time checks.
+#define UART_COMMS_TX_MAX_RECORD_LENGTH(bufferSize) \
+	(UART_COMMS_RECORD_BUFFER_MAX_RECORD_LENGTH(bufferSize) - UART_COMMS_TX_RECORD_TIME_SIZE)
+
+//! @brief		RAM (in bytes) used by a port defined with UART_COMMS_PORT_DEFINE(), including
+//!				its buffers
+//! @details	With configUART_COMMS_STATIC_ALLOCATION this includes its semaphores and its
+//!				TX task (unless the TX task is shared), otherwise those come from the FreeRTOS heap.
+#define UART_COMMS_PORT_FOOTPRINT(txBufferMinSize, rxBufferMinSize) \
+	(sizeof(UartComms_Port_t) \
+	+ UART_COMMS_RECORD_BUFFER_NUM_WORDS(configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE)*4 \
+	+ UART_COMMS_RECORD_BUFFER_NUM_WORDS(txBufferMinSize)*4 \
+	+ UART_COMMS_RING_BUFFER_SIZE(rxBufferMinSize))
+
+//! @brief		Declares a port defined with UART_COMMS_PORT_DEFINE() in another file
+#define UART_COMMS_PORT_DECLARE(portName) \
+	extern UartComms_Port_t portName;
+
+//! @brief		Defines a port, and its tx and rx buffers
+//! @details	The urgent lane's tx buffer is sized with configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE.
+//! @param		portName		Name of the UartComms_Port_t variable
+//! @param		txBufferMinSize	Size of the bulk lane's tx buffer in bytes, a power of two (min 16, and
+//!								big enough for configUART_COMMS_TX_MIN_LINE_LENGTH)
+//! @param		rxBufferMinSize	Size of the rx buffer in bytes, a power of two
+//! @note		Use once per UART, at file scope, in a .c file. Fails to compile if a buffer size
+//!				isn't a power of two or is out of range, the tx buffer can't hold a
+//!				configUART_COMMS_TX_MIN_LINE_LENGTH write as one record, or the port is over
+//!				configUART_COMMS_PORT_RAM_BUDGET.
+#define UART_COMMS_PORT_DEFINE(portName, txBufferMinSize, rxBufferMinSize) \
+	UART_COMMS_STATIC_ASSERT(UART_COMMS_IS_POWER_OF_TWO(txBufferMinSize) && ((txBufferMinSize) >= 16), \
+		portName##_txBufferSizeIsNotAPowerOfTwoOrIsOutOfRange) \
+	UART_COMMS_STATIC_ASSERT(UART_COMMS_TX_MAX_RECORD_LENGTH(txBufferMinSize) >= configUART_COMMS_TX_MIN_LINE_LENGTH, \
+		portName##_txBufferIsTooSmallForMinLineLength) \
+	UART_COMMS_STATIC_ASSERT(UART_COMMS_IS_POWER_OF_TWO(rxBufferMinSize), \
+		portName##_rxBufferSizeIsNotAPowerOfTwo) \
+	UART_COMMS_STATIC_ASSERT((configUART_COMMS_PORT_RAM_BUDGET == 0) \
+		|| (UART_COMMS_PORT_FOOTPRINT(txBufferMinSize, rxBufferMinSize) <= configUART_COMMS_PORT_RAM_BUDGET), \
+		portName##_isOverRamBudget) \
+	static uint32 portName##_txUrgentStorage[UART_COMMS_RECORD_BUFFER_NUM_WORDS(configUART_COMMS_TX_URGENT_BUFFER_MIN_SIZE)]; \
+	static uint32 portName##_txBulkStorage[UART_COMMS_RECORD_BUFFER_NUM_WORDS(txBufferMinSize)]; \
+	static uint8 portName##_rxBufferStorage[UART_COMMS_RING_BUFFER_SIZE(rxBufferMinSize)]; \
+	UartComms_Port_t portName = \
+	{ \
+		.txLanes = \
+		{ \
+			[UART_COMMS_TX_PRIORITY_URGENT] = { portName##_txUrgentStorage, sizeof(portName##_txUrgentStorage) }, \
+			[UART_COMMS_TX_PRIORITY_BULK] = { portName##_txBulkStorage, sizeof(portName##_txBulkStorage) } \
+		}, \
+		.rxBufferStorage 	= portName##_rxBufferStorage, \
+		.rxBufferSize 		= sizeof(portName##_rxBufferStorage) \
+	};
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! @brief		Called by the TX task once a zero-copy buffer has been sent
+//! @param		data	The buffer given to UartComms_PutBufferZeroCopy(), which may now be reused
+//! @param		arg		The callbackArg given to UartComms_PutBufferZeroCopy()
+//! @note		Called from the TX task. Keep it short (e.g. give a semaphore) and do not call
+//!				UartComms_PutString() or friends from it.
+typedef void (*UartComms_TxCompleteCallback_t)(const uint8 *data, void *arg);
+
+//! What a write does when there is no room in the tx buffer
+typedef enum
+{
+	UART_COMMS_TX_OVERFLOW_BLOCK,	//!< Wait for room (up to a timeout), then drop
+	UART_COMMS_TX_OVERFLOW_DROP		//!< Drop straight away, never blocks
+} UartComms_TxOverflowPolicy_t;
+
+//! TX lanes, in the order the TX task drains them
+typedef enum
+{
+	UART_COMMS_TX_PRIORITY_URGENT,	//!< Alarms and other messages which must not wait behind bulk data
+	UART_COMMS_TX_PRIORITY_BULK,	//!< Everything else (logs, dumps, ...)
+	UART_COMMS_NUM_TX_PRIORITIES
+} UartComms_TxPriority_t;
+
+//! Flow control modes, see UartComms_SetFlowControl()
+typedef enum
+{
+	UART_COMMS_FLOW_CONTROL_NONE,		//!< No flow control
+	UART_COMMS_FLOW_CONTROL_RTS_CTS,	//!< Hardware flow control, needs a backend with setRts() and readCts()
+	UART_COMMS_FLOW_CONTROL_XON_XOFF	//!< Software flow control, XON and XOFF bytes are not passed on to readers
+} UartComms_FlowControl_t;
+
+//! @brief		Runtime statistics of one TX lane, see UartComms_Stats_t
+//! @details	Latency is the time from a write being committed to the TX task starting to send it.
+typedef struct
+{
+	uint32 numWrites;					//!< Writes sent
+	uint32 numBytes;					//!< Bytes sent
+	uint32 numBytesDropped;				//!< Bytes dropped because the lane's tx buffer was full
+	uint32 bufferHighWaterMark;			//!< Most bytes ever in use in the lane's tx buffer (including record headers)
+	portTickType latencyTotal;			//!< Total latency of the writes sent
+	portTickType latencyMax;			//!< Longest latency of a write sent
+} UartComms_TxLaneStats_t;
+
+//! @brief		Runtime statistics of a port, see UartComms_GetStats()
+//! @details	Times are in ticks. Counters are updated without locking where only one context
+//!				writes them, so a count made at the same moment as a reset may be lost. A
+//!				feature's counters are only there when the feature is turned on.
+typedef struct
+{
+	uint32 numTxBytes;					//!< Bytes put into the hardware TX FIFO
+	uint32 numRxBytes;					//!< Bytes put into the rx buffer
+	uint32 txBufferHighWaterMark;		//!< Most bytes ever in use in a tx buffer (including record headers)
+	uint32 rxBufferHighWaterMark;		//!< Most bytes ever in the rx buffer
+	uint32 numTxBytesDropped;			//!< Bytes dropped because a tx buffer was full
+	uint32 numRxBytesDropped;			//!< Bytes dropped because the rx buffer was full
+	portTickType txWaitTimeMax;			//!< Longest time a writer waited for room in the tx buffer
+	portTickType txWaitTimeTotal;		//!< Total time writers waited for room in the tx buffer
+	uint32 numRxIsrCalls;				//!< Number of times the RX ISR ran
+	uint32 rxIsrMaxBytes;				//!< Most bytes read by one run of the RX ISR
+	uint32 numTxIsrCalls;				//!< Number of times the TX ISR ran
+	uint32 txIsrMaxBytes;				//!< Most bytes written by one run of the TX ISR
+	uint32 numBreakErrors;				//!< Bytes received with UART_COMMS_RX_STS_BREAK
+	uint32 numParityErrors;				//!< Bytes received with UART_COMMS_RX_STS_PAR_ERROR
+	uint32 numStopErrors;				//!< Bytes received with UART_COMMS_RX_STS_STOP_ERROR
+	uint32 numOverrunErrors;			//!< Bytes received with UART_COMMS_RX_STS_OVERRUN
+	uint32 numSoftBufferOverflows;		//!< Bytes received with UART_COMMS_RX_STS_SOFT_BUFF_OVER
+	uint32 numSleeps;					//!< Number of times the UART was put to sleep
+	uint32 numWakeups;					//!< Number of times the UART was woken up
+	portTickType timeAsleep;			//!< Total time the UART was asleep
+	uint32 numRxErrorEventsDropped;		//!< RX error events lost because the error event ring was full
+	uint32 numWakeLatencySamples;		//!< Number of writes which found the UART asleep
+	portTickType wakeLatencyTotal;		//!< Total time from those writes being made to the UART sending them
+	portTickType wakeLatencyMax;		//!< Longest time from one of those writes being made to the UART sending it
+	uint32 numAnnouncedWakeups;			//!< Number of times the UART was woken early for an announced write
+	UartComms_TxLaneStats_t txLanes[UART_COMMS_NUM_TX_PRIORITIES];	//!< Stats of each TX lane
+	uint32 numRxFrames;					//!< Frames received which passed the CRC
+	uint32 numRxFrameErrors;			//!< Frames dropped because they were too long, cut short, corrupted or failed the CRC
+	uint32 numRxFramesDropped;			//!< Good frames dropped because their frame queue was full
+	uint32 numRxFramesUnrouted;			//!< Channel frames dropped because their channel ID was out of range
+	uint32 numRxThrottles;				//!< Number of times the other end was told to stop sending
+	uint32 numTxFlowStops;				//!< Number of times the TX ISR stopped because the other end said stop
+	#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+		uint32 numCompressedBlocks;			//!< Blocks sent compressed
+		uint32 numCompressInBytes;			//!< Bytes put through the compression stage
+		uint32 numCompressOutBytes;			//!< Bytes the compression stage sent for them (frames, or blocks which didn't compress)
+	#endif
+	#if(configUART_COMMS_ENABLE_TRACE == 1)
+		uint32 numTraceBytesDropped;		//!< Bytes not traced because the trace ring was full
+	#endif
+	#if(configUART_COMMS_ENABLE_LOG == 1)
+		uint32 numLogRecords;				//!< Log records queued by UartComms_Log()
+		uint32 numLogBytes;					//!< Bytes queued for them (frames and delimiters)
+	#endif
+	#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+		uint32 numBaudSwitches;				//!< Baud rate changes which were agreed (and probed) with the other end
+		uint32 numBaudFallbacks;			//!< Baud rate changes which failed the probe and went back to the old rate
+	#endif
+} UartComms_Stats_t;
+
+//! @brief		A received byte which had one or more error flags set
+typedef struct
+{
+	portTickType time;					//!< Tick count when the RX ISR read the byte
+	uint8 status;						//!< UART_COMMS_RX_STS_x flags of the byte
+} UartComms_RxErrorEvent_t;
+
+//! @brief		Describes the write being sent by the TX task. Zero-copy writes are stored in the
+//!				tx buffer as one of these.
+//! @private
+typedef struct
+{
+	//! Data to send
+	const uint8 *data;
+	//! Number of bytes to send
+	uint32 numBytes;
+	//! Called once the data has been sent, may be NULL
+	UartComms_TxCompleteCallback_t callback;
+	//! Passed to callback
+	void *callbackArg;
+} UartComms_TxDescriptor_t;
+
+//! @brief		Queue of received frames for one channel
+//! @private
+typedef struct
+{
+	//! Received frames, each a uint16 length followed by the payload
+	UartCommsRingBuffer_t frames;
+	//! Given by the RX ISR when it queues frames
+	xSemaphoreHandle semaphore;
+	#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+		StaticSemaphore_t semaphoreBuffer;	//!< Storage for semaphore
+	#endif
+	//! Storage for frames
+	uint8 storage[UART_COMMS_RING_BUFFER_SIZE(configUART_COMMS_RX_FRAME_QUEUE_SIZE)];
+} UartComms_RxChannel_t;
+
+//! @brief		One TX lane of a port
+//! @private
+typedef struct
+{
+	uint32 *storage;					//!< Set by UART_COMMS_PORT_DEFINE()
+	uint32 size;						//!< Set by UART_COMMS_PORT_DEFINE()
+	//! Given by the TX task after freeing space while a chain is open, to wake the writer
+	//! putting the chain in. Other writers wait on UartComms_Port_t.txSpaceSemaphore.
+	xSemaphoreHandle chainSemaphore;
+	#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+		StaticSemaphore_t chainSemaphoreBuffer;	//!< Storage for chainSemaphore
+	#endif
+	//! Every write is reserved, copied and committed in here, the TX task sends them in order
+	UartCommsRecordBuffer_t buffer;
+} UartComms_TxLane_t;
+
+//! @brief		A TX task, which services one port, or all of them
+//! @private
+typedef struct
+{
+	xTaskHandle handle;					//!< Handle for the task
+	xSemaphoreHandle wakeSemaphore;		//!< Given by producers and ISR's when the task has work to do
+	#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+		StaticSemaphore_t wakeSemaphoreBuffer;	//!< Storage for wakeSemaphore
+		StaticTask_t taskBuffer;			//!< Storage for the task
+		StackType_t stack[configUART_COMMS_TX_TASK_STACK_SIZE];	//!< The task's stack
+	#endif
+} UartComms_TxTaskInfo_t;
+
+//! @brief		State of one UART. Define with UART_COMMS_PORT_DEFINE().
+//! @details	All members are private.
+typedef struct UartComms_Port
+{
+	// Set by UART_COMMS_PORT_DEFINE()
+	uint8 *rxBufferStorage;
+	uint32 rxBufferSize;
+
+	//! UART hardware (or emulator) used by this port. Set with UartComms_SetBackend().
+	const UartComms_Backend_t *backend;
+	//! Next port started, used by the TX task to find the ports it services
+	struct UartComms_Port *nextPort;
+	//! TX task servicing this port
+	UartComms_TxTaskInfo_t *txTask;
+	#if(configUART_COMMS_SHARED_TX_TASK == 0)
+		//! This port's own TX task
+		UartComms_TxTaskInfo_t ownTxTask;
+	#endif
+
+	//! Number of times the uart has been locked from sleeping
+	uint8 sleepLockCount;
+	//! TRUE if the uart is asleep
+	bool_t isAsleep;
+	//! TRUE if the uart is allowed to sleep
+	bool_t allowSleep;
+
+	//! Rx buffer. The RX ISR copies the contents of the hardware FIFO in here in one go.
+	UartCommsRingBuffer_t rxBuffer;
+	//! Given by the RX ISR when the rx buffer becomes non-empty or crosses the watermark, or
+	//! (while rxIsWaitingForDelimiter) when a delimiter arrives or it crosses the watermark
+	xSemaphoreHandle rxDataSemaphore;
+	#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+		StaticSemaphore_t rxDataSemaphoreBuffer;	//!< Storage for rxDataSemaphore
+	#endif
+	//! TRUE while UartComms_ReadUntil() is waiting for one of the bytes in rxDelimiterMap
+	volatile bool_t rxIsWaitingForDelimiter;
+	//! Bit n set if byte n is a delimiter, set by UartComms_ReadUntil()
+	uint32 rxDelimiterMap[256/32];
+	//! TRUE if the last line read by UartComms_ReadLine() ended with a '\r'
+	bool_t rxIsAfterCr;
+	//! UartComms_RxErrorEvent_t's written by the RX ISR
+	UartCommsRingBuffer_t rxErrorEvents;
+	//! Storage for rxErrorEvents
+	uint8 rxErrorEventStorage[UART_COMMS_RING_BUFFER_SIZE(
+		configUART_COMMS_RX_ERROR_EVENT_QUEUE_LENGTH*sizeof(UartComms_RxErrorEvent_t))];
+
+	#if(configUART_COMMS_ENABLE_TRACE == 1)
+		//! TRUE if bytes sent and received are recorded in trace
+		volatile bool_t isTracing;
+		//! Records written by the RX ISR and TX task
+		UartCommsTrace_t trace;
+		//! Storage for trace
+		uint8 traceStorage[UART_COMMS_RING_BUFFER_SIZE(configUART_COMMS_TRACE_BUFFER_SIZE)];
+	#endif
+
+	#if(configUART_COMMS_ENABLE_FRAMING == 1)
+		//! TRUE if the RX ISR decodes frames instead of filling the rx buffer
+		bool_t rxIsFraming;
+		//! TRUE if the RX ISR routes frames by the channel ID in their first byte
+		bool_t rxIsUsingChannels;
+		//! Decodes received frames into rxFrameBuffer
+		UartCommsFrameDecoder_t rxFrameDecoder;
+		//! Frame being decoded, after a 2 byte length, so it can be queued with one write
+		uint8 rxFrameBuffer[2 + 1 + configUART_COMMS_RX_FRAME_MAX_SIZE + UART_COMMS_FRAME_CRC_SIZE];
+		//! Queues of received frames, indexed by channel ID
+		UartComms_RxChannel_t rxChannels[configUART_COMMS_NUM_RX_CHANNELS];
+	#endif
+
+	#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+		// Baud rate negotiation state
+		const uint32 *baudRates;			//!< Rates this end supports, set with UartComms_SetBaudRates()
+		uint8 numBaudRates;					//!< Number of rates in baudRates
+		uint32 baudIdleRate;				//!< Rate both ends start at, and drop back to when idle
+		portTickType baudIdleTimeout;		//!< How long the link is quiet before dropping to baudIdleRate, 0 for never
+		volatile uint32 baudRate;			//!< Rate the backend was last set to
+		volatile bool_t txIsHeld;			//!< TRUE while the TX task mustn't start anything (the rate is changing)
+		volatile bool_t rxIsPaused;			//!< TRUE while the RX ISR drops everything (the rate is changing)
+		volatile portTickType rxLastByteTime;	//!< When the RX ISR last ran
+	#endif
+
+	//! TX lanes, indexed by UartComms_TxPriority_t
+	UartComms_TxLane_t txLanes[UART_COMMS_NUM_TX_PRIORITIES];
+	//! Given by the TX task after freeing space in a tx buffer, to wake a blocked writer
+	xSemaphoreHandle txSpaceSemaphore;
+	#if(configUART_COMMS_STATIC_ALLOCATION == 1)
+		StaticSemaphore_t txSpaceSemaphoreBuffer;	//!< Storage for txSpaceSemaphore
+	#endif
+	//! What a write does when the tx buffer is full
+	UartComms_TxOverflowPolicy_t txOverflowPolicy;
+	//! Number of writes dropped because the tx buffer was full
+	uint32 txNumDropped;
+
+	// Flow control state
+	UartComms_FlowControl_t flowControl;	//!< Set with UartComms_SetFlowControl()
+	volatile bool_t rxIsThrottled;			//!< TRUE if the other end has been told to stop sending
+	volatile bool_t txIsPeerStopped;		//!< TRUE if the other end sent XOFF
+	volatile uint8 txPendingFlowByte;		//!< XON or XOFF waiting for room in the hardware FIFO, 0 if none
+
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		UartComms_Stats_t stats;			//!< See UartComms_GetStats()
+		portTickType sleepStartTime;		//!< When the UART last went to sleep
+	#endif
+
+	// TX task state
+	UartComms_TxDescriptor_t txDescriptor;	//!< Write being sent
+	bool_t txIsHoldingRecord;				//!< TRUE if txDescriptor points into the tx buffer of txLane
+	uint8 txLane;							//!< Lane txDescriptor came from
+	bool_t txIsChaining;					//!< TRUE while txLane is held for the rest of a chain of records
+	uint8 txState;
+	portTickType txTimerStart;
+	portTickType txTimerPeriod;
+
+	// Coalescing mode state
+	bool_t txIsCoalescing;					//!< TRUE if coalescing mode is on
+	volatile bool_t txIsFlushRequested;		//!< Set by UartComms_Flush()
+	uint32 txStagingLength;					//!< Number of bytes in txStaging
+	portTickType txStagingStartTime;		//!< When the first byte was put in txStaging
+	uint8 txStaging[UART_COMMS_TX_STAGING_SIZE];	//!< Small writes are combined in here
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		uint32 txStagingNumWrites;			//!< Number of writes in txStaging
+		portTickType txStagingCommitTimeSum;	//!< Sum of the commit times of the writes in txStaging
+		portTickType txStagingOldestCommitTime;	//!< Commit time of the first write in txStaging
+	#endif
+
+	#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+		// Compression stage state
+		bool_t txIsCompressing;				//!< TRUE if bulk writes are compressed
+		UartCommsLzss_Encoder_t txEncoder;	//!< Encoder working memory
+		//! Compressed block
+		uint8 txCompressed[UART_COMMS_LZSS_MAX_COMPRESSED_SIZE(configUART_COMMS_COMPRESS_BLOCK_SIZE)];
+		//! Leading delimiter and the frame holding txCompressed, sent by the TX ISR
+		uint8 txCompressedFrame[1 + UART_COMMS_FRAME_MAX_ENCODED_SIZE(
+			1 + UART_COMMS_LZSS_MAX_COMPRESSED_SIZE(configUART_COMMS_COMPRESS_BLOCK_SIZE))];
+	#endif
+
+	// Sleep policy state
+	portTickType txIdleStartTime;			//!< When the last burst ended
+	portTickType txIdleTimeout;				//!< How long the UART was kept awake after the last burst
+	uint32 txIdleGapAverage;				//!< Average gap between bursts, in 1/16's of a tick
+	uint32 txIdleGapDeviation;				//!< Average deviation of the gap between bursts, in 1/16's of a tick
+	portTickType txAnnounceTime;			//!< When UartComms_AnnounceWrite() was called
+	portTickType txAnnounceDelay;			//!< Ticks after txAnnounceTime the write is due
+	volatile bool_t txIsWriteAnnounced;		//!< TRUE if a write has been announced and not arrived yet
+	#if(configUART_COMMS_ENABLE_STATS == 1)
+		portTickType txWakeRequestTime;		//!< When the first write was made while asleep
+		bool_t txIsWakeRequested;			//!< TRUE if txWakeRequestTime is valid
+	#endif
+
+	// TX ISR state
+	const uint8 * volatile txIsrData;		//!< Next byte the TX ISR will put into the hardware FIFO
+	volatile uint32 txIsrNumBytesLeft;		//!< Bytes the TX ISR still has to put into the hardware FIFO
+	volatile bool_t txIsrBusy;				//!< TRUE while the TX ISR owns the hardware
+} UartComms_Port_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+// See the function definitions in UartComms.c for more information
+
+//! @brief		Selects the UART hardware (or emulator) to use
+//! @details	Optional on the PSoC, where the UartCpComms component is used by default.
+//!				Required on a host.
+//! @param		backend		Backend to use, must remain valid for the life of the program
+//! @note		Not thread-safe. Call from main() before UartComms_Start().
+//! @public
+void 		UartComms_SetBackend(UartComms_Port_t *port, const UartComms_Backend_t *backend);
+
+//! @brief		Start-up function. Call from main() before starting scheduler, once per port.
+//! @details	When configUART_COMMS_SHARED_TX_TASK is 1, the shared TX task is created by
+//!				the first call, and txTaskStackSize and txTaskPriority are ignored after that.
+//! @returns	FALSE if a semaphore or the TX task couldn't be created (the FreeRTOS heap is
+//!				exhausted), in which case the port must not be used. Always TRUE with
+//!				configUART_COMMS_STATIC_ALLOCATION.
+//! @note		Not thread-safe. Do not call from any task!
+//! @sa			main()
+//! @public
+bool_t 		UartComms_Start(UartComms_Port_t *port, uint32 txTaskStackSize, uint8 txTaskPriority);
+
+//! @brief		Puts null-terminated string into the tx buffer
+//! @details	Only waits for another task putting in a chain (below). If the tx buffer is
+//!				full, waits for room or drops the string, depending on the overflow policy. The
+//!				string is never mixed with other writes. A string longer than
+//!				UartComms_GetMaxWriteLength() is put in as a chain of records: other writers to
+//!				the lane wait for it (as if the buffer were full), and the TX task sends nothing
+//!				else until its last record. Each record may wait for room, so the string is only
+//!				cut short if that wait times out. With UART_COMMS_TX_OVERFLOW_DROP such a string
+//!				is dropped.
+//! @returns	TRUE on success, FALSE if the string was dropped (or cut short)
+//! @warning	Do not call from an ISR!
+//! @note		Thread-safe
+//! @sa			UartComms_Write()
+//! @public
+bool_t 		UartComms_PutString(UartComms_Port_t *port, const char* string);
+
+//! @brief		Puts numBytes bytes into the tx buffer
+//! @details	Same as UartComms_PutString(), but the data is not null-terminated and may contain
+//!				any byte value. Data is copied into the buffer with one copy.
+//! @returns	TRUE on success, FALSE if the data was dropped
+//! @warning	Do not call from an ISR!
+//! @note		Thread-safe
+//! @public
+bool_t 		UartComms_Write(UartComms_Port_t *port, const uint8* data, uint32 numBytes);
+
+//! @brief		Puts null-terminated string into the tx buffer of a TX lane
+//! @details	Same as UartComms_PutString(), which uses UART_COMMS_TX_PRIORITY_BULK. Writes to the
+//!				urgent lane are sent before anything in the bulk lane which hasn't been started yet.
+//! @returns	TRUE on success, FALSE if the string was dropped
+//! @warning	Do not call from an ISR!
+//! @note		Thread-safe
+//! @public
+bool_t 		UartComms_PutStringPriority(UartComms_Port_t *port, const char* string, UartComms_TxPriority_t priority);
+
+//! @brief		Puts numBytes bytes into the tx buffer of a TX lane
+//! @details	Same as UartComms_Write(), which uses UART_COMMS_TX_PRIORITY_BULK.
+//! @returns	TRUE on success, FALSE if the data was dropped
+//! @warning	Do not call from an ISR!
+//! @note		Thread-safe
+//! @public
+bool_t 		UartComms_WritePriority(
+				UartComms_Port_t *port,
+				const uint8* data,
+				uint32 numBytes,
+				UartComms_TxPriority_t priority);
+
+//! @brief		Returns the longest write a TX lane sends as one record
+//! @details	A little under half the lane's tx buffer. Longer writes are sent as a chain of
+//!				records (see UartComms_PutString()), longer frames are dropped (and counted).
+//! @note		Thread-safe
+//! @public
+uint32 		UartComms_GetMaxWriteLength(UartComms_Port_t *port, UartComms_TxPriority_t priority);
+
+//! @brief		Queues a buffer to be sent straight from the caller's memory, without copying it
+//! @details	Meant for large static payloads (firmware dumps, calibration tables, ...). Only a
+//!				pointer and length are queued, the TX task reads the buffer as it sends it. The
+//!				buffer is sent in order with all other bulk lane writes.
+//! @param		data		Data to send. Must not be modified until callback has been called.
+//! @param		numBytes	Number of bytes to send
+//! @param		callback	Called by the TX task once the whole buffer has been sent, may be NULL
+//! @param		callbackArg	Passed to callback
+//! @returns	TRUE if the buffer was queued, FALSE if it was dropped (callback will not be called)
+//! @warning	Do not call from an ISR!
+//! @note		Thread-safe
+//! @public
+bool_t 		UartComms_PutBufferZeroCopy(
+				UartComms_Port_t *port,
+				const uint8* data,
+				uint32 numBytes,
+				UartComms_TxCompleteCallback_t callback,
+				void *callbackArg);
+
+#if(configUART_COMMS_ENABLE_FRAMING == 1)
+	//! @brief		Sends a frame (see UartCommsFrame.h)
+	//! @details	The payload is CRC'd and COBS encoded straight into the bulk lane's tx buffer,
+	//!				as one write, so a frame is never interleaved with other writes.
+	//! @returns	TRUE on success, FALSE if the frame was dropped (tx buffer full, or the encoded
+	//!				frame is longer than half the tx buffer)
+	//! @warning	Do not call from an ISR!
+	//! @note		Thread-safe
+	//! @public
+	bool_t 		UartComms_PutFrame(UartComms_Port_t *port, const uint8* payload, uint32 numBytes);
+
+	//! @brief		Turns frame decoding of received bytes on or off
+	//! @details	While on, received bytes go to the frame decoder instead of the rx buffer, so
+	//!				UartComms_Read() and UartComms_GetChar() get nothing. Ports start with it off.
+	//! @note		Thread-safe
+	//! @public
+	void 		UartComms_SetRxFraming(UartComms_Port_t *port, bool_t isEnabled);
+
+	//! @brief		Copies the payload of the oldest received frame into frame
+	//! @details	Blocks for up to timeout ticks if there are none. A payload longer than
+	//!				maxNumBytes is cut short. Same as UartComms_ReadChannelFrame() on channel 0.
+	//! @param		frame			Buffer to copy the payload into
+	//! @param		maxNumBytes		Size of frame
+	//! @param		timeout			Max time to wait (in ticks). 0 to not wait, portMAX_DELAY to wait forever.
+	//! @param		numBytes		Set to the number of bytes copied into frame
+	//! @returns	TRUE if a frame was read, FALSE on timeout
+	//! @note		Not-thread safe.
+	//! @public
+	bool_t 		UartComms_ReadFrame(
+					UartComms_Port_t *port,
+					uint8* frame,
+					uint32 maxNumBytes,
+					uint32 *numBytes,
+					portTickType timeout);
+
+	//! @brief		Sends a frame on a channel
+	//! @details	Same as UartComms_PutFrame(), with the channel ID in front of the payload.
+	//! @param		channel		Channel ID, 0 to 255 (the receiver decides which it routes)
+	//! @returns	TRUE on success, FALSE if the frame was dropped
+	//! @warning	Do not call from an ISR!
+	//! @note		Thread-safe
+	//! @public
+	bool_t 		UartComms_PutChannelFrame(
+					UartComms_Port_t *port,
+					uint8 channel,
+					const uint8* payload,
+					uint32 numBytes);
+
+	//! @brief		Turns routing of received frames by channel ID on or off
+	//! @details	While on, the first byte of every received frame is taken as its channel ID
+	//!				and removed, and the rest is queued on that channel. Frames with a channel
+	//!				ID of configUART_COMMS_NUM_RX_CHANNELS or more are dropped. While off, all
+	//!				frames go to channel 0. Ports start with it off. Only takes effect while
+	//!				UartComms_SetRxFraming() is on.
+	//! @note		Thread-safe
+	//! @public
+	void 		UartComms_SetRxChannels(UartComms_Port_t *port, bool_t isEnabled);
+
+	//! @brief		Copies the payload of the oldest frame received on a channel into frame
+	//! @details	Same as UartComms_ReadFrame(), for one channel. Different tasks can read
+	//!				different channels at the same time.
+	//! @param		channel		Channel ID, less than configUART_COMMS_NUM_RX_CHANNELS
+	//! @returns	TRUE if a frame was read, FALSE on timeout or if channel is out of range
+	//! @note		Not-thread safe for the same channel, only read a channel from one task
+	//! @public
+	bool_t 		UartComms_ReadChannelFrame(
+					UartComms_Port_t *port,
+					uint8 channel,
+					uint8* frame,
+					uint32 maxNumBytes,
+					uint32 *numBytes,
+					portTickType timeout);
+#endif
+
+//! @brief		Sets what writes do when the tx buffer is full
+//! @details	Ports start with configUART_COMMS_TX_OVERFLOW_POLICY.
+//! @note		Thread-safe
+//! @public
+void 		UartComms_SetTxOverflowPolicy(UartComms_Port_t *port, UartComms_TxOverflowPolicy_t policy);
+
+//! @brief		Selects the flow control mode
+//! @details	Ports start with configUART_COMMS_FLOW_CONTROL. Flow control only covers the rx
+//!				buffer, frame queues are not throttled. In XON/XOFF mode, received 0x11 and 0x13
+//!				bytes are taken as flow control (except while rx framing is on), so it only
+//!				suits text. The UART doesn't sleep while flow control is on. Call after
+//!				UartComms_Start().
+//! @returns	FALSE if mode is UART_COMMS_FLOW_CONTROL_RTS_CTS and the backend has no RTS
+//!				or CTS line, otherwise TRUE
+//! @note		Thread-safe
+//! @public
+bool_t 		UartComms_SetFlowControl(UartComms_Port_t *port, UartComms_FlowControl_t mode);
+
+//! @brief		Turns coalescing mode on or off
+//! @details	In coalescing mode, small writes are combined in a staging buffer by the TX task
+//!				and sent together. This saves per-write overhead and sleep/wake cycles when
+//!				tasks write lots of small fragments, at the cost of up to
+//!				configUART_COMMS_COALESCE_DEADLINE_MS of latency. Ports start with
+//!				configUART_COMMS_COALESCE.
+//! @note		Thread-safe
+//! @public
+void 		UartComms_SetCoalescing(UartComms_Port_t *port, bool_t isEnabled);
+
+#if(configUART_COMMS_ENABLE_COMPRESSION == 1)
+	//! @brief		Turns compression of the bulk lane on or off
+	//! @details	Bulk writes are collected into blocks of up to configUART_COMMS_COMPRESS_BLOCK_SIZE
+	//!				bytes, which are sent once full, configUART_COMMS_COMPRESS_DEADLINE_MS after the
+	//!				first byte, or on UartComms_Flush(). Latency-sensitive output should use the
+	//!				urgent lane (UartComms_PutStringPriority()), which is never compressed, as are
+	//!				zero-copy writes. Ports start with configUART_COMMS_COMPRESS.
+	//! @note		Thread-safe
+	//! @public
+	void 		UartComms_SetCompression(UartComms_Port_t *port, bool_t isEnabled);
+#endif
+
+#if(configUART_COMMS_ENABLE_LOG == 1)
+	//! @brief		Logs a format ID and its arguments, to be formatted on a host
+	//! @details	e.g. UartComms_Log(&uartCommsPort, LOG_FAN_SPEED, fan, rpm). Every argument is
+	//!				converted to a uint32 (see UartCommsLog.h, floats need UartCommsLog_FloatToWord()),
+	//!				up to UART_COMMS_LOG_MAX_ARGS of them. Uses UartComms_LogArgs().
+	//! @public
+	#define UartComms_Log(port, formatId, ...) \
+		UartComms_LogArgs((port), (formatId), \
+			&((const uint32[]){ 0, ##__VA_ARGS__ })[1], \
+			sizeof((const uint32[]){ 0, ##__VA_ARGS__ })/sizeof(uint32) - 1)
+
+	//! @brief		Sends a log record (see UartCommsLog.h) with the current tick count
+	//! @details	The record is sent in the bulk lane as a frame on configUART_COMMS_LOG_CHANNEL,
+	//!				with a delimiter in front, in order with the port's other bulk writes.
+	//! @param		args		Arguments, numArgs words
+	//! @param		numArgs		Up to UART_COMMS_LOG_MAX_ARGS
+	//! @returns	TRUE on success, FALSE if the record was dropped (tx buffer full, or too many
+	//!				arguments)
+	//! @warning	Do not call from an ISR!
+	//! @note		Thread-safe
+	//! @public
+	bool_t 		UartComms_LogArgs(
+					UartComms_Port_t *port,
+					UartCommsLog_FormatId_t formatId,
+					const uint32 *args,
+					uint32 numArgs);
+#endif
+
+#if(configUART_COMMS_ENABLE_BAUD_NEGOTIATION == 1)
+	//! @brief		Sets the baud rates this end supports, and the rate the link starts at
+	//! @details	The UART must already be running at idleRate (as must the other end). Only
+	//!				list rates the backend can set (see UartComms_Backend_t.setBaudRate), a change
+	//!				to one it can't fails and falls back.
+	//! @param		rates		Up to configUART_COMMS_BAUD_MAX_RATES rates, in any order. Must
+	//!							remain valid for the life of the program.
+	//! @param		idleRate	Rate the link starts at, and drops back to when idle. Both ends
+	//!							must use the same one.
+	//! @note		Not thread-safe. Call from main() before UartComms_Start().
+	//! @public
+	void 		UartComms_SetBaudRates(UartComms_Port_t *port, const uint32 *rates, uint8 numRates, uint32 idleRate);
+
+	//! @brief		Sets how long the link has to be quiet (nothing sent or received) before
+	//!				UartComms_ServeBaudRate() drops it back to the idle rate
+	//! @details	Ports start with 0 (never). Dropping back also brings the two ends back
+	//!				together if a change went wrong part way through, so set it on both ends.
+	//! @param		timeout		In ticks, 0 for never
+	//! @note		Thread-safe
+	//! @public
+	void 		UartComms_SetBaudIdleTimeout(UartComms_Port_t *port, portTickType timeout);
+
+	//! @brief		Agrees the highest baud rate both ends support with the other end, and
+	//!				switches to it
+	//! @details	The other end must be calling UartComms_ServeBaudRate(). Waits for everything
+	//!				already written to be sent before changing the rate, and writes made while
+	//!				it is changing wait until it has. The new rate is checked with a probe frame,
+	//!				and if it isn't answered both ends go back to the rate they were at. Only one
+	//!				end of a link should start negotiations.
+	//! @param		timeout		Max time (in ticks) to wait for the other end to answer the request
+	//! @returns	TRUE if both ends are at the agreed rate (which may be the rate they were
+	//!				already at), FALSE if the other end didn't answer, supports none of the rates,
+	//!				or the new rate didn't work
+	//! @warning	Needs UartComms_SetRxFraming() and UartComms_SetRxChannels() on. Reads
+	//!				configUART_COMMS_BAUD_CHANNEL, so call from the task which calls
+	//!				UartComms_ServeBaudRate().
+	//! @public
+	bool_t 		UartComms_NegotiateBaudRate(UartComms_Port_t *port, portTickType timeout);
+
+	//! @brief		Answers baud rate requests and probes from the other end, and drops the link
+	//!				to the idle rate once it has been quiet for the idle timeout
+	//! @details	Call in a loop from one task, on both ends of the link. Returns after handling
+	//!				one frame from the other end, or after timeout.
+	//! @param		timeout		Max time (in ticks) to wait for a frame
+	//! @returns	TRUE if the baud rate changed, otherwise FALSE
+	//! @warning	Needs UartComms_SetRxFraming() and UartComms_SetRxChannels() on.
+	//! @note		Not thread-safe, only call from one task per port
+	//! @public
+	bool_t 		UartComms_ServeBaudRate(UartComms_Port_t *port, portTickType timeout);
+
+	//! @brief		Returns the baud rate the port is at
+	//! @note		Thread-safe
+	//! @public
+	uint32 		UartComms_GetBaudRate(UartComms_Port_t *port);
+#endif
+
+#if(configUART_COMMS_ENABLE_TRACE == 1)
+	//! @brief		Turns recording of bytes sent and received into the trace ring on or off
+	//! @details	Bytes are recorded as the RX ISR reads them from the FIFO (before any are
+	//!				discarded), and as the TX task hands each write to the TX ISR. When the ring
+	//!				is full new bytes are dropped (and counted in the stats), so read it out often
+	//!				with UartComms_ReadTrace() or UartComms_DumpTrace(). Ports start with
+	//!				configUART_COMMS_TRACE.
+	//! @note		Thread-safe
+	//! @public
+	void 		UartComms_SetTracing(UartComms_Port_t *port, bool_t isEnabled);
+
+	//! @brief		Reads up to maxNumBytes of the trace stream (see UartCommsTrace.h)
+	//! @details	Records can be split between reads. Save everything read, in order, after a
+	//!				file header from UartCommsTrace_EncodeFileHeader(), to make a trace file.
+	//! @returns	Number of bytes read
+	//! @note		Not thread-safe, only read the trace of a port from one task
+	//! @public
+	uint32 		UartComms_ReadTrace(UartComms_Port_t *port, uint8 *data, uint32 maxNumBytes);
+
+	#if(UART_COMMS_HOST_BUILD == 1)
+		//! @brief		Appends the trace ring to a trace file, emptying the ring
+		//! @details	Writes the file header first if the file is new or empty. Call every so
+		//!				often while tracing, and once more at the end.
+		//! @returns	TRUE on success, FALSE if the file couldn't be written
+		//! @note		Not thread-safe, only read the trace of a port from one task
+		//! @public
+		bool_t 		UartComms_DumpTrace(UartComms_Port_t *port, const char *fileName);
+	#endif
+#endif
+
+//! @brief		Sends everything written so far without waiting for the coalescing (or compression)
+//!				deadline
+//! @details	Does not wait for the data to be sent. Does nothing if coalescing mode and
+//!				compression are off.
+//! @note		Thread-safe
+//! @public
+void 		UartComms_Flush(UartComms_Port_t *port);
+
+//! @brief		Tells the port a write is coming, so the UART can be woken up ahead of it
+//! @details	If the UART is asleep it is woken configUART_COMMS_WAKE_LEAD_TIME_MS before the
+//!				write is due, and kept awake for up to configUART_COMMS_MAX_IDLE_TIMEOUT_MS after.
+//!				If it is about to be slept after a burst, it is kept awake for the write instead
+//!				(as long as it is due within configUART_COMMS_MAX_IDLE_TIMEOUT_MS).
+//! @param		ticksUntilWrite		How long until the write will be made
+//! @note		Thread-safe
+//! @public
+void 		UartComms_AnnounceWrite(UartComms_Port_t *port, portTickType ticksUntilWrite);
+
+//! @brief		Returns how long (in ticks) the UART was kept awake after the last burst
+//! @details	Picked by the sleep policy, between configUART_COMMS_MIN_IDLE_TIMEOUT_MS and
+//!				configUART_COMMS_MAX_IDLE_TIMEOUT_MS.
+//! @note		Thread-safe
+//! @public
+portTickType UartComms_GetIdleTimeout(UartComms_Port_t *port);
+
+//! @brief		Returns the number of writes dropped because a tx buffer was full, or they were too long
+//! @note		Thread-safe
+//! @public
+uint32 		UartComms_GetNumDroppedTx(UartComms_Port_t *port);
+
+//! @brief		Takes the oldest RX error event off the port's error event ring
+//! @details	The RX ISR records every received byte with a break, parity, stop, overrun or
+//!				software buffer overflow flag set. Use UartComms_RxErrorFlagToString() to decode
+//!				event->status one flag at a time.
+//! @returns	TRUE if there was an event, otherwise FALSE
+//! @note		Not thread-safe, only read the events of a port from one task
+//! @public
+bool_t 		UartComms_GetRxErrorEvent(UartComms_Port_t *port, UartComms_RxErrorEvent_t *event);
+
+//! @brief		Returns a description of one UART_COMMS_RX_STS_x error flag (e.g. "Parity error")
+//! @returns	Description, or NULL if flag is not a single error flag
+//! @public
+const char* UartComms_RxErrorFlagToString(uint8 flag);
+
+//! @brief		Prints and removes every RX error event of a port
+//! @details	Prints one line per error flag with UartDebug_PutString() if
+//!				configPRINT_DEBUG_UART_COMMS is 1, otherwise just removes them. Call from a low
+//!				priority task.
+//! @returns	Number of events removed
+//! @note		Not thread-safe, only read the events of a port from one task
+//! @public
+uint32 		UartComms_ReportRxErrors(UartComms_Port_t *port);
+
+//! @brief		Copies the port's statistics into stats, and optionally resets them
+//! @details	The copy and reset happen in one critical section, so nothing is lost in between.
+//!				If configUART_COMMS_ENABLE_STATS is 0, stats is filled with zeros.
+//! @param		stats		Where to copy the statistics to
+//! @param		reset		TRUE to reset the statistics once copied
+//! @note		Thread-safe
+//! @public
+void 		UartComms_GetStats(UartComms_Port_t *port, UartComms_Stats_t *stats, bool_t reset);
+
+//! @brief		Gets one received character
+//! @details	Blocks until character is received
+//! @note		Not-thread safe.
+//! @sa			UartComms_Read()
+//! @public
+void 		UartComms_GetChar(UartComms_Port_t *port, char* singleChar);
+
+//! @brief		Copies received bytes into data
+//! @details	Returns as soon as at least one byte is available, with as many bytes as are available
+//!				(up to maxNumBytes). Blocks for up to timeout ticks if there are none.
+//! @param		data			Buffer to copy received bytes into
+//! @param		maxNumBytes		Size of data
+//! @param		timeout			Max time to wait (in ticks). 0 to not wait, portMAX_DELAY to wait forever.
+//! @returns	Number of bytes copied into data, 0 on timeout
+//! @note		Not-thread safe.
+//! @public
+uint32 		UartComms_Read(UartComms_Port_t *port, uint8* data, uint32 maxNumBytes, portTickType timeout);
+
+//! @brief		Copies received bytes into data, up to and including the first delimiter
+//! @details	Scans the rx buffer in bulk (a word at a time for up to 4 delimiters) and copies
+//!				out everything before the delimiter at once. While waiting, the reader is only
+//!				woken when a delimiter arrives or the rx buffer crosses its watermark, not on
+//!				every byte.
+//! @param		data			Buffer to copy received bytes into
+//! @param		maxNumBytes		Size of data
+//! @param		delimiters		Null-terminated set of delimiter characters (e.g. "\r\n")
+//! @param		timeout			Max time to wait (in ticks). 0 to not wait, portMAX_DELAY to wait forever.
+//! @returns	Number of bytes copied into data. The last one is the delimiter if one was found,
+//!				otherwise data is full or the timeout expired (and may be 0).
+//! @note		Not-thread safe.
+//! @public
+uint32 		UartComms_ReadUntil(
+				UartComms_Port_t *port,
+				uint8* data,
+				uint32 maxNumBytes,
+				const char* delimiters,
+				portTickType timeout);
+
+//! @brief		Reads one line, ended by '\r', '\n' or "\r\n"
+//! @details	Uses UartComms_ReadUntil(). The line is null-terminated, without its delimiter.
+//! @param		line			Buffer for the line
+//! @param		maxLength		Size of line, including the null. Must be at least 2.
+//! @param		timeout			Max time to wait (in ticks). 0 to not wait, portMAX_DELAY to wait forever.
+//! @returns	TRUE if a whole line was read (or line is full), FALSE if the timeout expired, in
+//!				which case line holds whatever part of the line had been received. FALSE
+//!				straight away if maxLength is less than 2.
+//! @note		Not-thread safe.
+//! @public
+bool_t 		UartComms_ReadLine(UartComms_Port_t *port, char* line, uint32 maxLength, portTickType timeout);
+
+//! @brief		Copies any received bytes into data, without blocking
+//! @returns	Number of bytes copied into data, may be 0
+//! @note		Not-thread safe. Same as UartComms_Read() with a timeout of 0.
+//! @public
+uint32 		UartComms_ReadNonBlocking(UartComms_Port_t *port, uint8* data, uint32 maxNumBytes);
+
+//! @brief		Used to prevent the UART from sleeping
+//! @details	Can be called from any task, up to 255 times. The UART will be prevented from sleeping
+//! 			until a similar number of UartComms_SleepUnlock() calls have been made.
+//! @note		Thread-safe
+//! @sa			UartComms_SleepUnlock()
+//! @public
+void 		UartComms_SleepLock(UartComms_Port_t *port);
+
+//! @brief		Used to allow the UART to sleep
+//! @details	Can be called from any task, up to 255 times. This function needs to be called
+//!				as many times as UartComms_SleepLock was called before the UART will be allowed
+//!				to sleep.
+//! @note		Thread-safe
+//! @sa			UartComms_SleepLock()
+//! @public
+void 		UartComms_SleepUnlock(UartComms_Port_t *port);
+
+//! @brief 		Returns sleep state of the UART
+//! @public
+bool_t 		UartComms_IsAsleep(UartComms_Port_t *port);
+
+//! @brief		Returns the handle for the TX task servicing port
+//! @returns	Handle of the TX task (the same for all ports when configUART_COMMS_SHARED_TX_TASK is 1)
+//! @note		Thread-safe
+//! @public
+xTaskHandle UartComms_ReturnTxTaskHandle(UartComms_Port_t *port);
+
+//===============================================================================================//
+//=================================== PUBLIC VARIABLES/STRUCTURES ===============================//
+//===============================================================================================//
+
+// none
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_H
+
+// EOF
@@ -0,0 +1,150 @@
+//!
+//! @file 		UartCommsBackend.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Hardware abstraction layer used by the UartComms module
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.3.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		UartComms never calls the Cypress UART API directly, it goes through a
+//!		UartComms_Backend_t table instead. UartCommsBackendPsoc.c wraps the Cypress
+//!		generated API, UartCommsBackendPosix.c emulates a UART on the FreeRTOS POSIX/Linux
+//!		port so the module can be run and measured on a host.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added writeTxData(), setTxInterruptMode() and startTxIsr() for
+//!				interrupt driven TX.
+//!			v1.1.1 -> Added int32 to the host types (used by the sleep policy).
+//!			v1.2.0 -> Added optional setRts() and readCts() for hardware flow control.
+//!			v1.3.0 -> Added optional setBaudRate() for baud rate negotiation.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_BACKEND_H
+#define UART_COMMS_BACKEND_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! Set to 1 when compiling for a host (FreeRTOS POSIX/Linux port), 0 when compiling for the PSoC
+#if defined(__unix__) || defined(__APPLE__)
+	#define UART_COMMS_HOST_BUILD				(1)
+#else
+	#define UART_COMMS_HOST_BUILD				(0)
+#endif
+
+#if(UART_COMMS_HOST_BUILD == 0)
+	// Standard PSoC includes (also provides uint8, uint16 and uint32)
+	#include <device.h>
+#else
+	#include <stdint.h>
+	#ifndef UART_COMMS_HOST_TYPES
+		#define UART_COMMS_HOST_TYPES
+		typedef uint8_t 	uint8;
+		typedef uint16_t 	uint16;
+		typedef uint32_t 	uint32;
+		typedef int32_t 	int32;
+	#endif
+#endif
+
+// RX status bits, returned in the upper 8 bits of UartComms_Backend_t.getByte() and by
+// UartComms_Backend_t.readRxStatus(). Bit positions match the Cypress UART component.
+#define UART_COMMS_RX_STS_MRKSPC				(0x01)	//!< Mark or space was received in the parity bit
+#define UART_COMMS_RX_STS_BREAK					(0x02)	//!< Break was detected
+#define UART_COMMS_RX_STS_PAR_ERROR				(0x04)	//!< Parity error was detected
+#define UART_COMMS_RX_STS_STOP_ERROR			(0x08)	//!< Stop (framing) error was detected
+#define UART_COMMS_RX_STS_OVERRUN				(0x10)	//!< Hardware RX FIFO was overrun
+#define UART_COMMS_RX_STS_FIFO_NOTEMPTY			(0x20)	//!< Hardware RX FIFO has at least one byte
+#define UART_COMMS_RX_STS_ADDR_MATCH			(0x40)	//!< Address match
+#define UART_COMMS_RX_STS_SOFT_BUFF_OVER		(0x80)	//!< Software RX buffer overflowed
+
+//! Most a baud rate set with UartComms_Backend_t.setBaudRate() may be off by (in %). Both ends
+//! of a link may be off in opposite directions, so keep well under half a UART's tolerance.
+#define UART_COMMS_BAUD_RATE_TOLERANCE_PERCENT	(2)
+
+// TX status bits, returned by UartComms_Backend_t.readTxStatus(). Bit positions match the
+// Cypress UART component.
+#define UART_COMMS_TX_STS_COMPLETE				(0x01)	//!< Last byte has completely left the shift register
+#define UART_COMMS_TX_STS_FIFO_EMPTY			(0x02)	//!< Hardware TX FIFO is empty
+#define UART_COMMS_TX_STS_FIFO_FULL				(0x04)	//!< Hardware TX FIFO is full
+#define UART_COMMS_TX_STS_FIFO_NOT_FULL			(0x08)	//!< Hardware TX FIFO has room for at least one byte
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! @brief		Interrupt handler registered with a backend
+//! @param		arg		The argument given to UartComms_Backend_t.startRxIsr()
+typedef void (*UartComms_IsrHandler_t)(void *arg);
+
+//! @brief		Function table implemented by every UART backend
+//! @details	Every function receives #context as its first argument. Function semantics follow
+//!				the Cypress UART component API of the same name.
+typedef struct
+{
+	//! Backend specific data, passed as the first argument to all of the functions below
+	void 		*context;
+	//! Starts the UART hardware (UartCpComms_Start())
+	void		(*start)(void *context);
+	//! Puts a byte into the TX FIFO, blocking until there is room (UartCpComms_PutChar())
+	void		(*putChar)(void *context, uint8 txByte);
+	//! Returns the next RX byte in the lower 8 bits and UART_COMMS_RX_STS_x flags in the
+	//! upper 8 bits (UartCpComms_GetByte())
+	uint16		(*getByte)(void *context);
+	//! Returns UART_COMMS_RX_STS_x flags (UartCpComms_ReadRxStatus())
+	uint8		(*readRxStatus)(void *context);
+	//! Returns UART_COMMS_TX_STS_x flags (UartCpComms_ReadTxStatus())
+	uint8		(*readTxStatus)(void *context);
+	//! Puts the UART to sleep (UartCpComms_Sleep())
+	void		(*sleep)(void *context);
+	//! Wakes the UART up (UartCpComms_Wakeup())
+	void		(*wakeup)(void *context);
+	//! Starts the RX interrupt, which calls handler(arg) whenever the RX FIFO is not empty
+	void		(*startRxIsr)(void *context, UartComms_IsrHandler_t handler, void *arg);
+	//! Writes a byte into the TX FIFO without waiting for room (UartCpComms_WriteTxData()).
+	//! Only call when UART_COMMS_TX_STS_FIFO_NOT_FULL is set.
+	void		(*writeTxData)(void *context, uint8 txByte);
+	//! Selects which UART_COMMS_TX_STS_x flags raise the TX interrupt, 0 disables it
+	//! (UartCpComms_SetTxInterruptMode())
+	void		(*setTxInterruptMode)(void *context, uint8 mask);
+	//! Starts the TX interrupt, which calls handler(arg) while a flag selected with
+	//! setTxInterruptMode() is set
+	void		(*startTxIsr)(void *context, UartComms_IsrHandler_t handler, void *arg);
+	//! Drives the RTS output, isReady = 1 when this end can take more data. NULL if the UART
+	//! has no RTS line.
+	void		(*setRts)(void *context, uint8 isReady);
+	//! Returns 1 if the CTS input says the other end can take more data. NULL if the UART has
+	//! no CTS line.
+	uint8		(*readCts)(void *context);
+	//! Changes the baud rate. Only called while nothing is being sent. Returns 1 if the rate
+	//! was set to within UART_COMMS_BAUD_RATE_TOLERANCE_PERCENT, otherwise 0 and the rate is
+	//! left as it was. NULL if the baud rate can't be changed.
+	uint8		(*setBaudRate)(void *context, uint32 baudRate);
+} UartComms_Backend_t;
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_BACKEND_H
+
+// EOF
@@ -0,0 +1,729 @@
+//!
+//! @file 		UartCommsBackendPosix.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsBackendPosix.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.4.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//! 	<b>Operating System:		</b> FreeRTOS POSIX/Linux port	\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsBackendPosix.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// Needed for posix_openpt(), grantpt(), unlockpt(), ptsname() and cfmakeraw()
+#define _GNU_SOURCE
+
+// User includes (selects the platform)
+#include "UartCommsBackend.h"
+
+#if(UART_COMMS_HOST_BUILD == 1)
+
+// System includes
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// User includes
+#include "PublicDefinesAndTypeDefs.h"
+#include "UartCommsBackendPosix.h"
+#include "UartCommsTrace.h"
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Maximum number of bit times the emulator can save up. Stops a long pause (e.g. a breakpoint)
+//! turning into a burst of bytes much faster than the simulated baud rate.
+#define MAX_BIT_CREDIT 			(UART_COMMS_POSIX_BITS_PER_BYTE*UART_COMMS_POSIX_MAX_FIFO_DEPTH*4)
+
+//===============================================================================================//
+//================================== PRIVATE FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+// Backend functions
+static void		UartCommsBackendPosix_Start(void *context);
+static void		UartCommsBackendPosix_PutChar(void *context, uint8 txByte);
+static uint16	UartCommsBackendPosix_GetByte(void *context);
+static uint8	UartCommsBackendPosix_ReadRxStatus(void *context);
+static uint8	UartCommsBackendPosix_ReadTxStatus(void *context);
+static void		UartCommsBackendPosix_Sleep(void *context);
+static void		UartCommsBackendPosix_Wakeup(void *context);
+static void		UartCommsBackendPosix_StartRxIsr(void *context, UartComms_IsrHandler_t handler, void *arg);
+static void		UartCommsBackendPosix_WriteTxData(void *context, uint8 txByte);
+static void		UartCommsBackendPosix_SetTxInterruptMode(void *context, uint8 mask);
+static void		UartCommsBackendPosix_StartTxIsr(void *context, UartComms_IsrHandler_t handler, void *arg);
+static void		UartCommsBackendPosix_SetRts(void *context, uint8 isReady);
+static uint8	UartCommsBackendPosix_ReadCts(void *context);
+static uint8	UartCommsBackendPosix_SetBaudRate(void *context, uint32 baudRate);
+
+// General functions
+static bool_t 	UartCommsBackendPosix_OpenPty(UartCommsBackendPosix_t *instance);
+static void 	UartCommsBackendPosix_RxFifoPush(UartCommsBackendPosix_t *instance, uint8 rxByte, uint8 status);
+static void 	UartCommsBackendPosix_Transmit(UartCommsBackendPosix_t *instance, UartCommsBackendPosix_t *receiver, uint8 txByte);
+static void 	UartCommsBackendPosix_RaiseInterrupts(UartCommsBackendPosix_t *instance);
+static void 	UartCommsBackendPosix_Clock(UartCommsBackendPosix_t *instance);
+static void 	UartCommsBackendPosix_ReplayStartRecord(UartCommsBackendPosix_t *instance);
+static uint32 	UartCommsBackendPosix_ReplayRead(UartCommsBackendPosix_t *instance, uint8 *rxBytes, uint32 maxNumBytes, portTickType now);
+
+// Tasks
+static void 	UartCommsBackendPosix_EmulatorTask(void *pvParameters);
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+bool_t UartCommsBackendPosix_Init(
+	UartCommsBackendPosix_t *instance,
+	const UartCommsBackendPosix_Config_t *config,
+	UartComms_Backend_t *backend)
+{
+	memset(instance, 0, sizeof(*instance));
+	instance->config = *config;
+	instance->ptyMasterFd = -1;
+	instance->ptySlaveFd = -1;
+	instance->isRtsReady = TRUE;
+	instance->isCtsReady = TRUE;
+
+	// Clamp FIFO depth to what can be emulated
+	if(instance->config.fifoDepth == 0)
+		instance->config.fifoDepth = 1;
+	else if(instance->config.fifoDepth > UART_COMMS_POSIX_MAX_FIFO_DEPTH)
+		instance->config.fifoDepth = UART_COMMS_POSIX_MAX_FIFO_DEPTH;
+
+	if(instance->config.wire == UART_COMMS_POSIX_WIRE_PTY)
+	{
+		if(UartCommsBackendPosix_OpenPty(instance) == FALSE)
+			return FALSE;
+	}
+
+	if(xTaskCreate(	&UartCommsBackendPosix_EmulatorTask,
+					(signed portCHAR *) "UART Emulator",
+					configMINIMAL_STACK_SIZE,
+					instance,
+					instance->config.emulatorTaskPriority,
+					NULL) != pdPASS)
+	{
+		return FALSE;
+	}
+
+	backend->context 		= instance;
+	backend->start 			= &UartCommsBackendPosix_Start;
+	backend->putChar 		= &UartCommsBackendPosix_PutChar;
+	backend->getByte 		= &UartCommsBackendPosix_GetByte;
+	backend->readRxStatus 	= &UartCommsBackendPosix_ReadRxStatus;
+	backend->readTxStatus 	= &UartCommsBackendPosix_ReadTxStatus;
+	backend->sleep 			= &UartCommsBackendPosix_Sleep;
+	backend->wakeup 		= &UartCommsBackendPosix_Wakeup;
+	backend->startRxIsr 	= &UartCommsBackendPosix_StartRxIsr;
+	backend->writeTxData 	= &UartCommsBackendPosix_WriteTxData;
+	backend->setTxInterruptMode = &UartCommsBackendPosix_SetTxInterruptMode;
+	backend->startTxIsr 	= &UartCommsBackendPosix_StartTxIsr;
+	backend->setRts 		= &UartCommsBackendPosix_SetRts;
+	backend->readCts 		= &UartCommsBackendPosix_ReadCts;
+	backend->setBaudRate 	= &UartCommsBackendPosix_SetBaudRate;
+
+	return TRUE;
+}
+
+
+const char* UartCommsBackendPosix_GetPtyName(const UartCommsBackendPosix_t *instance)
+{
+	return instance->ptyName;
+}
+
+
+void UartCommsBackendPosix_SetCts(UartCommsBackendPosix_t *instance, uint8 isReady)
+{
+	instance->isCtsReady = isReady;
+}
+
+
+bool_t UartCommsBackendPosix_Connect(UartCommsBackendPosix_t *instanceA, UartCommsBackendPosix_t *instanceB)
+{
+	if((instanceA->config.wire != UART_COMMS_POSIX_WIRE_PEER)
+		|| (instanceB->config.wire != UART_COMMS_POSIX_WIRE_PEER))
+	{
+		return FALSE;
+	}
+
+	instanceA->peer = instanceB;
+	instanceB->peer = instanceA;
+	return TRUE;
+}
+
+
+void UartCommsBackendPosix_SetWireMaxBaudRate(UartCommsBackendPosix_t *instance, uint32 baudRate)
+{
+	instance->wireMaxBaudRate = baudRate;
+}
+
+
+bool_t UartCommsBackendPosix_StartReplay(
+	UartCommsBackendPosix_t *instance,
+	const char *fileName,
+	UartCommsBackendPosix_ReplaySpeed_t speed)
+{
+	FILE *file = fopen(fileName, "rb");
+	uint8 *data = NULL;
+	long length = -1;
+	uint16 ticksPerSecond = 0;
+	uint8 *oldData;
+
+	if(file == NULL)
+		return FALSE;
+	if((fseek(file, 0, SEEK_END) == 0) && ((length = ftell(file)) >= 0) && (fseek(file, 0, SEEK_SET) == 0))
+	{
+		data = malloc(length + 1);
+		if((data != NULL) && (fread(data, 1, length, file) == (size_t)length))
+			ticksPerSecond = UartCommsTrace_DecodeFileHeader(data, (uint32)length);
+	}
+	fclose(file);
+
+	if(ticksPerSecond == 0)
+	{
+		free(data);
+		return FALSE;
+	}
+
+	// The emulator task reads these every tick
+	taskENTER_CRITICAL();
+	oldData = instance->replayData;
+	instance->replayData = data;
+	instance->replayLength = (uint32)length;
+	instance->replayPos = UART_COMMS_TRACE_FILE_HEADER_SIZE;
+	instance->replayTraceTicks = 0;
+	instance->replayTicksPerSecond = ticksPerSecond;
+	instance->replaySpeed = speed;
+	instance->replayStartTick = xTaskGetTickCount();
+	UartCommsBackendPosix_ReplayStartRecord(instance);
+	taskEXIT_CRITICAL();
+
+	free(oldData);
+	return TRUE;
+}
+
+
+bool_t UartCommsBackendPosix_IsReplayDone(const UartCommsBackendPosix_t *instance)
+{
+	return (instance->replayPos >= instance->replayLength) ? TRUE : FALSE;
+}
+
+//===============================================================================================//
+//==================================== PRIVATE FUNCTIONS ========================================//
+//===============================================================================================//
+
+//===================================== BACKEND FUNCTIONS =======================================//
+
+static void UartCommsBackendPosix_Start(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+
+	taskENTER_CRITICAL();
+	instance->isStarted = TRUE;
+	instance->isAsleep = FALSE;
+	taskEXIT_CRITICAL();
+}
+
+
+static void UartCommsBackendPosix_PutChar(void *context, uint8 txByte)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	UartCommsBackendPosix_Fifo_t *fifo = &instance->txFifo;
+
+	// Like the Cypress API, block until there is room in the FIFO
+	for(;;)
+	{
+		taskENTER_CRITICAL();
+		if(fifo->count < instance->config.fifoDepth)
+		{
+			fifo->data[(fifo->head + fifo->count) % UART_COMMS_POSIX_MAX_FIFO_DEPTH] = txByte;
+			fifo->count++;
+			taskEXIT_CRITICAL();
+			return;
+		}
+		taskEXIT_CRITICAL();
+
+		// FIFO full, wait for the emulator to clock some bytes out
+		vTaskDelay(1);
+	}
+}
+
+
+static uint16 UartCommsBackendPosix_GetByte(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	UartCommsBackendPosix_Fifo_t *fifo = &instance->rxFifo;
+	uint16 byte;
+
+	taskENTER_CRITICAL();
+	if(fifo->count != 0)
+	{
+		byte = ((uint16)fifo->status[fifo->head] << 8) | fifo->data[fifo->head];
+		fifo->head = (fifo->head + 1) % UART_COMMS_POSIX_MAX_FIFO_DEPTH;
+		fifo->count--;
+	}
+	else
+	{
+		byte = 0;
+	}
+	// Error flags are cleared on read, like the hardware
+	byte |= (uint16)instance->pendingRxStatus << 8;
+	instance->pendingRxStatus = 0;
+	taskEXIT_CRITICAL();
+
+	return byte;
+}
+
+
+static uint8 UartCommsBackendPosix_ReadRxStatus(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	uint8 status;
+
+	taskENTER_CRITICAL();
+	status = instance->pendingRxStatus;
+	if(instance->rxFifo.count != 0)
+		status |= UART_COMMS_RX_STS_FIFO_NOTEMPTY;
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+
+static uint8 UartCommsBackendPosix_ReadTxStatus(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	uint8 status = 0;
+
+	taskENTER_CRITICAL();
+	// Bytes leave the shift register in the same clock they leave the FIFO, so
+	// complete and FIFO empty are the same thing in the emulator
+	if(instance->txFifo.count == 0)
+		status |= UART_COMMS_TX_STS_COMPLETE | UART_COMMS_TX_STS_FIFO_EMPTY;
+	if(instance->txFifo.count == instance->config.fifoDepth)
+		status |= UART_COMMS_TX_STS_FIFO_FULL;
+	else
+		status |= UART_COMMS_TX_STS_FIFO_NOT_FULL;
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+
+static void UartCommsBackendPosix_Sleep(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	instance->isAsleep = TRUE;
+}
+
+
+static void UartCommsBackendPosix_Wakeup(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	instance->isAsleep = FALSE;
+}
+
+
+static void UartCommsBackendPosix_StartRxIsr(void *context, UartComms_IsrHandler_t handler, void *arg)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+
+	taskENTER_CRITICAL();
+	instance->rxHandlerArg = arg;
+	instance->rxHandler = handler;
+	taskEXIT_CRITICAL();
+}
+
+static void UartCommsBackendPosix_WriteTxData(void *context, uint8 txByte)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	UartCommsBackendPosix_Fifo_t *fifo = &instance->txFifo;
+
+	// Like the hardware, a write to a full FIFO is lost
+	taskENTER_CRITICAL();
+	if(fifo->count < instance->config.fifoDepth)
+	{
+		fifo->data[(fifo->head + fifo->count) % UART_COMMS_POSIX_MAX_FIFO_DEPTH] = txByte;
+		fifo->count++;
+	}
+	taskEXIT_CRITICAL();
+}
+
+
+static void UartCommsBackendPosix_SetTxInterruptMode(void *context, uint8 mask)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	instance->txInterruptMask = mask;
+}
+
+
+static void UartCommsBackendPosix_StartTxIsr(void *context, UartComms_IsrHandler_t handler, void *arg)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+
+	taskENTER_CRITICAL();
+	instance->txHandlerArg = arg;
+	instance->txHandler = handler;
+	taskEXIT_CRITICAL();
+}
+
+
+static void UartCommsBackendPosix_SetRts(void *context, uint8 isReady)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+	instance->isRtsReady = isReady;
+}
+
+
+static uint8 UartCommsBackendPosix_ReadCts(void *context)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+
+	// RTS is wired to CTS in loopback mode, and to the peer's CTS on a peer wire
+	if(instance->config.wire == UART_COMMS_POSIX_WIRE_LOOPBACK)
+		return instance->isRtsReady;
+	if((instance->config.wire == UART_COMMS_POSIX_WIRE_PEER) && (instance->peer != NULL))
+		return instance->peer->isRtsReady;
+
+	return instance->isCtsReady;
+}
+
+
+static uint8 UartCommsBackendPosix_SetBaudRate(void *context, uint32 baudRate)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)context;
+
+	// Any rate can be emulated exactly
+	if(baudRate == 0)
+		return 0;
+
+	taskENTER_CRITICAL();
+	instance->config.baudRate = baudRate;
+	instance->bitCredit = 0;
+	taskEXIT_CRITICAL();
+
+	return 1;
+}
+
+//===================================== GENERAL FUNCTIONS =======================================//
+
+//! @brief		Opens a pseudo-terminal in raw mode to act as the wire
+//! @returns	TRUE on success, otherwise FALSE
+//! @private
+static bool_t UartCommsBackendPosix_OpenPty(UartCommsBackendPosix_t *instance)
+{
+	struct termios settings;
+	const char *slaveName;
+
+	instance->ptyMasterFd = posix_openpt(O_RDWR | O_NOCTTY);
+	if(instance->ptyMasterFd < 0)
+		return FALSE;
+
+	if((grantpt(instance->ptyMasterFd) != 0) || (unlockpt(instance->ptyMasterFd) != 0))
+		goto error;
+
+	slaveName = ptsname(instance->ptyMasterFd);
+	if(slaveName == NULL)
+		goto error;
+	strncpy(instance->ptyName, slaveName, sizeof(instance->ptyName) - 1);
+
+	// Keep the slave open ourselves so reads on the master don't fail with EIO while no
+	// other program has the pseudo-terminal open. Raw mode stops the line discipline from
+	// echoing or translating bytes.
+	instance->ptySlaveFd = open(instance->ptyName, O_RDWR | O_NOCTTY);
+	if(instance->ptySlaveFd < 0)
+		goto error;
+	if(tcgetattr(instance->ptySlaveFd, &settings) != 0)
+		goto error;
+	cfmakeraw(&settings);
+	if(tcsetattr(instance->ptySlaveFd, TCSANOW, &settings) != 0)
+		goto error;
+
+	// The emulator must never block inside a FreeRTOS task
+	if(fcntl(instance->ptyMasterFd, F_SETFL, fcntl(instance->ptyMasterFd, F_GETFL) | O_NONBLOCK) != 0)
+		goto error;
+
+	return TRUE;
+
+error:
+	if(instance->ptySlaveFd >= 0)
+		close(instance->ptySlaveFd);
+	close(instance->ptyMasterFd);
+	instance->ptyMasterFd = -1;
+	instance->ptySlaveFd = -1;
+	instance->ptyName[0] = '\0';
+	return FALSE;
+}
+
+
+//! @brief		Puts a byte received from the wire into the RX FIFO, flagging an overrun if it is full
+//! @param		status		UART_COMMS_RX_STS_x error flags the byte was received with
+//! @note		Call from within a critical section
+//! @private
+static void UartCommsBackendPosix_RxFifoPush(UartCommsBackendPosix_t *instance, uint8 rxByte, uint8 status)
+{
+	UartCommsBackendPosix_Fifo_t *fifo = &instance->rxFifo;
+	uint8 index;
+
+	if(fifo->count == instance->config.fifoDepth)
+	{
+		// Byte is lost, like on real hardware
+		instance->pendingRxStatus |= UART_COMMS_RX_STS_OVERRUN;
+		return;
+	}
+
+	index = (fifo->head + fifo->count) % UART_COMMS_POSIX_MAX_FIFO_DEPTH;
+	fifo->data[index] = rxByte;
+	fifo->status[index] = status;
+	fifo->count++;
+}
+
+
+//! @brief		Sends a byte down a loopback or peer wire into the receiver's RX FIFO
+//! @details	A byte sent at the wrong rate for the receiver, or faster than the wire allows,
+//!				arrives garbled with a framing error. Nothing arrives while the receiver is
+//!				stopped or asleep.
+//! @note		Call from within a critical section
+//! @private
+static void UartCommsBackendPosix_Transmit(UartCommsBackendPosix_t *instance, UartCommsBackendPosix_t *receiver, uint8 txByte)
+{
+	uint32 txRate = instance->config.baudRate;
+	uint32 rxRate = receiver->config.baudRate;
+	uint32 difference = (txRate > rxRate) ? txRate - rxRate : rxRate - txRate;
+
+	if((receiver->isStarted == FALSE) || (receiver->isAsleep == TRUE))
+		return;
+
+	if(((uint64_t)difference*100 > (uint64_t)rxRate*UART_COMMS_POSIX_BAUD_MISMATCH_PERCENT)
+		|| ((instance->wireMaxBaudRate != 0) && (txRate > instance->wireMaxBaudRate)))
+	{
+		UartCommsBackendPosix_RxFifoPush(receiver, (uint8)~txByte, UART_COMMS_RX_STS_STOP_ERROR);
+		return;
+	}
+
+	UartCommsBackendPosix_RxFifoPush(receiver, txByte, 0);
+}
+
+
+//! @brief		Calls the RX and TX interrupt handlers if their interrupt conditions are true
+//! @details	The emulator task has the highest priority so the handlers run without being
+//!				preempted by any other task, as they would in an ISR.
+//! @private
+static void UartCommsBackendPosix_RaiseInterrupts(UartCommsBackendPosix_t *instance)
+{
+	if((instance->rxFifo.count != 0) && (instance->rxHandler != NULL))
+		instance->rxHandler(instance->rxHandlerArg);
+
+	if((instance->txHandler != NULL)
+		&& ((UartCommsBackendPosix_ReadTxStatus(instance) & instance->txInterruptMask) != 0))
+	{
+		instance->txHandler(instance->txHandlerArg);
+	}
+}
+
+
+//! @brief		Moves bytes between the FIFO's and the wire at the simulated baud rate
+//! @private
+static void UartCommsBackendPosix_Clock(UartCommsBackendPosix_t *instance)
+{
+	uint8 txBytes[UART_COMMS_POSIX_MAX_FIFO_DEPTH*4];
+	uint8 rxBytes[UART_COMMS_POSIX_MAX_FIFO_DEPTH*4];
+	uint32 numTxBytes = 0;
+	uint32 numRxBytes = 0;
+	uint32 numByteTimes;
+	uint32 byteTime;
+	bool_t isReplaying;
+
+	portTickType now = xTaskGetTickCount();
+	uint32 elapsedTicks = (uint32)(now - instance->lastTick);
+	instance->lastTick = now;
+
+	// Nothing moves while the UART is stopped or asleep
+	if((instance->isStarted == FALSE) || (instance->isAsleep == TRUE))
+	{
+		instance->bitCredit = 0;
+		return;
+	}
+
+	instance->bitCredit += (uint32)(((uint64_t)elapsedTicks*instance->config.baudRate)/configTICK_RATE_HZ);
+	if(instance->bitCredit > MAX_BIT_CREDIT)
+		instance->bitCredit = MAX_BIT_CREDIT;
+	numByteTimes = instance->bitCredit/UART_COMMS_POSIX_BITS_PER_BYTE;
+	instance->bitCredit -= numByteTimes*UART_COMMS_POSIX_BITS_PER_BYTE;
+
+	// A trace being played back, or whatever the other end of the pty has sent in the time
+	// that has passed
+	isReplaying = (instance->replayPos < instance->replayLength) ? TRUE : FALSE;
+	if(isReplaying == TRUE)
+	{
+		numRxBytes = UartCommsBackendPosix_ReplayRead(instance, rxBytes, numByteTimes, now);
+	}
+	else if(instance->config.wire == UART_COMMS_POSIX_WIRE_PTY)
+	{
+		ssize_t numBytesRead = read(instance->ptyMasterFd, rxBytes, numByteTimes);
+		if(numBytesRead > 0)
+			numRxBytes = (uint32)numBytesRead;
+	}
+
+	// One byte can leave and one byte can arrive per byte time. In loopback the wire is
+	// the RX FIFO, on a peer wire it is the peer's RX FIFO (which the peer's own emulator
+	// raises the RX interrupt for). Bytes which don't fit in the RX FIFO are lost and
+	// flagged as an overrun, just like a real UART.
+	for(byteTime = 0; byteTime < numByteTimes; byteTime++)
+	{
+		taskENTER_CRITICAL();
+		if(instance->txFifo.count != 0)
+		{
+			UartCommsBackendPosix_Fifo_t *fifo = &instance->txFifo;
+			uint8 txByte = fifo->data[fifo->head];
+			fifo->head = (fifo->head + 1) % UART_COMMS_POSIX_MAX_FIFO_DEPTH;
+			fifo->count--;
+
+			if(instance->config.wire == UART_COMMS_POSIX_WIRE_PTY)
+				txBytes[numTxBytes++] = txByte;
+			else if(instance->config.wire == UART_COMMS_POSIX_WIRE_PEER)
+			{
+				if(instance->peer != NULL)
+					UartCommsBackendPosix_Transmit(instance, instance->peer, txByte);
+			}
+			else if(isReplaying == FALSE)
+				UartCommsBackendPosix_Transmit(instance, instance, txByte);
+		}
+		if(byteTime < numRxBytes)
+			UartCommsBackendPosix_RxFifoPush(instance, rxBytes[byteTime], 0);
+		taskEXIT_CRITICAL();
+
+		UartCommsBackendPosix_RaiseInterrupts(instance);
+	}
+
+	// Interrupts enabled since the last byte time still need raising
+	if(numByteTimes == 0)
+		UartCommsBackendPosix_RaiseInterrupts(instance);
+
+	// Write errors (e.g. nobody reading the pty and its buffer full) look like a
+	// disconnected wire, the bytes are simply lost
+	if(numTxBytes != 0)
+		(void)write(instance->ptyMasterFd, txBytes, numTxBytes);
+}
+
+//! @brief		Adds the tick delta of the record at replayPos to the trace time
+//! @note		Call from within a critical section, or from the emulator task
+//! @private
+static void UartCommsBackendPosix_ReplayStartRecord(UartCommsBackendPosix_t *instance)
+{
+	UartCommsTrace_Record_t record;
+
+	instance->replayRecordOffset = 0;
+	if(UartCommsTrace_ParseRecord(&instance->replayData[instance->replayPos],
+		instance->replayLength - instance->replayPos, &record) != 0)
+	{
+		instance->replayTraceTicks += record.tickDelta;
+	}
+}
+
+
+//! @brief		Takes up to maxNumBytes received bytes, which are due by now, from the trace
+//!				being played back
+//! @details	Sent bytes and gap markers are skipped. A record cut short (the trace was
+//!				dumped part way through a write) ends the playback.
+//! @returns	Number of bytes put in rxBytes
+//! @private
+static uint32 UartCommsBackendPosix_ReplayRead(UartCommsBackendPosix_t *instance, uint8 *rxBytes, uint32 maxNumBytes, portTickType now)
+{
+	uint32 numBytes = 0;
+	uint32 elapsedTicks = (uint32)(now - instance->replayStartTick);
+
+	while((numBytes < maxNumBytes) && (instance->replayPos < instance->replayLength))
+	{
+		UartCommsTrace_Record_t record;
+		uint32 recordSize = UartCommsTrace_ParseRecord(&instance->replayData[instance->replayPos],
+			instance->replayLength - instance->replayPos, &record);
+
+		if(recordSize == 0)
+		{
+			instance->replayPos = instance->replayLength;
+			break;
+		}
+
+		// Not due yet, in the emulator's ticks
+		if((instance->replaySpeed == UART_COMMS_POSIX_REPLAY_REAL_TIME)
+			&& (((uint64_t)instance->replayTraceTicks*configTICK_RATE_HZ)/instance->replayTicksPerSecond > elapsedTicks))
+		{
+			break;
+		}
+
+		if(record.direction == UART_COMMS_TRACE_DIR_RX)
+		{
+			uint32 length = record.numBytes - instance->replayRecordOffset;
+			if(length > maxNumBytes - numBytes)
+				length = maxNumBytes - numBytes;
+
+			memcpy(&rxBytes[numBytes], &record.data[instance->replayRecordOffset], length);
+			numBytes += length;
+			instance->replayRecordOffset += length;
+
+			// Rest of the record in the next byte times
+			if(instance->replayRecordOffset < record.numBytes)
+				break;
+		}
+
+		instance->replayPos += recordSize;
+		UartCommsBackendPosix_ReplayStartRecord(instance);
+	}
+
+	return numBytes;
+}
+
+//======================================== TASK FUNCTIONS =======================================//
+
+//! @brief 		Emulator task, clocks the emulated UART once per tick
+//! @param		*pvParameters Pointer to the UartCommsBackendPosix_t instance
+//! @private
+static void UartCommsBackendPosix_EmulatorTask(void *pvParameters)
+{
+	UartCommsBackendPosix_t *instance = (UartCommsBackendPosix_t*)pvParameters;
+
+	instance->lastTick = xTaskGetTickCount();
+
+	for(;;)
+	{
+		vTaskDelay(1);
+		UartCommsBackendPosix_Clock(instance);
+	}
+}
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #if(UART_COMMS_HOST_BUILD == 1)
+
+// EOF
@@ -0,0 +1,232 @@
+//!
+//! @file 		UartCommsBackendPosix.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		UartComms backend which emulates a UART on the FreeRTOS POSIX/Linux port
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.4.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//! 	<b>Operating System:		</b> FreeRTOS POSIX/Linux port	\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Emulates a UART with a TX and RX FIFO of configurable depth, clocked at a
+//!		simulated baud rate (8N1, 10 bits per byte) by an emulator task which runs once
+//!		per tick at the highest priority. The emulator task also plays the part of the
+//!		RX and TX interrupts, which are raised after every emulated byte time. The "wire"
+//!		is either an in-memory loopback (every byte sent is received again), a
+//!		pseudo-terminal, which another program (e.g. screen or a test script) can open
+//!		with the name returned by UartCommsBackendPosix_GetPtyName(), or another emulated
+//!		UART, joined with UartCommsBackendPosix_Connect() (TX to RX and RTS to CTS both
+//!		ways, like a null modem cable).
+//!
+//!		RTS and CTS are emulated too. In loopback mode RTS is wired to CTS, so a throttled
+//!		receiver stops its own transmitter, as with a loopback plug. A pseudo-terminal has no
+//!		modem lines, so CTS is set from the test with UartCommsBackendPosix_SetCts().
+//!
+//!		The baud rate can be changed while running (UartComms_Backend_t.setBaudRate). On a
+//!		loopback or peer wire, a byte sent at a rate more than UART_COMMS_POSIX_BAUD_MISMATCH_PERCENT
+//!		away from the receiver's rate, or faster than the limit set with
+//!		UartCommsBackendPosix_SetWireMaxBaudRate() (a long cable, a slow level shifter), arrives
+//!		garbled with a framing error, as it would on a real wire. This is for testing baud
+//!		rate negotiation. A pseudo-terminal has no baud rate, so neither applies to it.
+//!
+//!		A trace file saved with UartComms_DumpTrace() can be played back into the RX pin with
+//!		UartCommsBackendPosix_StartReplay(), either at the times it was recorded or back to
+//!		back at the simulated baud rate, so captured traffic can be used as a repeatable
+//!		benchmark. Only received bytes are played back. While a trace is playing it is all
+//!		the RX pin gets, in loopback mode sent bytes are thrown away.
+//!
+//!		Usage:
+//!			static UartCommsBackendPosix_t uartEmulator;
+//!			static UartComms_Backend_t uartBackend;
+//!			UartCommsBackendPosix_Config_t config = { UART_COMMS_POSIX_WIRE_LOOPBACK, 115200, 4, configMAX_PRIORITIES - 1 };
+//!			UartCommsBackendPosix_Init(&uartEmulator, &config, &uartBackend);
+//!			UartComms_SetBackend(&uartCommsPort, &uartBackend);
+//!			UartComms_Start(&uartCommsPort, ...);
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added TX interrupt emulation. Interrupts are raised every byte time
+//!				rather than once per tick.
+//!			v1.2.0 -> Added RTS/CTS emulation and UartCommsBackendPosix_SetCts().
+//!			v1.3.0 -> Added trace replay (UartCommsBackendPosix_StartReplay()).
+//!			v1.4.0 -> Added setBaudRate(), the peer wire (UartCommsBackendPosix_Connect()) and
+//!				garbling of bytes sent at the wrong rate or faster than the wire allows.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_BACKEND_POSIX_H
+#define UART_COMMS_BACKEND_POSIX_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! Maximum emulated hardware FIFO depth (the PSoC UART component supports 4 without a
+//! software buffer)
+#define UART_COMMS_POSIX_MAX_FIFO_DEPTH			(64)
+
+//! Number of bits clocked per byte (start + 8 data + stop)
+#define UART_COMMS_POSIX_BITS_PER_BYTE			(10)
+
+//! Most the sender's and receiver's baud rates can differ by before bytes are garbled. With
+//! 16x oversampling and 10 bits per byte, the stop bit is sampled in the wrong bit at about 5%.
+#define UART_COMMS_POSIX_BAUD_MISMATCH_PERCENT	(4)
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! What is connected to the emulated TX and RX pins
+typedef enum
+{
+	UART_COMMS_POSIX_WIRE_LOOPBACK,		//!< TX is looped back to RX
+	UART_COMMS_POSIX_WIRE_PTY,			//!< TX and RX are connected to a pseudo-terminal
+	UART_COMMS_POSIX_WIRE_PEER			//!< TX and RX are connected to another emulated UART, see UartCommsBackendPosix_Connect()
+} UartCommsBackendPosix_Wire_t;
+
+//! How UartCommsBackendPosix_StartReplay() paces a trace
+typedef enum
+{
+	UART_COMMS_POSIX_REPLAY_REAL_TIME,	//!< Each record arrives at the time it was recorded, relative to the start
+	UART_COMMS_POSIX_REPLAY_MAX_SPEED	//!< Records arrive back to back, as fast as the simulated baud rate allows
+} UartCommsBackendPosix_ReplaySpeed_t;
+
+//! Configuration for an emulated UART
+typedef struct
+{
+	UartCommsBackendPosix_Wire_t wire;		//!< What the UART is connected to
+	uint32 baudRate;						//!< Simulated baud rate
+	uint8 fifoDepth;						//!< Depth of the TX and RX FIFO's, 1 to UART_COMMS_POSIX_MAX_FIFO_DEPTH
+	uint8 emulatorTaskPriority;				//!< Priority of the emulator task, should be the highest in the system
+} UartCommsBackendPosix_Config_t;
+
+//! @brief		Emulated FIFO
+//! @private
+typedef struct
+{
+	uint8 data[UART_COMMS_POSIX_MAX_FIFO_DEPTH];
+	uint8 status[UART_COMMS_POSIX_MAX_FIFO_DEPTH];
+	uint8 head;
+	uint8 count;
+} UartCommsBackendPosix_Fifo_t;
+
+//! @brief		State of one emulated UART. Allocate statically and pass to UartCommsBackendPosix_Init().
+//! @details	All members are private.
+typedef struct UartCommsBackendPosix
+{
+	UartCommsBackendPosix_Config_t config;
+	UartCommsBackendPosix_Fifo_t txFifo;
+	UartCommsBackendPosix_Fifo_t rxFifo;
+	uint8 pendingRxStatus;					//!< Error flags to attach to the next byte put into the RX FIFO
+	uint8 isStarted;
+	uint8 isAsleep;
+	uint8 isRtsReady;						//!< Level last driven on RTS
+	uint8 isCtsReady;						//!< Level of CTS in pseudo-terminal mode
+	struct UartCommsBackendPosix *peer;		//!< Other end of a peer wire, NULL if not connected
+	uint32 wireMaxBaudRate;					//!< Fastest rate the wire carries, 0 for no limit
+	uint32 bitCredit;						//!< Bit times available to the emulator
+	uint32 lastTick;
+	int ptyMasterFd;
+	int ptySlaveFd;
+	char ptyName[64];
+	UartComms_IsrHandler_t rxHandler;
+	void *rxHandlerArg;
+	uint8 txInterruptMask;					//!< UART_COMMS_TX_STS_x flags which raise the TX interrupt
+	UartComms_IsrHandler_t txHandler;
+	void *txHandlerArg;
+	uint8 *replayData;						//!< Trace records being played back, NULL if none
+	uint32 replayLength;					//!< Number of bytes in replayData
+	volatile uint32 replayPos;				//!< Offset of the record being played back
+	uint32 replayRecordOffset;				//!< Data bytes of that record already played back
+	uint32 replayTraceTicks;				//!< Trace time of that record, in the trace's ticks
+	uint16 replayTicksPerSecond;			//!< Tick rate of the trace
+	UartCommsBackendPosix_ReplaySpeed_t replaySpeed;
+	uint32 replayStartTick;
+} UartCommsBackendPosix_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Initialises an emulated UART and fills in a backend table for it
+//! @details	Opens the pseudo-terminal (if requested) and creates the emulator task.
+//! @param		instance	Emulator state, must remain valid for the life of the program
+//! @param		config		Configuration, copied
+//! @param		backend		Backend table to fill in, pass to UartComms_SetBackend()
+//! @returns	TRUE on success, FALSE if the pseudo-terminal or emulator task could not be created
+//! @note		Call from main() before starting the scheduler
+//! @public
+bool_t 		UartCommsBackendPosix_Init(
+				UartCommsBackendPosix_t *instance,
+				const UartCommsBackendPosix_Config_t *config,
+				UartComms_Backend_t *backend);
+
+//! @brief		Returns the name of the slave side of the pseudo-terminal (e.g. "/dev/pts/3")
+//! @returns	Name of the pseudo-terminal, or an empty string in loopback mode
+//! @public
+const char* UartCommsBackendPosix_GetPtyName(const UartCommsBackendPosix_t *instance);
+
+//! @brief		Sets the CTS input, as if driven by the other end of the pseudo-terminal
+//! @details	Has no effect in loopback mode, where CTS follows RTS.
+//! @public
+void 		UartCommsBackendPosix_SetCts(UartCommsBackendPosix_t *instance, uint8 isReady);
+
+//! @brief		Connects two emulated UARTs to each other, TX to RX and RTS to CTS both ways
+//! @details	Until connected, bytes sent on a peer wire are lost.
+//! @returns	TRUE if connected, FALSE if either wasn't initialised with UART_COMMS_POSIX_WIRE_PEER
+//! @note		Call from main() before starting the scheduler
+//! @public
+bool_t 		UartCommsBackendPosix_Connect(UartCommsBackendPosix_t *instanceA, UartCommsBackendPosix_t *instanceB);
+
+//! @brief		Sets the fastest baud rate the wire carries, faster bytes arrive garbled
+//! @details	On a peer wire, set the same limit on both ends.
+//! @param		baudRate	Fastest rate, or 0 for no limit (the default)
+//! @public
+void 		UartCommsBackendPosix_SetWireMaxBaudRate(UartCommsBackendPosix_t *instance, uint32 baudRate);
+
+//! @brief		Plays the received bytes of a trace file back into the RX pin
+//! @details	Replaces any trace already playing. As with any received bytes, nothing arrives
+//!				while the UART is stopped or asleep.
+//! @param		fileName	Trace file, written by UartComms_DumpTrace()
+//! @param		speed		Whether to keep the recorded timing, or play as fast as possible
+//! @returns	TRUE if playback started, FALSE if the file couldn't be read or isn't a trace
+//! @note		Call from a task, or from main() before starting the scheduler
+//! @public
+bool_t 		UartCommsBackendPosix_StartReplay(
+				UartCommsBackendPosix_t *instance,
+				const char *fileName,
+				UartCommsBackendPosix_ReplaySpeed_t speed);
+
+//! @brief		Returns TRUE once every byte of the trace has been put into the RX FIFO (or if no
+//!				trace was started)
+//! @public
+bool_t 		UartCommsBackendPosix_IsReplayDone(const UartCommsBackendPosix_t *instance);
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_BACKEND_POSIX_H
+
+// EOF
@@ -0,0 +1,52 @@
+//!
+//! @file 		UartCommsBackendPsoc.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsBackendPsoc.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsBackendPsoc.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// User includes
+#include "UartCommsBackendPsoc.h"
+
+#if(UART_COMMS_HOST_BUILD == 0)
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//============================= PRIVATE VARIABLES/STRUCTURES ====================================//
+//===============================================================================================//
+
+// Backend for the comms UART
+UART_COMMS_BACKEND_PSOC_DEFINE(UartCpComms, IsrCpUartCommsRx, IsrCpUartCommsTx)
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #if(UART_COMMS_HOST_BUILD == 0)
+
+// EOF
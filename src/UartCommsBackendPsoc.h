@@ -0,0 +1,198 @@
+//!
+//! @file 		UartCommsBackendPsoc.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		UartComms backend for the Cypress PSoC UART component
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.3.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		PSoC Creator generates a separate API for every UART component instance
+//!		(UartCpComms_PutChar(), UartDebug_PutChar(), ...). UART_COMMS_BACKEND_PSOC_DEFINE()
+//!		generates the UartComms_Backend_t wrappers for one instance. The backend for
+//!		the UartCpComms/IsrCpUartCommsRx/IsrCpUartCommsTx instances is defined in
+//!		UartCommsBackendPsoc.c.
+//!
+//!		The UART component must be configured with a TX buffer size of 4 (hardware FIFO
+//!		only), with its TX interrupt output connected to the TX ISR component, since
+//!		UartComms refills the FIFO from its own ISR.
+//!
+//!		For RTS/CTS flow control, use UART_COMMS_BACKEND_PSOC_DEFINE_FLOW_CONTROL() with
+//!		two pin components (RTS an output, CTS an input). Both lines are active low, as on
+//!		an RS-232 port. Leave hardware flow control off in the UART component, UartComms
+//!		drives RTS from the RX buffer level and stops the TX ISR when CTS goes high.
+//!
+//!		For baud rate negotiation, use UART_COMMS_BACKEND_PSOC_DEFINE_BAUD_RATE() with the
+//!		UART's clock component (e.g. UartCpComms_IntClock, the UART's internal clock). The
+//!		rate is changed by reprogramming the clock's divider from the bus clock, so only
+//!		rates which BCLK__BUS_CLK__HZ divides down to (within
+//!		UART_COMMS_BAUD_RATE_TOLERANCE_PERCENT) can be set.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added TX interrupt support, UART_COMMS_BACKEND_PSOC_DEFINE() takes
+//!				the TX ISR component name.
+//!			v1.2.0 -> Added UART_COMMS_BACKEND_PSOC_DEFINE_FLOW_CONTROL() for RTS/CTS pins.
+//!			v1.3.0 -> Added UART_COMMS_BACKEND_PSOC_DEFINE_BAUD_RATE(), which changes the
+//!				baud rate through the UART's clock divider.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_BACKEND_PSOC_H
+#define UART_COMMS_BACKEND_PSOC_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! @brief		Declares the backend for the UART component instance uartName
+#define UART_COMMS_BACKEND_PSOC_DECLARE(uartName) \
+	extern const UartComms_Backend_t UartCommsBackendPsoc_##uartName;
+
+//! @brief		Defines the backend UartCommsBackendPsoc_<uartName> for a UART component instance
+//! @param		uartName	Instance name of the UART component (e.g. UartCpComms)
+//! @param		rxIsrName	Instance name of the ISR component connected to the UART RX interrupt
+//! @param		txIsrName	Instance name of the ISR component connected to the UART TX interrupt
+//! @note		Use once per UART, at file scope, in a .c file
+#define UART_COMMS_BACKEND_PSOC_DEFINE(uartName, rxIsrName, txIsrName) \
+	UART_COMMS_BACKEND_PSOC_FUNCTIONS(uartName, rxIsrName, txIsrName) \
+	UART_COMMS_BACKEND_PSOC_TABLE(uartName, 0, 0, 0)
+
+//! @brief		Same as UART_COMMS_BACKEND_PSOC_DEFINE(), with RTS and CTS pins for hardware
+//!				flow control
+//! @param		rtsPinName	Instance name of the (output) pin component driving RTS
+//! @param		ctsPinName	Instance name of the (input) pin component reading CTS
+//! @note		Use once per UART, at file scope, in a .c file
+#define UART_COMMS_BACKEND_PSOC_DEFINE_FLOW_CONTROL(uartName, rxIsrName, txIsrName, rtsPinName, ctsPinName) \
+	UART_COMMS_BACKEND_PSOC_FUNCTIONS(uartName, rxIsrName, txIsrName) \
+	static void uartName##_BackendSetRts(void *context, uint8 isReady) \
+	{ (void)context; rtsPinName##_Write(isReady ? 0 : 1); } \
+	static uint8 uartName##_BackendReadCts(void *context) \
+	{ (void)context; return (ctsPinName##_Read() == 0); } \
+	UART_COMMS_BACKEND_PSOC_TABLE(uartName, uartName##_BackendSetRts, uartName##_BackendReadCts, 0)
+
+//! @brief		Same as UART_COMMS_BACKEND_PSOC_DEFINE(), with a baud rate which can be changed
+//! @param		clockName	Instance name of the clock component driving the UART, at
+//!							uartName##_OVER_SAMPLE_COUNT times the baud rate
+//! @note		Use once per UART, at file scope, in a .c file
+#define UART_COMMS_BACKEND_PSOC_DEFINE_BAUD_RATE(uartName, rxIsrName, txIsrName, clockName) \
+	UART_COMMS_BACKEND_PSOC_FUNCTIONS(uartName, rxIsrName, txIsrName) \
+	static uint8 uartName##_BackendSetBaudRate(void *context, uint32 baudRate) \
+	{ \
+		uint32 clockHz = baudRate*uartName##_OVER_SAMPLE_COUNT; \
+		uint32 divider = (clockHz == 0) ? 0 : (BCLK__BUS_CLK__HZ + clockHz/2)/clockHz; \
+		uint32 actualRate; \
+		(void)context; \
+		if((divider == 0) || (divider > 0xFFFF)) \
+			return 0; \
+		actualRate = BCLK__BUS_CLK__HZ/(divider*uartName##_OVER_SAMPLE_COUNT); \
+		if(((actualRate > baudRate) ? actualRate - baudRate : baudRate - actualRate)*100 \
+			> baudRate*UART_COMMS_BAUD_RATE_TOLERANCE_PERCENT) \
+			return 0; \
+		clockName##_SetDividerValue((uint16)divider); \
+		return 1; \
+	} \
+	UART_COMMS_BACKEND_PSOC_TABLE(uartName, 0, 0, uartName##_BackendSetBaudRate)
+
+//! @brief		Wrapper functions shared by the DEFINE macros
+//! @private
+#define UART_COMMS_BACKEND_PSOC_FUNCTIONS(uartName, rxIsrName, txIsrName) \
+	static UartComms_IsrHandler_t uartName##_backendRxHandler = 0; \
+	static void *uartName##_backendRxArg = 0; \
+	static UartComms_IsrHandler_t uartName##_backendTxHandler = 0; \
+	static void *uartName##_backendTxArg = 0; \
+	static void uartName##_BackendStart(void *context) \
+	{ (void)context; uartName##_Start(); } \
+	static void uartName##_BackendPutChar(void *context, uint8 txByte) \
+	{ (void)context; uartName##_PutChar(txByte); } \
+	static uint16 uartName##_BackendGetByte(void *context) \
+	{ (void)context; return uartName##_GetByte(); } \
+	static uint8 uartName##_BackendReadRxStatus(void *context) \
+	{ (void)context; return uartName##_ReadRxStatus(); } \
+	static uint8 uartName##_BackendReadTxStatus(void *context) \
+	{ (void)context; return uartName##_ReadTxStatus(); } \
+	static void uartName##_BackendSleep(void *context) \
+	{ (void)context; uartName##_Sleep(); } \
+	static void uartName##_BackendWakeup(void *context) \
+	{ (void)context; uartName##_Wakeup(); } \
+	static CY_ISR(uartName##_BackendRxIsr) \
+	{ uartName##_backendRxHandler(uartName##_backendRxArg); } \
+	static void uartName##_BackendStartRxIsr(void *context, UartComms_IsrHandler_t handler, void *arg) \
+	{ \
+		(void)context; \
+		uartName##_backendRxHandler = handler; \
+		uartName##_backendRxArg = arg; \
+		rxIsrName##_StartEx(uartName##_BackendRxIsr); \
+	} \
+	static void uartName##_BackendWriteTxData(void *context, uint8 txByte) \
+	{ (void)context; uartName##_WriteTxData(txByte); } \
+	static void uartName##_BackendSetTxInterruptMode(void *context, uint8 mask) \
+	{ (void)context; uartName##_SetTxInterruptMode(mask); } \
+	static CY_ISR(uartName##_BackendTxIsr) \
+	{ uartName##_backendTxHandler(uartName##_backendTxArg); } \
+	static void uartName##_BackendStartTxIsr(void *context, UartComms_IsrHandler_t handler, void *arg) \
+	{ \
+		(void)context; \
+		uartName##_backendTxHandler = handler; \
+		uartName##_backendTxArg = arg; \
+		txIsrName##_StartEx(uartName##_BackendTxIsr); \
+	}
+
+//! @brief		Backend table shared by the DEFINE macros
+//! @private
+#define UART_COMMS_BACKEND_PSOC_TABLE(uartName, setRtsFunction, readCtsFunction, setBaudRateFunction) \
+	const UartComms_Backend_t UartCommsBackendPsoc_##uartName = \
+	{ \
+		.context 		= 0, \
+		.start 			= uartName##_BackendStart, \
+		.putChar 		= uartName##_BackendPutChar, \
+		.getByte 		= uartName##_BackendGetByte, \
+		.readRxStatus 	= uartName##_BackendReadRxStatus, \
+		.readTxStatus 	= uartName##_BackendReadTxStatus, \
+		.sleep 			= uartName##_BackendSleep, \
+		.wakeup 		= uartName##_BackendWakeup, \
+		.startRxIsr 	= uartName##_BackendStartRxIsr, \
+		.writeTxData 	= uartName##_BackendWriteTxData, \
+		.setTxInterruptMode = uartName##_BackendSetTxInterruptMode, \
+		.startTxIsr 	= uartName##_BackendStartTxIsr, \
+		.setRts 		= setRtsFunction, \
+		.readCts 		= readCtsFunction, \
+		.setBaudRate 	= setBaudRateFunction \
+	};
+
+//===============================================================================================//
+//=================================== PUBLIC VARIABLES/STRUCTURES ===============================//
+//===============================================================================================//
+
+//! Backend for the UartCpComms UART component (defined in UartCommsBackendPsoc.c)
+UART_COMMS_BACKEND_PSOC_DECLARE(UartCpComms)
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_BACKEND_PSOC_H
+
+// EOF
@@ -0,0 +1,144 @@
+//!
+//! @file 		UartCommsFrame.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		COBS framing with a CRC-16, used by the UartComms frame layer
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		A frame on the wire is the payload followed by its CRC-16/CCITT-FALSE (poly 0x1021,
+//!		init 0xFFFF, most significant byte first), COBS encoded, followed by a 0x00
+//!		delimiter. COBS removes every 0x00 from the encoded bytes, so a receiver can always
+//!		resynchronise on the next delimiter, and adds at most one byte per 254.
+//!
+//!		The decoder is fed one byte at a time (from the RX ISR), in constant time per byte.
+//!		The CRC is updated as bytes are decoded, so checking it at the delimiter is free.
+//!		A frame which overflows the decoder buffer, is cut short or fails the CRC is
+//!		reported as an error and dropped.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added UartCommsFrame_EncodeWithHeader(), used for channel IDs.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_FRAME_H
+#define UART_COMMS_FRAME_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! Number of CRC bytes after the payload
+#define UART_COMMS_FRAME_CRC_SIZE				(2)
+
+//! Byte which ends every frame
+#define UART_COMMS_FRAME_DELIMITER				(0x00)
+
+//! @brief		Largest number of bytes a payload of numBytes bytes can take on the wire,
+//!				including the CRC, COBS overhead and delimiter
+#define UART_COMMS_FRAME_MAX_ENCODED_SIZE(numBytes) \
+	((numBytes) + UART_COMMS_FRAME_CRC_SIZE + ((numBytes) + UART_COMMS_FRAME_CRC_SIZE)/254 + 2)
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! What UartCommsFrameDecoder_Feed() found
+typedef enum
+{
+	UART_COMMS_FRAME_NONE,				//!< Nothing yet, keep feeding
+	UART_COMMS_FRAME_COMPLETE,			//!< A frame passed the CRC, see UartCommsFrameDecoder_t.length
+	UART_COMMS_FRAME_ERROR				//!< A frame was dropped (too long, cut short or bad CRC)
+} UartCommsFrame_Result_t;
+
+//! An incremental frame decoder. Members are private, use the functions below.
+typedef struct
+{
+	uint8 *buffer;						//!< Decoded bytes (payload, then CRC)
+	uint32 size;						//!< Size of buffer
+	uint32 length;						//!< Number of bytes in buffer
+	uint16 crc;							//!< CRC of the bytes in buffer
+	uint8 code;							//!< COBS code of the current block, 0 at the start of a frame
+	uint8 numBytesLeft;					//!< Bytes left in the current block
+	uint8 isDiscarding;					//!< 1 if skipping to the next delimiter
+} UartCommsFrameDecoder_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Updates a CRC-16/CCITT-FALSE with numBytes bytes
+//! @details	Table-driven, one table lookup per byte. Start with a crc of 0xFFFF.
+//! @public
+uint16 		UartCommsFrame_Crc16(uint16 crc, const uint8 *data, uint32 numBytes);
+
+//! @brief		Encodes a payload into a frame (CRC, COBS and delimiter)
+//! @param		encoded		Where to write the frame, at least UART_COMMS_FRAME_MAX_ENCODED_SIZE(numBytes)
+//!							bytes. NULL to only work out the encoded length.
+//! @returns	Number of bytes in the frame, including the delimiter
+//! @public
+uint32 		UartCommsFrame_Encode(const uint8 *payload, uint32 numBytes, uint8 *encoded);
+
+//! @brief		Same as UartCommsFrame_Encode(), with header bytes (e.g. a channel ID) in front of
+//!				the payload, without having to copy them together first
+//! @param		encoded		At least UART_COMMS_FRAME_MAX_ENCODED_SIZE(headerLength + numBytes) bytes,
+//!							or NULL to only work out the encoded length
+//! @returns	Number of bytes in the frame, including the delimiter
+//! @public
+uint32 		UartCommsFrame_EncodeWithHeader(
+				const uint8 *header,
+				uint32 headerLength,
+				const uint8 *payload,
+				uint32 numBytes,
+				uint8 *encoded);
+
+//! @brief		Initialises a decoder, which then waits for the start of a frame
+//! @param		buffer		Where decoded frames are built, must hold the payload and CRC of the
+//!							longest frame to be received
+//! @param		size		Size of buffer
+//! @public
+void 		UartCommsFrameDecoder_Init(UartCommsFrameDecoder_t *decoder, uint8 *buffer, uint32 size);
+
+//! @brief		Decodes one received byte
+//! @returns	UART_COMMS_FRAME_COMPLETE when byte ends a good frame, whose payload is then the
+//!				first UartCommsFrameDecoder_t.length bytes of the buffer (until the next call).
+//! @note		Constant time, safe to call from an ISR
+//! @public
+UartCommsFrame_Result_t UartCommsFrameDecoder_Feed(UartCommsFrameDecoder_t *decoder, uint8 byte);
+
+//! @brief		Drops the frame being decoded, and skips to the next delimiter
+//! @details	Use when a byte was lost or corrupted on the wire.
+//! @public
+void 		UartCommsFrameDecoder_Abort(UartCommsFrameDecoder_t *decoder);
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_FRAME_H
+
+// EOF
@@ -0,0 +1,253 @@
+//!
+//! @file 		UartCommsLog.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsLog.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.1						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsLog.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <string.h>
+
+// User includes
+#include "UartCommsLog.h"
+
+#if(UART_COMMS_HOST_BUILD == 1)
+	// Only UartCommsLog_Format() uses it
+	#include <stdio.h>
+#endif
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Longest conversion spec UartCommsLog_Format() copies, e.g. "%-+08.3f"
+#define MAX_SPEC_LENGTH							(16)
+
+//===============================================================================================//
+//================================== PRIVATE FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+static void UartCommsLog_PutWord(uint8 *data, uint32 word);
+static uint32 UartCommsLog_GetWord(const uint8 *data);
+#if(UART_COMMS_HOST_BUILD == 1)
+	static uint32 UartCommsLog_Append(char *text, uint32 maxLength, uint32 length, const char *data, uint32 numBytes);
+#endif
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+uint32 UartCommsLog_EncodeRecord(
+	uint8 *record,
+	uint16 formatId,
+	uint32 time,
+	const uint32 *args,
+	uint32 numArgs)
+{
+	uint32 i;
+
+	record[0] = (uint8)formatId;
+	record[1] = (uint8)(formatId >> 8);
+	UartCommsLog_PutWord(&record[2], time);
+	for(i = 0; i < numArgs; i++)
+		UartCommsLog_PutWord(&record[UART_COMMS_LOG_RECORD_HEADER_SIZE + 4*i], args[i]);
+
+	return UART_COMMS_LOG_RECORD_SIZE(numArgs);
+}
+
+
+uint32 UartCommsLog_ParseRecord(const uint8 *data, uint32 numBytes, UartCommsLog_Record_t *record)
+{
+	uint32 i;
+
+	if((numBytes < UART_COMMS_LOG_RECORD_HEADER_SIZE)
+		|| (numBytes > UART_COMMS_LOG_RECORD_SIZE(UART_COMMS_LOG_MAX_ARGS))
+		|| (((numBytes - UART_COMMS_LOG_RECORD_HEADER_SIZE) % 4) != 0))
+		return 0;
+
+	record->formatId = (uint16)(data[0] | (data[1] << 8));
+	record->time = UartCommsLog_GetWord(&data[2]);
+	record->numArgs = (uint8)((numBytes - UART_COMMS_LOG_RECORD_HEADER_SIZE)/4);
+	for(i = 0; i < record->numArgs; i++)
+		record->args[i] = UartCommsLog_GetWord(&data[UART_COMMS_LOG_RECORD_HEADER_SIZE + 4*i]);
+
+	return numBytes;
+}
+
+
+uint32 UartCommsLog_FloatToWord(float value)
+{
+	uint32 word;
+
+	memcpy(&word, &value, sizeof(word));
+	return word;
+}
+
+
+#if(UART_COMMS_HOST_BUILD == 1)
+	uint32 UartCommsLog_Format(
+		char *text,
+		uint32 maxLength,
+		const char *format,
+		const uint32 *args,
+		uint32 numArgs)
+	{
+		uint32 length = 0;
+		uint32 argIndex = 0;
+
+		if(maxLength == 0)
+			return 0;
+
+		while(*format != '\0')
+		{
+			char spec[MAX_SPEC_LENGTH + 2];
+			char converted[64];
+			const char *start = format;
+			uint32 specLength = 0;
+			int numConverted = -1;
+
+			if(*format != '%')
+			{
+				// Copy everything up to the next conversion in one go
+				while((*format != '\0') && (*format != '%'))
+					format++;
+				length = UartCommsLog_Append(text, maxLength, length, start, format - start);
+				continue;
+			}
+
+			// Flags, width and precision are kept, length modifiers are dropped
+			spec[specLength++] = *format++;
+			while((*format != '\0') && (strchr("-+ #0123456789.", *format) != NULL) && (specLength < MAX_SPEC_LENGTH))
+				spec[specLength++] = *format++;
+			while((*format != '\0') && (strchr("hlLqjzt", *format) != NULL))
+				format++;
+			if(*format == '\0')
+			{
+				length = UartCommsLog_Append(text, maxLength, length, start, format - start);
+				break;
+			}
+			spec[specLength++] = *format;
+			spec[specLength] = '\0';
+
+			if(*format == '%')
+				numConverted = snprintf(converted, sizeof(converted), "%%");
+			else if(argIndex < numArgs)
+			{
+				uint32 word = args[argIndex];
+
+				switch(*format)
+				{
+					case 'd':
+					case 'i':
+					case 'c':
+						numConverted = snprintf(converted, sizeof(converted), spec, (int)(int32)word);
+						break;
+					case 'u':
+					case 'x':
+					case 'X':
+					case 'o':
+						numConverted = snprintf(converted, sizeof(converted), spec, (unsigned int)word);
+						break;
+					case 'e':
+					case 'E':
+					case 'f':
+					case 'F':
+					case 'g':
+					case 'G':
+					{
+						float value;
+						memcpy(&value, &word, sizeof(value));
+						numConverted = snprintf(converted, sizeof(converted), spec, (double)value);
+						break;
+					}
+					default:
+						break;
+				}
+				if(numConverted >= 0)
+					argIndex++;
+			}
+			format++;
+
+			if(numConverted < 0)
+				// Not something which can be formatted, print it as it is
+				length = UartCommsLog_Append(text, maxLength, length, start, format - start);
+			else
+			{
+				if((uint32)numConverted >= sizeof(converted))
+					numConverted = sizeof(converted) - 1;
+				length = UartCommsLog_Append(text, maxLength, length, converted, (uint32)numConverted);
+			}
+		}
+
+		text[length] = '\0';
+		return length;
+	}
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE FUNCTIONS ========================================//
+//===============================================================================================//
+
+//! @brief		Writes a word, least significant byte first
+//! @private
+static void UartCommsLog_PutWord(uint8 *data, uint32 word)
+{
+	data[0] = (uint8)word;
+	data[1] = (uint8)(word >> 8);
+	data[2] = (uint8)(word >> 16);
+	data[3] = (uint8)(word >> 24);
+}
+
+
+//! @brief		Reads a word, least significant byte first
+//! @private
+static uint32 UartCommsLog_GetWord(const uint8 *data)
+{
+	return (uint32)data[0] | ((uint32)data[1] << 8) | ((uint32)data[2] << 16) | ((uint32)data[3] << 24);
+}
+
+
+#if(UART_COMMS_HOST_BUILD == 1)
+	//! @brief		Appends as much of data to text as fits (leaving room for the null)
+	//! @returns	New length of text
+	//! @private
+	static uint32 UartCommsLog_Append(char *text, uint32 maxLength, uint32 length, const char *data, uint32 numBytes)
+	{
+		if(numBytes > maxLength - 1 - length)
+			numBytes = maxLength - 1 - length;
+		memcpy(&text[length], data, numBytes);
+		return length + numBytes;
+	}
+#endif
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+// EOF
@@ -0,0 +1,150 @@
+//!
+//! @file 		UartCommsLog.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Binary log records, which carry a format ID and raw arguments instead of text
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.1						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Format strings live in a table file (configUART_COMMS_LOG_FORMATS), one line per format:
+//!			UART_COMMS_LOG_FORMAT(LOG_FAN_SPEED, "Fan %u at %u rpm\r\n")
+//!		The target only includes the table to number the formats (UartCommsLog_FormatId_t),
+//!		so the strings never take flash. A host includes the same file to build a table of
+//!		the strings, in the same order, and formats records with UartCommsLog_Format().
+//!		Change the table and the target and host must both be rebuilt.
+//!
+//!		A record is, least significant byte first:
+//!			byte 0, 1 = format ID
+//!			byte 2 to 5 = tick count when it was logged
+//!			then 4 bytes per argument, 0 to UART_COMMS_LOG_MAX_ARGS of them
+//!		The number of arguments is taken from the length of the record, which is sent as
+//!		a frame (UartCommsFrame.h), so it is never sent on its own.
+//!
+//!		Every argument is a 32-bit word. Integers (and chars) are sent as they are, floats
+//!		with UartCommsLog_FloatToWord(). Strings can't be logged, as only the pointer would
+//!		be sent.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.0.1 -> UartCommsLog_Format() is only compiled for hosts, so target builds
+//!				never link snprintf().
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_LOG_H
+#define UART_COMMS_LOG_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+#ifndef configUART_COMMS_LOG_FORMATS
+	//! Table file of log formats (see above)
+	#define configUART_COMMS_LOG_FORMATS		"UartCommsLogFormats.def"
+#endif
+
+//! Most arguments in one record
+#define UART_COMMS_LOG_MAX_ARGS					(8)
+
+//! Number of bytes in a record before its arguments
+#define UART_COMMS_LOG_RECORD_HEADER_SIZE		(6)
+
+//! Number of bytes in a record with numArgs arguments
+#define UART_COMMS_LOG_RECORD_SIZE(numArgs)		(UART_COMMS_LOG_RECORD_HEADER_SIZE + 4*(numArgs))
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! @brief		IDs of the formats in configUART_COMMS_LOG_FORMATS, in the order they are listed
+typedef enum
+{
+	#define UART_COMMS_LOG_FORMAT(id, format)	id,
+	#include configUART_COMMS_LOG_FORMATS
+	#undef UART_COMMS_LOG_FORMAT
+	UART_COMMS_LOG_NUM_FORMATS
+} UartCommsLog_FormatId_t;
+
+//! One record, as parsed by UartCommsLog_ParseRecord()
+typedef struct
+{
+	uint16 formatId;					//!< Format ID
+	uint32 time;						//!< Tick count when it was logged
+	uint8 numArgs;						//!< Number of arguments
+	uint32 args[UART_COMMS_LOG_MAX_ARGS];	//!< Arguments
+} UartCommsLog_Record_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Encodes a record
+//! @param		record		UART_COMMS_LOG_RECORD_SIZE(numArgs) bytes
+//! @param		numArgs		Up to UART_COMMS_LOG_MAX_ARGS
+//! @returns	Number of bytes written into record
+//! @public
+uint32 		UartCommsLog_EncodeRecord(
+				uint8 *record,
+				uint16 formatId,
+				uint32 time,
+				const uint32 *args,
+				uint32 numArgs);
+
+//! @brief		Parses a record (the payload of a log frame, without its channel ID)
+//! @returns	numBytes if data is a record, or 0 if it can't be (wrong length, or too many
+//!				arguments)
+//! @public
+uint32 		UartCommsLog_ParseRecord(const uint8 *data, uint32 numBytes, UartCommsLog_Record_t *record);
+
+//! @brief		Returns the word a float is logged as
+//! @public
+uint32 		UartCommsLog_FloatToWord(float value);
+
+#if(UART_COMMS_HOST_BUILD == 1)
+	//! @brief		Formats a record's arguments with its format string, like snprintf()
+	//! @details	Supports the conversions c, d, i, u, x, X, o, e, E, f, F, g, G and %, with any
+	//!				flags, width and precision (but not *). Length modifiers are ignored, every
+	//!				argument is 32 bits. A conversion with no argument left, or which isn't
+	//!				supported, is printed as it is. Only compiled for hosts, as it pulls in
+	//!				snprintf().
+	//! @param		maxLength	Size of text, including the null. Text which doesn't fit is cut off.
+	//! @returns	Length of the text, not counting the null
+	//! @public
+	uint32 		UartCommsLog_Format(
+					char *text,
+					uint32 maxLength,
+					const char *format,
+					const uint32 *args,
+					uint32 numArgs);
+#endif
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_LOG_H
+
+// EOF
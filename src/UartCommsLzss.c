@@ -0,0 +1,181 @@
+//!
+//! @file 		UartCommsLzss.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsLzss.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsLzss.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <string.h>
+
+// User includes
+#include "UartCommsLzss.h"
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Marks an empty hash table entry
+#define NO_POSITION								(0xFFFF)
+
+//! Hash of the 3 bytes at p (Fibonacci hashing)
+#define HASH(p) \
+	((((uint32)(p)[0] << 16 | (uint32)(p)[1] << 8 | (p)[2])*2654435761u) >> (32 - configUART_COMMS_LZSS_HASH_BITS))
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+uint32 UartCommsLzss_Compress(
+	UartCommsLzss_Encoder_t *encoder,
+	const uint8 *input,
+	uint32 numBytes,
+	uint8 *output)
+{
+	uint32 inPos = 0;
+	uint32 outPos = 0;
+	uint32 flagPos = 0;
+	uint8 flagBit = 8;
+
+	// Blocks are independent, forget the last one
+	memset(encoder->head, 0xFF, sizeof(encoder->head));
+
+	while(inPos < numBytes)
+	{
+		uint32 matchLength = 0;
+		uint32 matchOffset = 0;
+
+		if(flagBit == 8)
+		{
+			flagPos = outPos++;
+			output[flagPos] = 0;
+			flagBit = 0;
+		}
+
+		// Look for a match where these 3 bytes were last seen
+		if(inPos + UART_COMMS_LZSS_MIN_MATCH <= numBytes)
+		{
+			uint32 hash = HASH(&input[inPos]);
+			uint32 candidate = encoder->head[hash];
+
+			encoder->head[hash] = (uint16)inPos;
+			if(candidate != NO_POSITION)
+			{
+				uint32 maxLength = numBytes - inPos;
+				if(maxLength > UART_COMMS_LZSS_MAX_MATCH)
+					maxLength = UART_COMMS_LZSS_MAX_MATCH;
+
+				while((matchLength < maxLength) && (input[candidate + matchLength] == input[inPos + matchLength]))
+					matchLength++;
+				matchOffset = inPos - candidate;
+			}
+		}
+
+		if(matchLength >= UART_COMMS_LZSS_MIN_MATCH)
+		{
+			uint32 i;
+
+			output[outPos++] = (uint8)(matchOffset - 1);
+			output[outPos++] = (uint8)((((matchOffset - 1) >> 8) << 4) | (matchLength - UART_COMMS_LZSS_MIN_MATCH));
+
+			// Remember the positions inside the match too, so later matches can start there
+			for(i = 1; (i < matchLength) && (inPos + i + UART_COMMS_LZSS_MIN_MATCH <= numBytes); i++)
+				encoder->head[HASH(&input[inPos + i])] = (uint16)(inPos + i);
+			inPos += matchLength;
+		}
+		else
+		{
+			output[flagPos] |= (uint8)(1 << flagBit);
+			output[outPos++] = input[inPos++];
+		}
+		flagBit++;
+	}
+
+	return outPos;
+}
+
+
+uint32 UartCommsLzss_Decompress(
+	const uint8 *input,
+	uint32 numBytes,
+	uint8 *output,
+	uint32 maxNumBytes)
+{
+	uint32 inPos = 0;
+	uint32 outPos = 0;
+	uint8 flags = 0;
+	uint8 flagBit = 8;
+
+	while(inPos < numBytes)
+	{
+		if(flagBit == 8)
+		{
+			flags = input[inPos++];
+			flagBit = 0;
+			continue;
+		}
+
+		if(((flags >> flagBit) & 1) != 0)
+		{
+			if(outPos == maxNumBytes)
+				return UART_COMMS_LZSS_ERROR;
+			output[outPos++] = input[inPos++];
+		}
+		else
+		{
+			uint32 offset;
+			uint32 length;
+
+			if(numBytes - inPos < 2)
+				return UART_COMMS_LZSS_ERROR;
+			offset = ((uint32)input[inPos] | ((uint32)(input[inPos + 1] >> 4) << 8)) + 1;
+			length = (uint32)(input[inPos + 1] & 0x0F) + UART_COMMS_LZSS_MIN_MATCH;
+			inPos += 2;
+
+			if((offset > outPos) || (length > maxNumBytes - outPos))
+				return UART_COMMS_LZSS_ERROR;
+
+			// Byte at a time, since a match can overlap the bytes it is making
+			while(length-- != 0)
+			{
+				output[outPos] = output[outPos - offset];
+				outPos++;
+			}
+		}
+		flagBit++;
+	}
+
+	return outPos;
+}
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+// EOF
@@ -0,0 +1,118 @@
+//!
+//! @file 		UartCommsLzss.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Small-window LZSS compression, used by the UartComms compression stage
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Every block is compressed on its own (the window is the block itself), so a lost
+//!		block never stops the next one being decompressed. Compressed data is a sequence of
+//!		groups, each a flag byte followed by up to 8 items, least significant flag bit first.
+//!		A flag bit of 1 is a literal byte. A flag bit of 0 is a 2 byte match, copying
+//!		length bytes from offset bytes back:
+//!			byte 0 = (offset - 1) & 0xFF
+//!			byte 1 = ((offset - 1) >> 8) << 4 | (length - UART_COMMS_LZSS_MIN_MATCH)
+//!
+//!		The encoder finds matches with a hash table of the last position each 3 byte
+//!		sequence was seen at, one probe per byte, so it runs in linear time with a fixed
+//!		amount of RAM (UartCommsLzss_Encoder_t). The decoder needs no RAM beyond its output.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_LZSS_H
+#define UART_COMMS_LZSS_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+#ifndef configUART_COMMS_LZSS_HASH_BITS
+	//! Number of bits in the encoder's hash, its table takes 2 bytes per entry
+	#define configUART_COMMS_LZSS_HASH_BITS		(8)
+#endif
+
+//! Largest block which can be compressed (matches can reach 4096 bytes back)
+#define UART_COMMS_LZSS_MAX_BLOCK_SIZE			(4096)
+
+//! Shortest match, shorter ones are sent as literals
+#define UART_COMMS_LZSS_MIN_MATCH				(3)
+
+//! Longest match
+#define UART_COMMS_LZSS_MAX_MATCH				(UART_COMMS_LZSS_MIN_MATCH + 15)
+
+//! Largest number of bytes numBytes bytes can compress to (all literals)
+#define UART_COMMS_LZSS_MAX_COMPRESSED_SIZE(numBytes)	((numBytes) + ((numBytes) + 7)/8)
+
+//! Returned by UartCommsLzss_Decompress() for corrupted data
+#define UART_COMMS_LZSS_ERROR					(0xFFFFFFFF)
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! @brief		Working memory of the encoder. Members are private.
+typedef struct
+{
+	//! Last position each hash of 3 bytes was seen at in the block
+	uint16 head[1 << configUART_COMMS_LZSS_HASH_BITS];
+} UartCommsLzss_Encoder_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Compresses one block
+//! @param		numBytes	Length of input, up to UART_COMMS_LZSS_MAX_BLOCK_SIZE
+//! @param		output		At least UART_COMMS_LZSS_MAX_COMPRESSED_SIZE(numBytes) bytes
+//! @returns	Number of bytes written to output
+//! @public
+uint32 		UartCommsLzss_Compress(
+				UartCommsLzss_Encoder_t *encoder,
+				const uint8 *input,
+				uint32 numBytes,
+				uint8 *output);
+
+//! @brief		Decompresses one block
+//! @returns	Number of bytes written to output, or UART_COMMS_LZSS_ERROR if the data is corrupt
+//!				or doesn't fit in maxNumBytes
+//! @public
+uint32 		UartCommsLzss_Decompress(
+				const uint8 *input,
+				uint32 numBytes,
+				uint8 *output,
+				uint32 maxNumBytes);
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_LZSS_H
+
+// EOF
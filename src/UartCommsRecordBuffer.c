@@ -0,0 +1,227 @@
+//!
+//! @file 		UartCommsRecordBuffer.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsRecordBuffer.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.2.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsRecordBuffer.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <string.h>
+
+// User includes
+#include "UartCommsRecordBuffer.h"
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+// Record header. Bits 0-1 are flags, 2-7 the tag and 8-31 the length (not including the header).
+#define HEADER_SIZE								(4)
+#define HEADER_COMMITTED						(0x01)	//!< Set once the record can be read
+#define HEADER_PAD								(0x02)	//!< Record is padding up to the end of the storage
+#define HEADER_TAG_SHIFT						(2)
+#define HEADER_LENGTH_SHIFT						(8)
+
+//! Set in the head index while a chain is open. Records are padded to 4 bytes, so bit 0 of the
+//! head is otherwise always 0.
+#define HEAD_CHAINED							(0x01)
+
+//! Total size of a record of numBytes bytes, including its header and padding
+#define RECORD_SIZE(numBytes)					(HEADER_SIZE + (((numBytes) + 3) & ~(uint32)3))
+
+//===============================================================================================//
+//================================== PRIVATE FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+static uint8* UartCommsRecordBuffer_ReserveIf(UartCommsRecordBuffer_t *recordBuffer, uint32 numBytes, uint32 chainedBefore, uint32 chainedAfter);
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+void UartCommsRecordBuffer_Init(UartCommsRecordBuffer_t *recordBuffer, uint32 *storage, uint32 size)
+{
+	memset(recordBuffer, 0, sizeof(*recordBuffer));
+	memset(storage, 0, size);
+	recordBuffer->shared.storage = storage;
+	recordBuffer->shared.mask = size - 1;
+}
+
+
+uint32 UartCommsRecordBuffer_MaxRecordLength(const UartCommsRecordBuffer_t *recordBuffer)
+{
+	return UART_COMMS_RECORD_BUFFER_MAX_RECORD_LENGTH(recordBuffer->shared.mask + 1);
+}
+
+
+uint32 UartCommsRecordBuffer_Count(const UartCommsRecordBuffer_t *recordBuffer)
+{
+	// Tail is read first so the result can never be more than the buffer size
+	uint32 tail = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(recordBuffer->consumer.tail);
+	return (UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(recordBuffer->producer.head) & ~(uint32)HEAD_CHAINED) - tail;
+}
+
+
+uint8* UartCommsRecordBuffer_Reserve(UartCommsRecordBuffer_t *recordBuffer, uint32 numBytes)
+{
+	return UartCommsRecordBuffer_ReserveIf(recordBuffer, numBytes, 0, 0);
+}
+
+
+uint8* UartCommsRecordBuffer_ReserveChained(UartCommsRecordBuffer_t *recordBuffer, uint32 numBytes, uint8 isFirst)
+{
+	return UartCommsRecordBuffer_ReserveIf(recordBuffer, numBytes, (isFirst != 0) ? 0 : HEAD_CHAINED, HEAD_CHAINED);
+}
+
+
+void UartCommsRecordBuffer_EndChain(UartCommsRecordBuffer_t *recordBuffer)
+{
+	// No one else changes the head while the chain is open. Release, so a consumer which sees
+	// the chain closed also sees its last record committed.
+	UART_COMMS_RING_BUFFER_STORE_RELEASE(recordBuffer->producer.head,
+		recordBuffer->producer.head & ~(uint32)HEAD_CHAINED);
+}
+
+
+uint8 UartCommsRecordBuffer_IsChained(const UartCommsRecordBuffer_t *recordBuffer)
+{
+	return ((UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(recordBuffer->producer.head) & HEAD_CHAINED) != 0) ? 1 : 0;
+}
+
+
+void UartCommsRecordBuffer_Commit(uint8 *record, uint32 numBytes, uint8 tag)
+{
+	uint32 *header = (uint32*)record - 1;
+
+	// Release, so the consumer can't see the header before the record
+	UART_COMMS_RING_BUFFER_STORE_RELEASE(*header,
+		HEADER_COMMITTED | ((uint32)tag << HEADER_TAG_SHIFT) | (numBytes << HEADER_LENGTH_SHIFT));
+}
+
+
+const uint8* UartCommsRecordBuffer_Peek(UartCommsRecordBuffer_t *recordBuffer, uint32 *numBytes, uint8 *tag)
+{
+	for(;;)
+	{
+		uint32 tail = recordBuffer->consumer.tail;
+		uint32 *header;
+		uint32 headerValue;
+
+		if(tail == (UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(recordBuffer->producer.head) & ~(uint32)HEAD_CHAINED))
+			return NULL;
+
+		header = &recordBuffer->shared.storage[(tail & recordBuffer->shared.mask)/4];
+		headerValue = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(*header);
+		if((headerValue & HEADER_COMMITTED) == 0)
+			return NULL;
+
+		if((headerValue & HEADER_PAD) != 0)
+		{
+			// Skip the padding at the end of the storage
+			UartCommsRecordBuffer_Free(recordBuffer);
+			continue;
+		}
+
+		*numBytes = headerValue >> HEADER_LENGTH_SHIFT;
+		*tag = (uint8)((headerValue >> HEADER_TAG_SHIFT) & UART_COMMS_RECORD_BUFFER_MAX_TAG);
+		return (const uint8*)(header + 1);
+	}
+}
+
+
+void UartCommsRecordBuffer_Free(UartCommsRecordBuffer_t *recordBuffer)
+{
+	uint32 tail = recordBuffer->consumer.tail;
+	uint32 *header = &recordBuffer->shared.storage[(tail & recordBuffer->shared.mask)/4];
+	uint32 recordSize = RECORD_SIZE(*header >> HEADER_LENGTH_SHIFT);
+
+	// Zero the record before handing it back, so the header of whatever is reserved here next
+	// reads as not committed until it really is
+	memset(header, 0, recordSize);
+	UART_COMMS_RING_BUFFER_STORE_RELEASE(recordBuffer->consumer.tail, tail + recordSize);
+}
+
+//===============================================================================================//
+//==================================== PRIVATE FUNCTIONS ========================================//
+//===============================================================================================//
+
+//! @brief		Reserves space for a record, if the chain flag in the head is chainedBefore
+//! @param		chainedBefore	HEAD_CHAINED if the caller has a chain open, otherwise 0
+//! @param		chainedAfter	HEAD_CHAINED to leave a chain open, otherwise 0
+//! @private
+static uint8* UartCommsRecordBuffer_ReserveIf(UartCommsRecordBuffer_t *recordBuffer, uint32 numBytes, uint32 chainedBefore, uint32 chainedAfter)
+{
+	uint32 size = recordBuffer->shared.mask + 1;
+	uint32 recordSize = RECORD_SIZE(numBytes);
+	uint32 head = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(recordBuffer->producer.head);
+	uint32 start;
+	uint32 offset;
+	uint32 padSize;
+
+	if(numBytes > UartCommsRecordBuffer_MaxRecordLength(recordBuffer))
+		return NULL;
+
+	// Claim [start, start + padSize + recordSize). If another producer gets in first, head is
+	// updated to its new value and this goes round again.
+	do
+	{
+		uint32 tail = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(recordBuffer->consumer.tail);
+
+		// Someone else's chain is open (or the caller's isn't)
+		if((head & HEAD_CHAINED) != chainedBefore)
+			return NULL;
+
+		start = head & ~(uint32)HEAD_CHAINED;
+		offset = start & recordBuffer->shared.mask;
+		padSize = 0;
+		if(offset + recordSize > size)
+			padSize = size - offset;
+
+		if((start - tail) + padSize + recordSize > size)
+			return NULL;
+	}
+	while(!UART_COMMS_RECORD_BUFFER_CAS(recordBuffer->producer.head, head, (start + padSize + recordSize) | chainedAfter));
+
+	// Pad records carry nothing, so they are committed straight away
+	if(padSize != 0)
+	{
+		UART_COMMS_RING_BUFFER_STORE_RELEASE(recordBuffer->shared.storage[offset/4],
+			HEADER_COMMITTED | HEADER_PAD | ((padSize - HEADER_SIZE) << HEADER_LENGTH_SHIFT));
+		offset = 0;
+	}
+
+	// Header stays zero (not committed) until UartCommsRecordBuffer_Commit()
+	return (uint8*)&recordBuffer->shared.storage[offset/4 + 1];
+}
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+// EOF
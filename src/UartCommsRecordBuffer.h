@@ -0,0 +1,191 @@
+//!
+//! @file 		UartCommsRecordBuffer.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Multi-producer, single-consumer record buffer used for the UartComms tx path
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.2.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Producers write whole records in three steps: reserve space (one compare-and-swap
+//!		on the head index), copy the record in, then commit it. No producer ever waits for
+//!		another, a failed compare-and-swap only means another producer reserved first.
+//!		The consumer reads committed records in reservation order, and stops at the first
+//!		one which has been reserved but not committed yet.
+//!
+//!		Every record starts with a 32-bit header (committed flag, tag and length), and is
+//!		padded to a multiple of 4 bytes. A record never wraps, if it doesn't fit before the
+//!		end of the storage the producer also reserves the remaining bytes as a pad record.
+//!		The consumer zeroes every record it frees, so a header which has been reserved but
+//!		not committed always reads as not committed.
+//!
+//!		A producer can also have the buffer to itself for a chain of records, so nothing
+//!		lands between them. While a chain is open, every other reservation fails as if
+//!		the buffer were full.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added UartCommsRecordBuffer_Count().
+//!			v1.2.0 -> Added chains of records (UartCommsRecordBuffer_ReserveChained(),
+//!				UartCommsRecordBuffer_EndChain(), UartCommsRecordBuffer_IsChained()) and
+//!				UART_COMMS_RECORD_BUFFER_MAX_RECORD_LENGTH().
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_RECORD_BUFFER_H
+#define UART_COMMS_RECORD_BUFFER_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+#include "UartCommsRingBuffer.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! @brief		Number of 32-bit words of storage for a record buffer of at least minSize bytes
+//! @details	minSize is rounded up to a power of two, and must be at least 16.
+#define UART_COMMS_RECORD_BUFFER_NUM_WORDS(minSize) \
+	(UART_COMMS_RING_BUFFER_SIZE(minSize)/4)
+
+//! @brief		Length of the largest record which can be reserved in a record buffer of size bytes
+//! @details	Same as UartCommsRecordBuffer_MaxRecordLength(), for compile-time checks.
+#define UART_COMMS_RECORD_BUFFER_MAX_RECORD_LENGTH(size) \
+	((size)/2 - 4)
+
+//! Largest tag which can be given to UartCommsRecordBuffer_Commit()
+#define UART_COMMS_RECORD_BUFFER_MAX_TAG		(0x3F)
+
+// Compare-and-swap on a 32-bit index. Older GCC's (before 4.7) don't have the __atomic builtins.
+#if defined(__ATOMIC_ACQ_REL)
+	#define UART_COMMS_RECORD_BUFFER_CAS(index, expected, desired) \
+		__atomic_compare_exchange_n(&(index), &(expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+	#define UART_COMMS_RECORD_BUFFER_CAS(index, expected, desired) \
+		__extension__ ({ uint32 old_ = __sync_val_compare_and_swap(&(index), (expected), (desired)); \
+		int swapped_ = (old_ == (expected)); (expected) = old_; swapped_; })
+#endif
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! A record buffer. Members are private, use the functions below.
+typedef struct
+{
+	// Written by producers (with compare-and-swap)
+	struct
+	{
+		uint32 head;			//!< Total number of bytes ever reserved, bit 0 set while a chain is open
+	} producer __attribute__((aligned(configUART_COMMS_CACHE_LINE_SIZE)));
+
+	// Written by the consumer only
+	struct
+	{
+		uint32 tail;			//!< Total number of bytes ever freed
+	} consumer __attribute__((aligned(configUART_COMMS_CACHE_LINE_SIZE)));
+
+	// Read-only after UartCommsRecordBuffer_Init()
+	struct
+	{
+		uint32 *storage;		//!< Size bytes of storage
+		uint32 mask;			//!< Size - 1
+	} shared __attribute__((aligned(configUART_COMMS_CACHE_LINE_SIZE)));
+} UartCommsRecordBuffer_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Initialises an empty record buffer
+//! @param		storage		Storage for the buffer
+//! @param		size		Size of storage in bytes, must be a power of two and at least 16
+//!							(see UART_COMMS_RECORD_BUFFER_NUM_WORDS())
+//! @public
+void 		UartCommsRecordBuffer_Init(UartCommsRecordBuffer_t *recordBuffer, uint32 *storage, uint32 size);
+
+//! @brief		Returns the length of the largest record which can be reserved
+//! @details	Half the buffer, less the header, so a record always fits once the buffer has emptied.
+//! @public
+uint32 		UartCommsRecordBuffer_MaxRecordLength(const UartCommsRecordBuffer_t *recordBuffer);
+
+//! @brief		Returns the number of bytes in use, including headers and padding
+//! @public
+uint32 		UartCommsRecordBuffer_Count(const UartCommsRecordBuffer_t *recordBuffer);
+
+//! @brief		Reserves space for a record of numBytes bytes
+//! @returns	Where to copy the record to, or NULL if there isn't room (or numBytes is more than
+//!				UartCommsRecordBuffer_MaxRecordLength())
+//! @note		Producers only. Safe to call from any number of tasks at once. Every reserved
+//!				record must be committed, or the consumer will stop at it.
+//! @public
+uint8* 		UartCommsRecordBuffer_Reserve(UartCommsRecordBuffer_t *recordBuffer, uint32 numBytes);
+
+//! @brief		Reserves space for a record of a chain
+//! @details	The first record of a chain opens it, and fails if another chain is open. Until
+//!				UartCommsRecordBuffer_EndChain(), only the producer which opened the chain can
+//!				reserve, so its records are read one after the other.
+//! @param		isFirst		1 for the first record of the chain, otherwise 0
+//! @returns	Same as UartCommsRecordBuffer_Reserve()
+//! @note		Producers only. Records are committed as usual.
+//! @public
+uint8* 		UartCommsRecordBuffer_ReserveChained(UartCommsRecordBuffer_t *recordBuffer, uint32 numBytes, uint8 isFirst);
+
+//! @brief		Closes the chain opened by UartCommsRecordBuffer_ReserveChained()
+//! @note		Only call from the producer which opened the chain, after committing its records
+//! @public
+void 		UartCommsRecordBuffer_EndChain(UartCommsRecordBuffer_t *recordBuffer);
+
+//! @brief		Returns 1 if a chain is open, otherwise 0
+//! @details	A consumer which has read a record of a chain, and finds the buffer empty and
+//!				the chain closed, knows there is nothing more of the chain to come.
+//! @public
+uint8 		UartCommsRecordBuffer_IsChained(const UartCommsRecordBuffer_t *recordBuffer);
+
+//! @brief		Makes a reserved record visible to the consumer
+//! @param		record		Returned by UartCommsRecordBuffer_Reserve()
+//! @param		numBytes	Same as given to UartCommsRecordBuffer_Reserve()
+//! @param		tag			Passed on to the consumer, 0 to UART_COMMS_RECORD_BUFFER_MAX_TAG
+//! @note		Producers only
+//! @public
+void 		UartCommsRecordBuffer_Commit(uint8 *record, uint32 numBytes, uint8 tag);
+
+//! @brief		Returns the oldest record, if it has been committed, without removing it
+//! @param		numBytes	Set to the length of the record
+//! @param		tag			Set to the tag given to UartCommsRecordBuffer_Commit()
+//! @returns	The record, or NULL if the buffer is empty or the oldest record isn't committed yet
+//! @note		Consumer only. Call UartCommsRecordBuffer_Free() once the record has been used.
+//! @public
+const uint8* UartCommsRecordBuffer_Peek(UartCommsRecordBuffer_t *recordBuffer, uint32 *numBytes, uint8 *tag);
+
+//! @brief		Removes the record last returned by UartCommsRecordBuffer_Peek()
+//! @note		Consumer only
+//! @public
+void 		UartCommsRecordBuffer_Free(UartCommsRecordBuffer_t *recordBuffer);
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_RECORD_BUFFER_H
+
+// EOF
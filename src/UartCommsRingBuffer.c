@@ -0,0 +1,161 @@
+//!
+//! @file 		UartCommsRingBuffer.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsRingBuffer.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsRingBuffer.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <string.h>
+
+// User includes
+#include "UartCommsRingBuffer.h"
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+void UartCommsRingBuffer_Init(UartCommsRingBuffer_t *ringBuffer, uint8 *storage, uint32 size)
+{
+	memset(ringBuffer, 0, sizeof(*ringBuffer));
+	ringBuffer->shared.storage = storage;
+	ringBuffer->shared.mask = size - 1;
+}
+
+
+uint32 UartCommsRingBuffer_Count(const UartCommsRingBuffer_t *ringBuffer)
+{
+	// Unsigned subtraction handles the indices wrapping. Tail is read first so the result
+	// can never be more than the buffer size.
+	uint32 tail = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(ringBuffer->consumer.tail);
+	return UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(ringBuffer->producer.head) - tail;
+}
+
+
+uint32 UartCommsRingBuffer_Space(const UartCommsRingBuffer_t *ringBuffer)
+{
+	return (ringBuffer->shared.mask + 1) - UartCommsRingBuffer_Count(ringBuffer);
+}
+
+
+uint32 UartCommsRingBuffer_Write(UartCommsRingBuffer_t *ringBuffer, const uint8 *data, uint32 numBytes)
+{
+	uint32 size = ringBuffer->shared.mask + 1;
+	uint32 head = ringBuffer->producer.head;
+	uint32 space = size - (head - ringBuffer->producer.cachedTail);
+	uint32 offset;
+	uint32 firstPiece;
+
+	// Only look at the consumer's index if the cached one says there isn't enough room
+	if(space < numBytes)
+	{
+		ringBuffer->producer.cachedTail = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(ringBuffer->consumer.tail);
+		space = size - (head - ringBuffer->producer.cachedTail);
+		if(numBytes > space)
+			numBytes = space;
+	}
+	if(numBytes == 0)
+		return 0;
+
+	// Copy in up to two pieces, the second one if the data wraps around the end of storage
+	offset = head & ringBuffer->shared.mask;
+	firstPiece = size - offset;
+	if(firstPiece > numBytes)
+		firstPiece = numBytes;
+	memcpy(&ringBuffer->shared.storage[offset], data, firstPiece);
+	memcpy(&ringBuffer->shared.storage[0], &data[firstPiece], numBytes - firstPiece);
+
+	// Release makes the data visible before the new head
+	UART_COMMS_RING_BUFFER_STORE_RELEASE(ringBuffer->producer.head, head + numBytes);
+
+	return numBytes;
+}
+
+
+uint32 UartCommsRingBuffer_Read(UartCommsRingBuffer_t *ringBuffer, uint8 *data, uint32 numBytes)
+{
+	uint32 size = ringBuffer->shared.mask + 1;
+	uint32 tail = ringBuffer->consumer.tail;
+	uint32 count = ringBuffer->consumer.cachedHead - tail;
+	uint32 offset;
+	uint32 firstPiece;
+
+	// Only look at the producer's index if the cached one says there isn't enough data
+	if(count < numBytes)
+	{
+		ringBuffer->consumer.cachedHead = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(ringBuffer->producer.head);
+		count = ringBuffer->consumer.cachedHead - tail;
+		if(numBytes > count)
+			numBytes = count;
+	}
+	if(numBytes == 0)
+		return 0;
+
+	offset = tail & ringBuffer->shared.mask;
+	firstPiece = size - offset;
+	if(firstPiece > numBytes)
+		firstPiece = numBytes;
+	memcpy(data, &ringBuffer->shared.storage[offset], firstPiece);
+	memcpy(&data[firstPiece], &ringBuffer->shared.storage[0], numBytes - firstPiece);
+
+	// Release makes sure the data has been copied out before the producer can overwrite it
+	UART_COMMS_RING_BUFFER_STORE_RELEASE(ringBuffer->consumer.tail, tail + numBytes);
+
+	return numBytes;
+}
+
+
+uint32 UartCommsRingBuffer_Peek(UartCommsRingBuffer_t *ringBuffer, const uint8 **data)
+{
+	uint32 tail = ringBuffer->consumer.tail;
+	uint32 offset = tail & ringBuffer->shared.mask;
+	uint32 contiguous = (ringBuffer->shared.mask + 1) - offset;
+	uint32 count = ringBuffer->consumer.cachedHead - tail;
+
+	if(count < contiguous)
+	{
+		ringBuffer->consumer.cachedHead = UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(ringBuffer->producer.head);
+		count = ringBuffer->consumer.cachedHead - tail;
+	}
+
+	*data = &ringBuffer->shared.storage[offset];
+	return (count < contiguous) ? count : contiguous;
+}
+
+
+void UartCommsRingBuffer_Consume(UartCommsRingBuffer_t *ringBuffer, uint32 numBytes)
+{
+	UART_COMMS_RING_BUFFER_STORE_RELEASE(ringBuffer->consumer.tail, ringBuffer->consumer.tail + numBytes);
+}
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+// EOF
@@ -0,0 +1,169 @@
+//!
+//! @file 		UartCommsRingBuffer.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Single-producer, single-consumer byte ring buffer used by UartComms
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5						\n
+//!		<b>Computer Architecture:	</b> ARM						\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Bytes are copied in and out in bulk (at most two memcpy()'s per call). The size
+//!		is a power of two and the head and tail indices are free-running, so the buffer can
+//!		be completely filled and no modulo is needed. The head is only written by the
+//!		producer and the tail only by the consumer, so no locking is needed as long as there
+//!		is only one of each. Several producers must serialise themselves (e.g. with a mutex).
+//!
+//!		The indices are published with release stores and read with acquire loads, so
+//!		the buffer is also safe between two threads on different cores (e.g. on a host).
+//!		Producer and consumer indices live in separate cache lines, and each side keeps
+//!		a cached copy of the other side's index so it only touches the other cache line
+//!		when the cached copy says the buffer is full (producer) or empty (consumer).
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Indices use acquire/release atomics and are cache-line separated.
+//!				Producer and consumer cache each other's index.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_RING_BUFFER_H
+#define UART_COMMS_RING_BUFFER_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! @brief		Rounds minSize up to the next power of two, for sizing ring buffer storage at compile time
+#define UART_COMMS_RING_BUFFER_SIZE(minSize) \
+	(UART_COMMS_RING_BUFFER_SMEAR16_((uint32)(minSize) - 1) + 1)
+
+// Copies the highest set bit into every bit below it
+#define UART_COMMS_RING_BUFFER_SMEAR1_(x)		((x) | ((x) >> 1))
+#define UART_COMMS_RING_BUFFER_SMEAR2_(x)		(UART_COMMS_RING_BUFFER_SMEAR1_(x) | (UART_COMMS_RING_BUFFER_SMEAR1_(x) >> 2))
+#define UART_COMMS_RING_BUFFER_SMEAR4_(x)		(UART_COMMS_RING_BUFFER_SMEAR2_(x) | (UART_COMMS_RING_BUFFER_SMEAR2_(x) >> 4))
+#define UART_COMMS_RING_BUFFER_SMEAR8_(x)		(UART_COMMS_RING_BUFFER_SMEAR4_(x) | (UART_COMMS_RING_BUFFER_SMEAR4_(x) >> 8))
+#define UART_COMMS_RING_BUFFER_SMEAR16_(x)		(UART_COMMS_RING_BUFFER_SMEAR8_(x) | (UART_COMMS_RING_BUFFER_SMEAR8_(x) >> 16))
+
+#ifndef configUART_COMMS_CACHE_LINE_SIZE
+	//! Alignment used to keep the producer and consumer indices in separate cache lines. The
+	//! PSoC5 has no data cache, so there is no point padding there.
+	#if(UART_COMMS_HOST_BUILD == 1)
+		#define configUART_COMMS_CACHE_LINE_SIZE	(64)
+	#else
+		#define configUART_COMMS_CACHE_LINE_SIZE	(4)
+	#endif
+#endif
+
+// Atomic index access. Older GCC's (before 4.7) don't have the __atomic builtins.
+#if defined(__ATOMIC_ACQUIRE)
+	#define UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(index) \
+		__atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+	#define UART_COMMS_RING_BUFFER_STORE_RELEASE(index, value) \
+		__atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#else
+	#define UART_COMMS_RING_BUFFER_LOAD_ACQUIRE(index) \
+		__extension__ ({ uint32 value_ = *(volatile uint32*)&(index); __sync_synchronize(); value_; })
+	#define UART_COMMS_RING_BUFFER_STORE_RELEASE(index, value) \
+		do { __sync_synchronize(); *(volatile uint32*)&(index) = (value); } while(0)
+#endif
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! A ring buffer. Members are private, use the functions below.
+typedef struct
+{
+	// Written by the producer only
+	struct
+	{
+		uint32 head;			//!< Total number of bytes ever written
+		uint32 cachedTail;		//!< Last tail the producer read
+	} producer __attribute__((aligned(configUART_COMMS_CACHE_LINE_SIZE)));
+
+	// Written by the consumer only
+	struct
+	{
+		uint32 tail;			//!< Total number of bytes ever read
+		uint32 cachedHead;		//!< Last head the consumer read
+	} consumer __attribute__((aligned(configUART_COMMS_CACHE_LINE_SIZE)));
+
+	// Read-only after UartCommsRingBuffer_Init()
+	struct
+	{
+		uint8 *storage;			//!< Size bytes of storage
+		uint32 mask;			//!< Size - 1
+	} shared __attribute__((aligned(configUART_COMMS_CACHE_LINE_SIZE)));
+} UartCommsRingBuffer_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Initialises an empty ring buffer
+//! @param		storage		Storage for the buffer
+//! @param		size		Size of storage, must be a power of two (see UART_COMMS_RING_BUFFER_SIZE())
+//! @public
+void 		UartCommsRingBuffer_Init(UartCommsRingBuffer_t *ringBuffer, uint8 *storage, uint32 size);
+
+//! @brief		Returns the number of bytes which can be read
+//! @public
+uint32 		UartCommsRingBuffer_Count(const UartCommsRingBuffer_t *ringBuffer);
+
+//! @brief		Returns the number of bytes which can be written
+//! @public
+uint32 		UartCommsRingBuffer_Space(const UartCommsRingBuffer_t *ringBuffer);
+
+//! @brief		Copies as much of data into the buffer as will fit
+//! @returns	Number of bytes written, between 0 and numBytes
+//! @note		Producer only
+//! @public
+uint32 		UartCommsRingBuffer_Write(UartCommsRingBuffer_t *ringBuffer, const uint8 *data, uint32 numBytes);
+
+//! @brief		Copies up to numBytes out of the buffer
+//! @returns	Number of bytes read, between 0 and numBytes
+//! @note		Consumer only
+//! @public
+uint32 		UartCommsRingBuffer_Read(UartCommsRingBuffer_t *ringBuffer, uint8 *data, uint32 numBytes);
+
+//! @brief		Returns a pointer to the oldest bytes in the buffer without removing them
+//! @param		data	Set to the first readable byte
+//! @returns	Number of bytes which can be read contiguously from *data
+//! @note		Consumer only. Call UartCommsRingBuffer_Consume() once the bytes have been used.
+//! @public
+uint32 		UartCommsRingBuffer_Peek(UartCommsRingBuffer_t *ringBuffer, const uint8 **data);
+
+//! @brief		Removes numBytes which were previously returned by UartCommsRingBuffer_Peek()
+//! @note		Consumer only
+//! @public
+void 		UartCommsRingBuffer_Consume(UartCommsRingBuffer_t *ringBuffer, uint32 numBytes);
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_RING_BUFFER_H
+
+// EOF
@@ -0,0 +1,186 @@
+//!
+//! @file 		UartCommsTrace.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See UartCommsTrace.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See the Doxygen documentation or UartCommsTrace.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <string.h>
+
+// User includes
+#include "UartCommsTrace.h"
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Magic number at the start of a trace file
+static const uint8 fileMagic[4] = { 'U', 'C', 'T', 'R' };
+
+//===============================================================================================//
+//================================== PRIVATE FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+static void UartCommsTrace_WriteHeader(UartCommsTrace_t *trace, uint8 direction, uint32 tickDelta, uint32 numBytes);
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+void UartCommsTrace_Init(UartCommsTrace_t *trace, uint8 *storage, uint32 size, uint32 now)
+{
+	UartCommsRingBuffer_Init(&trace->buffer, storage, size);
+	trace->lastTick = now;
+	trace->numBytesDropped = 0;
+	trace->isGapPending = 0;
+}
+
+
+uint32 UartCommsTrace_Write(
+	UartCommsTrace_t *trace,
+	uint8 direction,
+	uint32 now,
+	const uint8 *data,
+	uint32 numBytes)
+{
+	uint32 numRecords = (numBytes + UART_COMMS_TRACE_MAX_RECORD_DATA - 1)/UART_COMMS_TRACE_MAX_RECORD_DATA;
+	uint32 size = numRecords*UART_COMMS_TRACE_RECORD_HEADER_SIZE + numBytes;
+	uint32 tickDelta = now - trace->lastTick;
+	uint32 offset;
+
+	if(numBytes == 0)
+		return 0;
+
+	if(trace->isGapPending != 0)
+		size += UART_COMMS_TRACE_RECORD_HEADER_SIZE;
+
+	// All or nothing, so the stream never has half a write in it
+	if(UartCommsRingBuffer_Space(&trace->buffer) < size)
+	{
+		trace->numBytesDropped += numBytes;
+		trace->isGapPending = 1;
+		return 0;
+	}
+
+	if(trace->isGapPending != 0)
+	{
+		UartCommsTrace_WriteHeader(trace, direction, tickDelta, 0);
+		trace->isGapPending = 0;
+		tickDelta = 0;
+	}
+
+	for(offset = 0; offset < numBytes; offset += UART_COMMS_TRACE_MAX_RECORD_DATA)
+	{
+		uint32 length = numBytes - offset;
+		if(length > UART_COMMS_TRACE_MAX_RECORD_DATA)
+			length = UART_COMMS_TRACE_MAX_RECORD_DATA;
+
+		UartCommsTrace_WriteHeader(trace, direction, tickDelta, length);
+		UartCommsRingBuffer_Write(&trace->buffer, &data[offset], length);
+		tickDelta = 0;
+	}
+
+	trace->lastTick = now;
+	return numBytes;
+}
+
+
+uint32 UartCommsTrace_Read(UartCommsTrace_t *trace, uint8 *data, uint32 maxNumBytes)
+{
+	return UartCommsRingBuffer_Read(&trace->buffer, data, maxNumBytes);
+}
+
+
+void UartCommsTrace_EncodeFileHeader(uint8 *header, uint16 ticksPerSecond)
+{
+	memcpy(header, fileMagic, sizeof(fileMagic));
+	header[4] = UART_COMMS_TRACE_FILE_VERSION;
+	header[5] = 0;
+	header[6] = (uint8)ticksPerSecond;
+	header[7] = (uint8)(ticksPerSecond >> 8);
+}
+
+
+uint16 UartCommsTrace_DecodeFileHeader(const uint8 *header, uint32 numBytes)
+{
+	if((numBytes < UART_COMMS_TRACE_FILE_HEADER_SIZE)
+		|| (memcmp(header, fileMagic, sizeof(fileMagic)) != 0)
+		|| (header[4] != UART_COMMS_TRACE_FILE_VERSION))
+	{
+		return 0;
+	}
+
+	return (uint16)(header[6] | (header[7] << 8));
+}
+
+
+uint32 UartCommsTrace_ParseRecord(const uint8 *data, uint32 numBytes, UartCommsTrace_Record_t *record)
+{
+	uint32 length;
+
+	if(numBytes < UART_COMMS_TRACE_RECORD_HEADER_SIZE)
+		return 0;
+
+	length = data[0] & UART_COMMS_TRACE_MAX_RECORD_DATA;
+	if(numBytes - UART_COMMS_TRACE_RECORD_HEADER_SIZE < length)
+		return 0;
+
+	record->direction = data[0] & UART_COMMS_TRACE_DIR_TX;
+	record->tickDelta = (uint16)(data[1] | (data[2] << 8));
+	record->numBytes = (uint8)length;
+	record->data = &data[UART_COMMS_TRACE_RECORD_HEADER_SIZE];
+	return UART_COMMS_TRACE_RECORD_HEADER_SIZE + length;
+}
+
+//===============================================================================================//
+//==================================== PRIVATE FUNCTIONS ========================================//
+//===============================================================================================//
+
+//! @brief		Writes a record header, clamping the tick delta
+//! @note		The caller has already checked there is room
+//! @private
+static void UartCommsTrace_WriteHeader(UartCommsTrace_t *trace, uint8 direction, uint32 tickDelta, uint32 numBytes)
+{
+	uint8 header[UART_COMMS_TRACE_RECORD_HEADER_SIZE];
+
+	if(tickDelta > UART_COMMS_TRACE_MAX_TICK_DELTA)
+		tickDelta = UART_COMMS_TRACE_MAX_TICK_DELTA;
+
+	header[0] = direction | (uint8)numBytes;
+	header[1] = (uint8)tickDelta;
+	header[2] = (uint8)(tickDelta >> 8);
+	UartCommsRingBuffer_Write(&trace->buffer, header, sizeof(header));
+}
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+// EOF
@@ -0,0 +1,153 @@
+//!
+//! @file 		UartCommsTrace.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Wire trace ring, which records the bytes a UartComms port sends and receives
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> PSoC5, Linux (host)		\n
+//!		<b>Computer Architecture:	</b> ARM, x86					\n
+//! 	<b>Operating System:		</b> FreeRTOS v7.2.0			\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		A trace is a stream of records, each a 3 byte header followed by its data:
+//!			byte 0 = direction (UART_COMMS_TRACE_DIR_x) | number of data bytes (0 to 127)
+//!			byte 1, 2 = ticks since the previous record, least significant byte first,
+//!				UART_COMMS_TRACE_MAX_TICK_DELTA if it was longer than that
+//!		Longer writes are split into several records. A record with no data is a gap
+//!		marker: the trace ring was full and bytes were lost before this point.
+//!
+//!		Records are written into a ring buffer (UartCommsRingBuffer.h) and read out as a
+//!		plain byte stream, so the reader never has to wait for a whole record. A write
+//!		which doesn't fit is dropped whole, counted, and followed by a gap marker once
+//!		there is room again. Writers must serialise themselves (UartComms records from
+//!		the RX ISR and, in a critical section, from the TX task).
+//!
+//!		A trace file is an UART_COMMS_TRACE_FILE_HEADER_SIZE byte header (magic "UCTR",
+//!		version, and the tick rate the deltas are in) followed by the stream.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//============================================ GUARDS ===========================================//
+//===============================================================================================//
+
+#ifndef UART_COMMS_TRACE_H
+#define UART_COMMS_TRACE_H
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include "UartCommsBackend.h"
+#include "UartCommsRingBuffer.h"
+
+//===============================================================================================//
+//==================================== PUBLIC DEFINES ===========================================//
+//===============================================================================================//
+
+//! Direction bit of a record header, for received bytes
+#define UART_COMMS_TRACE_DIR_RX					(0x00)
+//! Direction bit of a record header, for sent bytes
+#define UART_COMMS_TRACE_DIR_TX					(0x80)
+
+//! Most data bytes in one record
+#define UART_COMMS_TRACE_MAX_RECORD_DATA		(0x7F)
+
+//! Number of bytes in a record header
+#define UART_COMMS_TRACE_RECORD_HEADER_SIZE		(3)
+
+//! Largest tick delta a record can hold, longer gaps are clamped to it
+#define UART_COMMS_TRACE_MAX_TICK_DELTA			(0xFFFF)
+
+//! Number of bytes in a trace file header
+#define UART_COMMS_TRACE_FILE_HEADER_SIZE		(8)
+
+//! Version of the trace format, in the file header
+#define UART_COMMS_TRACE_FILE_VERSION			(1)
+
+//===============================================================================================//
+//====================================== PUBLIC TYPEDEFS ========================================//
+//===============================================================================================//
+
+//! @brief		A trace ring. Members are private.
+typedef struct
+{
+	UartCommsRingBuffer_t buffer;		//!< Encoded records
+	uint32 lastTick;					//!< Tick of the last record written
+	uint32 numBytesDropped;				//!< Data bytes dropped because the ring was full
+	uint8 isGapPending;					//!< 1 if a gap marker is due before the next record
+} UartCommsTrace_t;
+
+//! One record, as parsed by UartCommsTrace_ParseRecord()
+typedef struct
+{
+	uint8 direction;					//!< UART_COMMS_TRACE_DIR_x
+	uint16 tickDelta;					//!< Ticks since the previous record
+	uint8 numBytes;						//!< Number of data bytes, 0 for a gap marker
+	const uint8 *data;					//!< Data bytes, inside the buffer given to UartCommsTrace_ParseRecord()
+} UartCommsTrace_Record_t;
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Initialises an empty trace ring
+//! @param		storage		Where records are kept, a power of two bytes long
+//! @param		now			Current tick, which the first record's delta is from
+//! @public
+void 		UartCommsTrace_Init(UartCommsTrace_t *trace, uint8 *storage, uint32 size, uint32 now);
+
+//! @brief		Records bytes sent or received at tick now
+//! @details	Constant time per byte, safe to call from an ISR.
+//! @param		direction	UART_COMMS_TRACE_DIR_RX or UART_COMMS_TRACE_DIR_TX
+//! @returns	numBytes if they were recorded, 0 if they were dropped (the ring was full)
+//! @public
+uint32 		UartCommsTrace_Write(
+				UartCommsTrace_t *trace,
+				uint8 direction,
+				uint32 now,
+				const uint8 *data,
+				uint32 numBytes);
+
+//! @brief		Reads up to maxNumBytes of the trace stream, freeing room in the ring
+//! @returns	Number of bytes read
+//! @public
+uint32 		UartCommsTrace_Read(UartCommsTrace_t *trace, uint8 *data, uint32 maxNumBytes);
+
+//! @brief		Fills in a trace file header
+//! @param		header			UART_COMMS_TRACE_FILE_HEADER_SIZE bytes
+//! @param		ticksPerSecond	Tick rate of the records which follow (configTICK_RATE_HZ)
+//! @public
+void 		UartCommsTrace_EncodeFileHeader(uint8 *header, uint16 ticksPerSecond);
+
+//! @brief		Checks a trace file header
+//! @returns	The tick rate of the records in the file, or 0 if it isn't a trace file
+//!				(or is a version this code can't read)
+//! @public
+uint16 		UartCommsTrace_DecodeFileHeader(const uint8 *header, uint32 numBytes);
+
+//! @brief		Parses the record at the start of data
+//! @returns	Number of bytes the record takes, or 0 if data doesn't hold a whole record
+//! @public
+uint32 		UartCommsTrace_ParseRecord(const uint8 *data, uint32 numBytes, UartCommsTrace_Record_t *record);
+
+#ifdef __cplusplus
+	} // extern "C" {
+#endif
+
+#endif // #ifndef UART_COMMS_TRACE_H
+
+// EOF
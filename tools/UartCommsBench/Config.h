@@ -0,0 +1,34 @@
+//!
+//! @file 		Config.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		UartComms configuration used by the benchmark
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Everything else is left at its default, so the benchmark measures what ships. Add
+//!		-D's to the build to benchmark other settings.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#define configENABLE_TASK_UART_COMMS			(1)
+#define configPRINT_DEBUG_UART_COMMS			(0)
+#define configALLOW_SLEEP_UART_COMMS			(1)
+
+#endif // #ifndef CONFIG_H
+
+// EOF
@@ -0,0 +1,58 @@
+//!
+//! @file 		FreeRTOS.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		FreeRTOS API subset implemented by the benchmark's virtual-time kernel
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Only what UartComms and the POSIX backend use, with FreeRTOS v7 names. See
+//!		VirtualKernel.h.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define configTICK_RATE_HZ						(1000)
+#define configMAX_PRIORITIES					(8)
+#define configMINIMAL_STACK_SIZE				(256)
+#define configSUPPORT_STATIC_ALLOCATION			(0)
+
+#define portBASE_TYPE							long
+#define portCHAR								char
+typedef uint32_t portTickType;
+
+#define portMAX_DELAY							((portTickType)0xFFFFFFFF)
+#define portTICK_RATE_MS						((portTickType)1000/configTICK_RATE_HZ)
+
+#define pdTRUE									(1)
+#define pdFALSE									(0)
+#define pdPASS									(1)
+#define pdFAIL									(0)
+
+#define tskIDLE_PRIORITY						(0)
+
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+void vPortYieldFromIsr(void);
+
+#define portEND_SWITCHING_ISR(isSwitchNeeded)	do { if(isSwitchNeeded) vPortYieldFromIsr(); } while(0)
+
+#endif // #ifndef FREERTOS_H
+
+// EOF
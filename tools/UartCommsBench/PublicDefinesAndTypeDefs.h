@@ -0,0 +1,34 @@
+//!
+//! @file 		PublicDefinesAndTypeDefs.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Project-wide types used by UartComms, for the benchmark
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+#ifndef PUBLIC_DEFINES_AND_TYPEDEFS_H
+#define PUBLIC_DEFINES_AND_TYPEDEFS_H
+
+#include <stdint.h>
+
+typedef uint8_t bool_t;
+
+#define TRUE									(1)
+#define FALSE									(0)
+
+#endif // #ifndef PUBLIC_DEFINES_AND_TYPEDEFS_H
+
+// EOF
@@ -0,0 +1,724 @@
+//!
+//! @file 		UartCommsBench.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Virtual-time benchmark of the UartComms TX and RX pipelines
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Build:
+//!			gcc -O2 -Itools/UartCommsBench -Isrc -o UartCommsBench tools/UartCommsBench/*.c src/UartComms.c src/UartCommsBackendPosix.c src/UartCommsRingBuffer.c src/UartCommsRecordBuffer.c src/UartCommsFrame.c src/UartCommsLzss.c src/UartCommsTrace.c src/UartCommsLog.c
+//!
+//!		Usage:
+//!			UartCommsBench [-s tx|rx|all|baseline] [-t ticks] > results.jsonl
+//!
+//!		Runs the driver unchanged on the POSIX backend (loopback wire), under the
+//!		virtual-time kernel in VirtualKernel.h, so the baud rate and FIFO depth are
+//!		modelled exactly and every run gives the same counts and latencies. Each
+//!		configuration runs in its own process and prints one JSON object per line.
+//!
+//!		TX scenario: producer tasks wake at pseudo-random times and write lines with
+//!		UartComms_PutString() at 90% of the line's capacity in total. A reader task reads
+//!		them back with UartComms_ReadLine(). Swept over the number of producers, message
+//!		size, bulk tx buffer size, baud rate, and whether the TX task runs below or above
+//!		the producers. Reports throughput, line utilisation, latency percentiles (write to
+//!		read back, in ticks of 1ms, so 1ms resolution), writer waits, drops, TX ISR runs,
+//!		context switches and host CPU time per byte.
+//!
+//!		Baseline scenario (not part of all): the TX scenario again, but the producers write
+//!		through the TX path this driver had up to v1.1.0 (see BaselinePutString()), one
+//!		xQueueSendToBack() per byte under a mutex, to a TX task which takes one byte at a time
+//!		off the queue with xQueueReceive() and writes it to the UART with putChar(). The
+//!		queue holds as many bytes as the tx buffer. Reading back is done by the current
+//!		driver, as in the TX scenario, so the TX task and producer CPU times per byte of
+//!		the two scenarios compare the two TX paths.
+//!
+//!		RX scenario: bursts are played into the RX pin from a trace file (see
+//!		UartCommsBackendPosix_StartReplay()) while a reader task reads 64 bytes at a time
+//!		and then sleeps. Swept over the rx buffer size, burst size, baud rate and reader
+//!		sleep. Reports bytes dropped by the RX ISR, overruns and the rx buffer high water
+//!		mark. FIFO depth isn't swept, as the emulator raises the RX interrupt every byte
+//!		time, so it makes no difference.
+//!
+//!		Host CPU times are the only numbers which change from run to run.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.0.1 -> Build line includes UartCommsLog.c. RX scenario no longer sweeps the
+//!				FIFO depth, which made no difference.
+//!			v1.1.0 -> Added the baseline scenario.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// User includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "VirtualKernel.h"
+#include "UartComms.h"
+#include "UartCommsBackendPosix.h"
+#include "UartCommsTrace.h"
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Default length of each run, in ticks
+#define DEFAULT_NUM_TICKS						(2000)
+
+//! Task priorities. The TX task runs at PRIORITY_PRODUCER - 1 or + 1.
+#define PRIORITY_PRODUCER						(tskIDLE_PRIORITY + 2)
+#define PRIORITY_READER							(tskIDLE_PRIORITY + 4)
+#define PRIORITY_EMULATOR						(tskIDLE_PRIORITY + 5)
+
+//! Emulated FIFO depth (the PSoC UART's)
+#define FIFO_DEPTH								(4)
+
+//! Offered load in the TX scenario, in percent of the line's capacity
+#define TX_LOAD_PERCENT							(90)
+
+//! Average time between a producer's wake-ups, in ticks
+#define PRODUCER_MEAN_PERIOD					(10)
+
+//! Latencies are counted in a histogram of one bin per tick, longer ones go in the last bin
+#define LATENCY_HISTOGRAM_SIZE					(8192)
+
+//! Ticks between the starts of RX bursts
+#define RX_BURST_PERIOD							(50)
+
+//! Bytes the RX reader asks for per read
+#define RX_READ_SIZE							(64)
+
+//! Max time (in ms) the baseline TX path waits for the mutex, and for room for each byte,
+//! as in v1.1.0
+#define BASELINE_TX_MAX_WAIT_TIME_MS			(1000)
+
+//! Time the baseline TX task waits for another byte before letting the UART sleep, as in v1.1.0
+#define BASELINE_TIME_TO_WAIT_FOR_ANOTHER_CHAR_BEFORE_SLEEPING_MS	(5)
+
+//! Storage for building the RX trace, a power of two
+#define RX_TRACE_STORAGE_SIZE					(1 << 20)
+
+#define NUM_ELEMENTS(array)						(sizeof(array)/sizeof((array)[0]))
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! One TX configuration
+typedef struct
+{
+	uint32 numProducers;
+	uint32 messageSize;					//!< Bytes per line, including the '\n'
+	uint32 txBufferSize;
+	uint32 baudRate;
+	bool_t isTxTaskAbove;				//!< TRUE if the TX task runs above the producers
+	bool_t isBaseline;					//!< TRUE to write through the v1.1.0 TX path
+} txConfig_t;
+
+//! One RX configuration
+typedef struct
+{
+	uint32 rxBufferSize;
+	uint32 burstSize;
+	uint32 baudRate;
+	uint32 readerDelay;					//!< Ticks the reader sleeps after each read
+} rxConfig_t;
+
+//! A port and the buffer sizes it was defined with
+typedef struct
+{
+	UartComms_Port_t *port;
+	uint32 txBufferSize;
+	uint32 rxBufferSize;
+} benchPort_t;
+
+//===============================================================================================//
+//============================= PRIVATE VARIABLES/STRUCTURES ====================================//
+//===============================================================================================//
+
+UART_COMMS_PORT_DEFINE(benchPortTx256Rx1024, 256, 1024)
+UART_COMMS_PORT_DEFINE(benchPortTx1024Rx1024, 1024, 1024)
+UART_COMMS_PORT_DEFINE(benchPortTx4096Rx1024, 4096, 1024)
+UART_COMMS_PORT_DEFINE(benchPortTx256Rx64, 256, 64)
+UART_COMMS_PORT_DEFINE(benchPortTx256Rx256, 256, 256)
+
+//! Every port, one for each combination of buffer sizes swept
+static const benchPort_t benchPorts[] =
+{
+	{ &benchPortTx256Rx1024, 256, 1024 },
+	{ &benchPortTx1024Rx1024, 1024, 1024 },
+	{ &benchPortTx4096Rx1024, 4096, 1024 },
+	{ &benchPortTx256Rx64, 256, 64 },
+	{ &benchPortTx256Rx256, 256, 256 }
+};
+
+static const uint32 txNumProducers[] = { 1, 2, 4, 8, 16 };
+static const uint32 txMessageSizes[] = { 16, 64, 256 };
+static const uint32 txBufferSizes[] = { 256, 1024, 4096 };
+static const uint32 txBaudRates[] = { 9600, 115200, 921600 };
+
+static const uint32 rxBufferSizes[] = { 64, 256, 1024 };
+static const uint32 rxBurstSizes[] = { 32, 128, 512 };
+static const uint32 rxBaudRates[] = { 115200, 921600 };
+static const uint32 rxReaderDelays[] = { 0, 2, 10 };
+
+// State of the run in this process
+static UartCommsBackendPosix_t uartEmulator;
+static UartComms_Backend_t uartBackend;
+static UartComms_Port_t *benchPort;
+static portTickType numTicks = DEFAULT_NUM_TICKS;
+static txConfig_t txConfig;
+static rxConfig_t rxConfig;
+
+// TX scenario results
+static uint32 txNumSent;
+static uint32 txNumReceived;
+static uint32 txNumCorrupt;
+static uint32 latencyHistogram[LATENCY_HISTOGRAM_SIZE];
+static xTaskHandle producerTasks[16];
+
+// Baseline TX path, and its results
+static xQueueHandle baselineTxQueue;
+static xSemaphoreHandle baselineTxMutex;
+static xTaskHandle baselineTxTask;
+static uint32 baselineNumTxBytes;
+static uint32 baselineNumDropped;
+static portTickType baselineWaitTimeTotal;
+static portTickType baselineWaitTimeMax;
+
+// RX scenario results
+static uint32 rxNumInjected;
+static uint32 rxNumReceived;
+static xTaskHandle readerTask;
+
+//===============================================================================================//
+//===================================== PRIVATE FUNCTIONS =======================================//
+//===============================================================================================//
+
+//! @brief		Returns the port defined with the given buffer sizes
+static UartComms_Port_t* FindPort(uint32 txBufferSize, uint32 rxBufferSize)
+{
+	uint32 i;
+
+	for(i = 0; i < NUM_ELEMENTS(benchPorts); i++)
+	{
+		if((benchPorts[i].txBufferSize == txBufferSize) && (benchPorts[i].rxBufferSize == rxBufferSize))
+			return benchPorts[i].port;
+	}
+	return NULL;
+}
+
+//! @brief		Sets up the emulated UART and starts the port, call before creating other tasks
+static bool_t StartPort(uint32 txBufferSize, uint32 rxBufferSize, uint32 baudRate, uint32 fifoDepth, uint8 txTaskPriority)
+{
+	UartCommsBackendPosix_Config_t config = { UART_COMMS_POSIX_WIRE_LOOPBACK, baudRate, (uint8)fifoDepth, PRIORITY_EMULATOR };
+
+	benchPort = FindPort(txBufferSize, rxBufferSize);
+	if((benchPort == NULL) || (UartCommsBackendPosix_Init(&uartEmulator, &config, &uartBackend) == FALSE))
+		return FALSE;
+	VirtualKernel_SetHardwareTask(VirtualKernel_GetTaskByName("UART Emulator"));
+	UartComms_SetBackend(benchPort, &uartBackend);
+	return UartComms_Start(benchPort, configMINIMAL_STACK_SIZE, txTaskPriority);
+}
+
+//! @brief		Returns the latency (in ticks) which the given fraction of messages were within
+static uint32 LatencyPercentile(uint32 percent)
+{
+	uint32 target = (uint32)(((uint64_t)txNumReceived*percent + 99)/100);
+	uint32 count = 0;
+	uint32 bin;
+
+	for(bin = 0; bin < LATENCY_HISTOGRAM_SIZE; bin++)
+	{
+		count += latencyHistogram[bin];
+		if((count >= target) && (count != 0))
+			return bin;
+	}
+	return 0;
+}
+
+//! @brief		Host CPU time of a task per byte, in ns
+static double CpuNsPerByte(xTaskHandle task, uint32 numBytes)
+{
+	if((task == NULL) || (numBytes == 0))
+		return 0.0;
+	return (double)VirtualKernel_GetTaskCpuNs(task)/numBytes;
+}
+
+//===================================== BASELINE TX PATH ========================================//
+
+//! @brief		UartComms_PutString() as it was up to v1.1.0
+//! @details	Takes the TX mutex, then puts the string on the TX queue one byte at a time. A
+//!				byte which times out is dropped (v1.1.0 didn't check), here it is counted. The
+//!				time spent in here is counted as writer wait.
+static bool_t BaselinePutString(const char *string)
+{
+	portTickType startTime = xTaskGetTickCount();
+	portTickType waitTime;
+
+	// Take semaphore to allow placing things on queue
+	if(xSemaphoreTake(baselineTxMutex, BASELINE_TX_MAX_WAIT_TIME_MS/portTICK_RATE_MS) == pdFAIL)
+		return FALSE;
+
+	// Put characters onto tx queue one-by-one
+	while(*string != '\0')
+	{
+		if(xQueueSendToBack(baselineTxQueue, string, BASELINE_TX_MAX_WAIT_TIME_MS/portTICK_RATE_MS) == errQUEUE_FULL)
+			baselineNumDropped++;
+		string++;
+	}
+
+	// Return semaphore
+	xSemaphoreGive(baselineTxMutex);
+
+	waitTime = xTaskGetTickCount() - startTime;
+	baselineWaitTimeTotal += waitTime;
+	if(waitTime > baselineWaitTimeMax)
+		baselineWaitTimeMax = waitTime;
+	return TRUE;
+}
+
+//! @brief		UartComms_TxTask() as it was up to v1.1.0
+//! @details	Where v1.1.0 spun on the UART's status waiting for the last byte to go, this
+//!				polls once a tick, as the emulator's putChar() does for room in the FIFO, since
+//!				virtual time only moves on once every task is blocked. putChar()'s poll caps
+//!				throughput at one FIFO's worth of bytes per tick (4000 bytes/s), so the baseline
+//!				only keeps up with the offered load up to about 38400 baud.
+static void BaselineTxTask(void *pvParameters)
+{
+	typedef enum
+	{
+		ST_INIT,	//!< Initial state
+		ST_IDLE,	//!< Idle state. UART could be asleep in this state
+		ST_SENDING	//!< Sending state. UART is prevented from sleeping in this state until timeout
+	} txTaskState_t;
+
+	txTaskState_t txTaskState = ST_INIT;
+	char singleChar = 0;
+
+	(void)pvParameters;
+
+	for(;;)
+	{
+		switch(txTaskState)
+		{
+			case ST_INIT:
+				UartComms_SleepUnlock(benchPort);
+				txTaskState = ST_IDLE;
+				break;
+			case ST_IDLE:
+				xQueueReceive(baselineTxQueue, &singleChar, portMAX_DELAY);
+				UartComms_SleepLock(benchPort);
+				txTaskState = ST_SENDING;
+				break;
+			case ST_SENDING:
+				uartBackend.putChar(uartBackend.context, (uint8)singleChar);
+				baselineNumTxBytes++;
+
+				if(xQueueReceive(baselineTxQueue, &singleChar,
+					BASELINE_TIME_TO_WAIT_FOR_ANOTHER_CHAR_BEFORE_SLEEPING_MS/portTICK_RATE_MS) == errQUEUE_EMPTY)
+				{
+					while(!(uartBackend.readTxStatus(uartBackend.context) & UART_COMMS_TX_STS_COMPLETE))
+						vTaskDelay(1);
+					UartComms_SleepUnlock(benchPort);
+					txTaskState = ST_IDLE;
+				}
+				break;
+		}
+	}
+}
+
+//===================================== TX SCENARIO =============================================//
+
+//! @brief		Writes lines at its share of the offered load, waking at pseudo-random times
+static void ProducerTask(void *pvParameters)
+{
+	uint32 id = (uint32)(uintptr_t)pvParameters;
+	uint32 seed = 0x9E3779B9u*(id + 1);
+	uint32 numWritten = 0;
+	char message[300];
+
+	for(;;)
+	{
+		// Lines due by now, from this producer's share of TX_LOAD_PERCENT of the line
+		portTickType now = xTaskGetTickCount();
+		uint32 numDue = (uint32)(((uint64_t)now*txConfig.baudRate*TX_LOAD_PERCENT)
+			/((uint64_t)UART_COMMS_POSIX_BITS_PER_BYTE*100*configTICK_RATE_HZ*txConfig.messageSize*txConfig.numProducers));
+
+		while(numWritten < numDue)
+		{
+			int length = snprintf(message, sizeof(message), "%02x%04x%08x",
+				(unsigned)id, (unsigned)(numWritten & 0xFFFF), (unsigned)xTaskGetTickCount());
+			memset(&message[length], '.', txConfig.messageSize - 1 - length);
+			message[txConfig.messageSize - 1] = '\n';
+			message[txConfig.messageSize] = '\0';
+
+			if(((txConfig.isBaseline == TRUE) ? BaselinePutString(message) : UartComms_PutString(benchPort, message)) == TRUE)
+				txNumSent++;
+			numWritten++;
+		}
+
+		// Uniform in 1 to 2*PRODUCER_MEAN_PERIOD - 1 ticks
+		seed = seed*1664525u + 1013904223u;
+		vTaskDelay(1 + (seed >> 16) % (2*PRODUCER_MEAN_PERIOD - 1));
+	}
+}
+
+//! @brief		Reads lines back and records how long each took
+static void TxReaderTask(void *pvParameters)
+{
+	char line[300];
+
+	(void)pvParameters;
+
+	for(;;)
+	{
+		unsigned id, sequence, writeTime;
+		uint32 latency;
+
+		if(UartComms_ReadLine(benchPort, line, sizeof(line), portMAX_DELAY) == FALSE)
+			continue;
+
+		if((strlen(line) != txConfig.messageSize - 1)
+			|| (sscanf(line, "%2x%4x%8x", &id, &sequence, &writeTime) != 3))
+		{
+			txNumCorrupt++;
+			continue;
+		}
+
+		latency = xTaskGetTickCount() - writeTime;
+		if(latency >= LATENCY_HISTOGRAM_SIZE)
+			latency = LATENCY_HISTOGRAM_SIZE - 1;
+		latencyHistogram[latency]++;
+		txNumReceived++;
+	}
+}
+
+//! @brief		Runs one TX configuration and prints its results
+static int RunTx(void)
+{
+	uint8 txTaskPriority = (txConfig.isTxTaskAbove == TRUE) ? PRIORITY_PRODUCER + 1 : PRIORITY_PRODUCER - 1;
+	UartComms_Stats_t stats;
+	uint64_t producerCpuNs = 0;
+	uint32 numTxBytes, numDropped, numBytesReceived, numSwitches, i;
+	portTickType waitTimeTotal, waitTimeMax;
+	xTaskHandle txTask;
+	char highWaterMark[16];
+	double lineCapacity;
+
+	if((StartPort(txConfig.txBufferSize, 1024, txConfig.baudRate, FIFO_DEPTH, txTaskPriority) == FALSE)
+		|| (xTaskCreate(&TxReaderTask, (const signed portCHAR*)"Reader", configMINIMAL_STACK_SIZE,
+			NULL, PRIORITY_READER, NULL) != pdPASS))
+	{
+		return 1;
+	}
+	UartComms_SetTxOverflowPolicy(benchPort, UART_COMMS_TX_OVERFLOW_BLOCK);
+
+	if(txConfig.isBaseline == TRUE)
+	{
+		baselineTxQueue = xQueueCreate(txConfig.txBufferSize, 1);
+		baselineTxMutex = xSemaphoreCreateMutex();
+		if((baselineTxQueue == NULL) || (baselineTxMutex == NULL)
+			|| (xTaskCreate(&BaselineTxTask, (const signed portCHAR*)"Baseline TX Task", configMINIMAL_STACK_SIZE,
+				NULL, txTaskPriority, &baselineTxTask) != pdPASS))
+		{
+			return 1;
+		}
+	}
+
+	for(i = 0; i < txConfig.numProducers; i++)
+	{
+		if(xTaskCreate(&ProducerTask, (const signed portCHAR*)"Producer", configMINIMAL_STACK_SIZE,
+			(void*)(uintptr_t)i, PRIORITY_PRODUCER, &producerTasks[i]) != pdPASS)
+		{
+			return 1;
+		}
+	}
+
+	vTaskStartScheduler();
+
+	UartComms_GetStats(benchPort, &stats, FALSE);
+	if(txConfig.isBaseline == TRUE)
+	{
+		// The driver's own TX path is idle, the baseline has no TX ISR and its queue has no
+		// high water mark
+		numTxBytes = baselineNumTxBytes;
+		numDropped = baselineNumDropped;
+		waitTimeTotal = baselineWaitTimeTotal;
+		waitTimeMax = baselineWaitTimeMax;
+		txTask = baselineTxTask;
+		strcpy(highWaterMark, "null");
+	}
+	else
+	{
+		numTxBytes = stats.numTxBytes;
+		numDropped = UartComms_GetNumDroppedTx(benchPort);
+		waitTimeTotal = stats.txWaitTimeTotal;
+		waitTimeMax = stats.txWaitTimeMax;
+		txTask = UartComms_ReturnTxTaskHandle(benchPort);
+		snprintf(highWaterMark, sizeof(highWaterMark), "%u", (unsigned)stats.txBufferHighWaterMark);
+	}
+	numBytesReceived = txNumReceived*txConfig.messageSize;
+	numSwitches = VirtualKernel_GetNumContextSwitches();
+	for(i = 0; i < txConfig.numProducers; i++)
+		producerCpuNs += VirtualKernel_GetTaskCpuNs(producerTasks[i]);
+	lineCapacity = (double)txConfig.baudRate/UART_COMMS_POSIX_BITS_PER_BYTE*numTicks/configTICK_RATE_HZ;
+
+	printf("{\"scenario\":\"%s\",\"producers\":%u,\"messageSize\":%u,\"txBufferSize\":%u,\"baudRate\":%u,"
+		"\"txTaskPriority\":\"%s\",\"ticks\":%u,"
+		"\"sent\":%u,\"dropped\":%u,\"received\":%u,\"corrupt\":%u,"
+		"\"throughputBytesPerSec\":%.0f,\"lineUtilisation\":%.3f,"
+		"\"latencyP50Ms\":%u,\"latencyP90Ms\":%u,\"latencyP99Ms\":%u,\"latencyMaxMs\":%u,"
+		"\"writerWaitTotalMs\":%u,\"writerWaitMaxMs\":%u,\"txBufferHighWaterMark\":%s,"
+		"\"txIsrCallsPerByte\":%.4f,\"contextSwitchesPerByte\":%.4f,"
+		"\"cpuNsPerByteTxTask\":%.1f,\"cpuNsPerByteEmulator\":%.1f,\"cpuNsPerByteProducers\":%.1f}\n",
+		(txConfig.isBaseline == TRUE) ? "baseline" : "tx", (unsigned)txConfig.numProducers, (unsigned)txConfig.messageSize, (unsigned)txConfig.txBufferSize,
+		(unsigned)txConfig.baudRate, (txConfig.isTxTaskAbove == TRUE) ? "above" : "below", (unsigned)numTicks,
+		(unsigned)txNumSent, (unsigned)numDropped, (unsigned)txNumReceived, (unsigned)txNumCorrupt,
+		(double)numBytesReceived*configTICK_RATE_HZ/numTicks, numTxBytes/lineCapacity,
+		(unsigned)LatencyPercentile(50), (unsigned)LatencyPercentile(90), (unsigned)LatencyPercentile(99),
+		(unsigned)LatencyPercentile(100),
+		(unsigned)(waitTimeTotal*portTICK_RATE_MS), (unsigned)(waitTimeMax*portTICK_RATE_MS), highWaterMark,
+		(numTxBytes != 0) ? (double)stats.numTxIsrCalls/numTxBytes : 0.0,
+		(numTxBytes != 0) ? (double)numSwitches/numTxBytes : 0.0,
+		CpuNsPerByte(txTask, numTxBytes),
+		CpuNsPerByte(VirtualKernel_GetTaskByName("UART Emulator"), numTxBytes),
+		(numTxBytes != 0) ? (double)producerCpuNs/numTxBytes : 0.0);
+	return 0;
+}
+
+//===================================== RX SCENARIO =============================================//
+
+//! @brief		Reads RX_READ_SIZE bytes at a time, sleeping after each read
+static void RxReaderTask(void *pvParameters)
+{
+	uint8 data[RX_READ_SIZE];
+
+	(void)pvParameters;
+
+	// Nothing is sent, so keep the UART awake to receive, once the TX task has started and
+	// allowed it to sleep
+	vTaskDelay(1);
+	UartComms_SleepLock(benchPort);
+
+	for(;;)
+	{
+		rxNumReceived += UartComms_Read(benchPort, data, sizeof(data), portMAX_DELAY);
+		if(rxConfig.readerDelay != 0)
+			vTaskDelay(rxConfig.readerDelay);
+	}
+}
+
+//! @brief		Writes a trace file with a burst every RX_BURST_PERIOD ticks, to a temporary file
+//! @returns	TRUE on success, with the name in fileName
+static bool_t WriteRxTrace(char *fileName)
+{
+	UartCommsTrace_t trace;
+	uint8 *storage = malloc(RX_TRACE_STORAGE_SIZE);
+	uint8 burst[512];
+	uint8 header[UART_COMMS_TRACE_FILE_HEADER_SIZE];
+	uint32 tick, i, numBytes;
+	bool_t isOk;
+	FILE *file;
+	int fd;
+
+	fd = mkstemp(fileName);
+	if((storage == NULL) || (fd < 0))
+	{
+		free(storage);
+		return FALSE;
+	}
+	file = fdopen(fd, "wb");
+
+	for(i = 0; i < sizeof(burst); i++)
+		burst[i] = (uint8)('A' + i % 26);
+
+	// Bursts stop early enough for the last one to be read before the end of the run
+	UartCommsTrace_Init(&trace, storage, RX_TRACE_STORAGE_SIZE, 0);
+	for(tick = RX_BURST_PERIOD; tick + 2*RX_BURST_PERIOD <= numTicks; tick += RX_BURST_PERIOD)
+	{
+		UartCommsTrace_Write(&trace, UART_COMMS_TRACE_DIR_RX, tick, burst, rxConfig.burstSize);
+		rxNumInjected += rxConfig.burstSize;
+	}
+
+	UartCommsTrace_EncodeFileHeader(header, configTICK_RATE_HZ);
+	isOk = (fwrite(header, 1, sizeof(header), file) == sizeof(header)) ? TRUE : FALSE;
+	while((numBytes = UartCommsTrace_Read(&trace, storage, RX_TRACE_STORAGE_SIZE)) != 0)
+	{
+		if(fwrite(storage, 1, numBytes, file) != numBytes)
+			isOk = FALSE;
+	}
+	if(fclose(file) != 0)
+		isOk = FALSE;
+
+	free(storage);
+	return isOk;
+}
+
+//! @brief		Runs one RX configuration and prints its results
+static int RunRx(void)
+{
+	char fileName[] = "/tmp/UartCommsBenchXXXXXX";
+	UartComms_Stats_t stats;
+
+	if(WriteRxTrace(fileName) == FALSE)
+		return 1;
+
+	if((StartPort(256, rxConfig.rxBufferSize, rxConfig.baudRate, FIFO_DEPTH, PRIORITY_PRODUCER - 1) == FALSE)
+		|| (xTaskCreate(&RxReaderTask, (const signed portCHAR*)"Reader", configMINIMAL_STACK_SIZE,
+			NULL, PRIORITY_READER, &readerTask) != pdPASS)
+		|| (UartCommsBackendPosix_StartReplay(&uartEmulator, fileName, UART_COMMS_POSIX_REPLAY_REAL_TIME) == FALSE))
+	{
+		unlink(fileName);
+		return 1;
+	}
+	unlink(fileName);
+
+	vTaskStartScheduler();
+
+	UartComms_GetStats(benchPort, &stats, FALSE);
+
+	printf("{\"scenario\":\"rx\",\"rxBufferSize\":%u,\"burstSize\":%u,\"baudRate\":%u,"
+		"\"readerDelayTicks\":%u,\"ticks\":%u,"
+		"\"injected\":%u,\"received\":%u,\"rxBytesDropped\":%u,\"overrunErrors\":%u,"
+		"\"rxBufferHighWaterMark\":%u,\"rxIsrCalls\":%u,\"rxIsrMaxBytes\":%u,\"replayDone\":%s,"
+		"\"contextSwitchesPerByte\":%.4f,\"cpuNsPerByteEmulator\":%.1f,\"cpuNsPerByteReader\":%.1f}\n",
+		(unsigned)rxConfig.rxBufferSize, (unsigned)rxConfig.burstSize, (unsigned)rxConfig.baudRate,
+		(unsigned)rxConfig.readerDelay, (unsigned)numTicks,
+		(unsigned)rxNumInjected, (unsigned)rxNumReceived, (unsigned)stats.numRxBytesDropped,
+		(unsigned)stats.numOverrunErrors, (unsigned)stats.rxBufferHighWaterMark,
+		(unsigned)stats.numRxIsrCalls, (unsigned)stats.rxIsrMaxBytes,
+		(UartCommsBackendPosix_IsReplayDone(&uartEmulator) == TRUE) ? "true" : "false",
+		(rxNumReceived != 0) ? (double)VirtualKernel_GetNumContextSwitches()/rxNumReceived : 0.0,
+		CpuNsPerByte(VirtualKernel_GetTaskByName("UART Emulator"), rxNumReceived),
+		CpuNsPerByte(readerTask, rxNumReceived));
+	return 0;
+}
+
+//! @brief		Runs one configuration in a child process, so every run starts from scratch
+//! @returns	0 on success
+static int RunInChild(int (*run)(void))
+{
+	pid_t pid;
+	int status;
+
+	fflush(stdout);
+	pid = fork();
+	if(pid < 0)
+		return 1;
+	if(pid == 0)
+	{
+		VirtualKernel_Init(numTicks);
+		status = run();
+		fflush(stdout);
+		_exit(status);
+	}
+
+	if((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+		return 1;
+	return 0;
+}
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+int main(int argc, char **argv)
+{
+	const char *scenario = "all";
+	uint32 numFailed = 0;
+	uint32 a, b, c, d, e;
+	int option;
+
+	while((option = getopt(argc, argv, "s:t:")) != -1)
+	{
+		switch(option)
+		{
+			case 's':
+				scenario = optarg;
+				break;
+			case 't':
+				numTicks = (portTickType)strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-s tx|rx|all|baseline] [-t ticks]\n", argv[0]);
+				return 2;
+		}
+	}
+	if(((strcmp(scenario, "tx") != 0) && (strcmp(scenario, "rx") != 0) && (strcmp(scenario, "all") != 0)
+			&& (strcmp(scenario, "baseline") != 0))
+		|| (numTicks < 4*RX_BURST_PERIOD))
+	{
+		fprintf(stderr, "Usage: %s [-s tx|rx|all|baseline] [-t ticks]\n", argv[0]);
+		return 2;
+	}
+
+	if(strcmp(scenario, "rx") != 0)
+	{
+		for(a = 0; a < NUM_ELEMENTS(txNumProducers); a++)
+		for(b = 0; b < NUM_ELEMENTS(txMessageSizes); b++)
+		for(c = 0; c < NUM_ELEMENTS(txBufferSizes); c++)
+		for(d = 0; d < NUM_ELEMENTS(txBaudRates); d++)
+		for(e = 0; e < 2; e++)
+		{
+			txConfig.numProducers = txNumProducers[a];
+			txConfig.messageSize = txMessageSizes[b];
+			txConfig.txBufferSize = txBufferSizes[c];
+			txConfig.baudRate = txBaudRates[d];
+			txConfig.isTxTaskAbove = (e != 0) ? TRUE : FALSE;
+			txConfig.isBaseline = (strcmp(scenario, "baseline") == 0) ? TRUE : FALSE;
+			if(RunInChild(&RunTx) != 0)
+			{
+				fprintf(stderr, "TX run failed: %u producers, %u byte messages, %u byte tx buffer, %u baud\n",
+					(unsigned)txConfig.numProducers, (unsigned)txConfig.messageSize,
+					(unsigned)txConfig.txBufferSize, (unsigned)txConfig.baudRate);
+				numFailed++;
+			}
+		}
+	}
+
+	if((strcmp(scenario, "rx") == 0) || (strcmp(scenario, "all") == 0))
+	{
+		for(a = 0; a < NUM_ELEMENTS(rxBufferSizes); a++)
+		for(b = 0; b < NUM_ELEMENTS(rxBurstSizes); b++)
+		for(c = 0; c < NUM_ELEMENTS(rxBaudRates); c++)
+		for(d = 0; d < NUM_ELEMENTS(rxReaderDelays); d++)
+		{
+			rxConfig.rxBufferSize = rxBufferSizes[a];
+			rxConfig.burstSize = rxBurstSizes[b];
+			rxConfig.baudRate = rxBaudRates[c];
+			rxConfig.readerDelay = rxReaderDelays[d];
+			if(RunInChild(&RunRx) != 0)
+			{
+				fprintf(stderr, "RX run failed: %u byte rx buffer, %u byte bursts, %u baud\n",
+					(unsigned)rxConfig.rxBufferSize, (unsigned)rxConfig.burstSize, (unsigned)rxConfig.baudRate);
+				numFailed++;
+			}
+		}
+	}
+
+	return (numFailed == 0) ? 0 : 1;
+}
+
+// EOF
@@ -0,0 +1,35 @@
+//!
+//! @file 		UartDebug.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Debug UART used by UartComms, which the benchmark throws away
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+#ifndef UART_DEBUG_H
+#define UART_DEBUG_H
+
+#include "PublicDefinesAndTypeDefs.h"
+
+static inline bool_t UartDebug_PutString(const char *string)
+{
+	(void)string;
+	return TRUE;
+}
+
+#endif // #ifndef UART_DEBUG_H
+
+// EOF
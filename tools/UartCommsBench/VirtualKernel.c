@@ -0,0 +1,674 @@
+//!
+//! @file 		VirtualKernel.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		See VirtualKernel.h
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		See VirtualKernel.h for a detailed description on this module.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// Needed for clock_gettime()
+#define _GNU_SOURCE
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+// User includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "VirtualKernel.h"
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Most tasks in one run
+#define MAX_NUM_TASKS							(64)
+
+//! Host stack of every task, in bytes. Stack depths given to xTaskCreate() are ignored.
+#define TASK_STACK_SIZE							(256*1024)
+
+//! Most task switches, or kernel calls by one task without a switch, before the tick moves on.
+//! Any more and the run is taken to be stuck: a task which spins never lets virtual time pass.
+#define MAX_STEPS_PER_TICK						(10000000)
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! A binary semaphore
+typedef struct
+{
+	uint8_t isGiven;
+} semaphore_t;
+
+//! A queue. Tasks waiting to receive wait on notEmpty, tasks waiting to send on notFull.
+typedef struct
+{
+	uint8_t *storage;
+	uint32_t length;					//!< Most items it holds
+	uint32_t itemSize;
+	uint32_t head;						//!< Index of the oldest item
+	uint32_t count;
+	semaphore_t notEmpty;
+	semaphore_t notFull;
+} queue_t;
+
+//! State of a task
+typedef enum
+{
+	TASK_READY,							//!< Running or ready to run
+	TASK_BLOCKED,						//!< Waiting for a semaphore, a timeout or both
+	TASK_DELETED						//!< Task function returned
+} taskState_t;
+
+//! A task
+typedef struct
+{
+	ucontext_t context;
+	void *stack;
+	const char *name;
+	pdTASK_CODE code;
+	void *parameters;
+	unsigned portBASE_TYPE priority;
+	taskState_t state;
+	uint64_t sequence;					//!< When it became ready or blocked, orders tasks of equal priority
+	semaphore_t *waitingOn;				//!< Semaphore it is blocked on, NULL for a delay
+	uint8_t hasTimeout;					//!< 1 if it is woken at wakeTick
+	portTickType wakeTick;
+	signed portBASE_TYPE takeResult;	//!< What xSemaphoreTake() returns once it is woken
+	uint64_t cpuNs;						//!< Host CPU time taken so far
+} task_t;
+
+//===============================================================================================//
+//============================= PRIVATE VARIABLES/STRUCTURES ====================================//
+//===============================================================================================//
+
+static task_t _tasks[MAX_NUM_TASKS];
+static uint32_t _numTasks = 0;
+static task_t *_currentTask = NULL;
+static task_t *_lastTask = NULL;
+static ucontext_t _schedulerContext;
+static portTickType _tick = 0;
+static portTickType _endTick = portMAX_DELAY;
+static uint64_t _sequence = 0;
+static uint32_t _criticalNesting = 0;
+static uint8_t _isYieldPending = 0;
+static uint32_t _numContextSwitches = 0;
+static uint32_t _numStepsThisTick = 0;
+static task_t *_hardwareTask = NULL;
+static uint8_t _isHardwarePreempted = 0;
+
+//===============================================================================================//
+//================================== PRIVATE FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+static void 	VirtualKernel_TaskEntry(int taskIndex);
+static void 	VirtualKernel_Yield(void);
+static void 	VirtualKernel_MakeReady(task_t *task);
+static void 	VirtualKernel_Block(semaphore_t *semaphore, portTickType blockTime);
+static void 	VirtualKernel_SwitchIfHigher(task_t *woken);
+static task_t* 	VirtualKernel_Give(semaphore_t *semaphore, signed portBASE_TYPE *result);
+static task_t* 	VirtualKernel_WakeWaiter(semaphore_t *semaphore);
+static uint8_t 	VirtualKernel_WaitOnQueue(semaphore_t *semaphore, portTickType endTick, uint8_t hasTimeout);
+static task_t* 	VirtualKernel_PickReady(void);
+static uint8_t 	VirtualKernel_AdvanceTick(void);
+static uint64_t VirtualKernel_CpuNs(void);
+static void 	VirtualKernel_CheckProgress(void);
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+void VirtualKernel_Init(portTickType endTick)
+{
+	_endTick = endTick;
+}
+
+
+uint64_t VirtualKernel_GetTaskCpuNs(xTaskHandle task)
+{
+	return ((task_t*)task)->cpuNs;
+}
+
+
+uint32_t VirtualKernel_GetNumContextSwitches(void)
+{
+	return _numContextSwitches;
+}
+
+
+void VirtualKernel_SetHardwareTask(xTaskHandle task)
+{
+	_hardwareTask = (task_t*)task;
+}
+
+
+xTaskHandle VirtualKernel_GetTaskByName(const char *name)
+{
+	uint32_t i;
+
+	for(i = 0; i < _numTasks; i++)
+	{
+		if(strcmp(_tasks[i].name, name) == 0)
+			return &_tasks[i];
+	}
+	return NULL;
+}
+
+//===================================== FREERTOS FUNCTIONS ======================================//
+
+signed portBASE_TYPE xTaskCreate(
+	pdTASK_CODE taskCode,
+	const signed portCHAR *name,
+	unsigned short stackDepth,
+	void *parameters,
+	unsigned portBASE_TYPE priority,
+	xTaskHandle *createdTask)
+{
+	task_t *task;
+
+	(void)stackDepth;
+
+	if(_numTasks == MAX_NUM_TASKS)
+		return pdFAIL;
+	task = &_tasks[_numTasks];
+	task->stack = malloc(TASK_STACK_SIZE);
+	if(task->stack == NULL)
+		return pdFAIL;
+
+	getcontext(&task->context);
+	task->context.uc_stack.ss_sp = task->stack;
+	task->context.uc_stack.ss_size = TASK_STACK_SIZE;
+	task->context.uc_link = &_schedulerContext;
+	makecontext(&task->context, (void (*)(void))&VirtualKernel_TaskEntry, 1, (int)_numTasks);
+	_numTasks++;
+
+	task->name = (const char*)name;
+	task->code = taskCode;
+	task->parameters = parameters;
+	task->priority = (priority < configMAX_PRIORITIES) ? priority : configMAX_PRIORITIES - 1;
+	task->cpuNs = 0;
+	VirtualKernel_MakeReady(task);
+
+	if(createdTask != NULL)
+		*createdTask = task;
+
+	VirtualKernel_SwitchIfHigher(task);
+	return pdPASS;
+}
+
+
+portTickType xTaskGetTickCount(void)
+{
+	VirtualKernel_CheckProgress();
+	return _tick;
+}
+
+
+portTickType xTaskGetTickCountFromISR(void)
+{
+	return _tick;
+}
+
+
+void vTaskDelay(portTickType ticksToDelay)
+{
+	if(_currentTask == NULL)
+		return;
+
+	if(ticksToDelay == 0)
+	{
+		// Go behind the other ready tasks of the same priority
+		_currentTask->sequence = ++_sequence;
+	}
+	else
+	{
+		VirtualKernel_Block(NULL, ticksToDelay);
+	}
+	VirtualKernel_Yield();
+}
+
+
+void vTaskSuspendAll(void)
+{
+	_criticalNesting++;
+}
+
+
+signed portBASE_TYPE xTaskResumeAll(void)
+{
+	vPortExitCritical();
+	return pdFALSE;
+}
+
+
+void vTaskStartScheduler(void)
+{
+	for(;;)
+	{
+		task_t *task = VirtualKernel_PickReady();
+		uint64_t startNs;
+
+		if(task == NULL)
+		{
+			if(VirtualKernel_AdvanceTick() == 0)
+				return;
+			continue;
+		}
+
+		_currentTask = task;
+		VirtualKernel_CheckProgress();
+		if(task != _lastTask)
+			_numContextSwitches++;
+		_lastTask = task;
+
+		startNs = VirtualKernel_CpuNs();
+		swapcontext(&_schedulerContext, &task->context);
+		task->cpuNs += VirtualKernel_CpuNs() - startNs;
+
+		_currentTask = NULL;
+	}
+}
+
+
+void vPortEnterCritical(void)
+{
+	_criticalNesting++;
+}
+
+
+void vPortExitCritical(void)
+{
+	_criticalNesting--;
+	if((_criticalNesting == 0) && (_isYieldPending != 0))
+	{
+		_isYieldPending = 0;
+		VirtualKernel_Yield();
+	}
+}
+
+
+void vPortYieldFromIsr(void)
+{
+	// The interrupt stopped the CPU, not the hardware, so the hardware carries on once the
+	// tasks woken have run
+	if((_currentTask != NULL) && (_currentTask == _hardwareTask))
+		_isHardwarePreempted = 1;
+
+	if(_criticalNesting != 0)
+		_isYieldPending = 1;
+	else
+		VirtualKernel_Yield();
+}
+
+
+xSemaphoreHandle xVirtualKernel_CreateBinarySemaphore(void)
+{
+	semaphore_t *semaphore = malloc(sizeof(semaphore_t));
+
+	if(semaphore != NULL)
+		semaphore->isGiven = 1;
+	return semaphore;
+}
+
+
+signed portBASE_TYPE xSemaphoreTake(xSemaphoreHandle semaphore, portTickType blockTime)
+{
+	semaphore_t *binary = (semaphore_t*)semaphore;
+
+	VirtualKernel_CheckProgress();
+	if(binary->isGiven != 0)
+	{
+		binary->isGiven = 0;
+		return pdTRUE;
+	}
+	if((blockTime == 0) || (_currentTask == NULL))
+		return pdFALSE;
+
+	VirtualKernel_Block(binary, blockTime);
+	VirtualKernel_Yield();
+	return _currentTask->takeResult;
+}
+
+
+signed portBASE_TYPE xSemaphoreGive(xSemaphoreHandle semaphore)
+{
+	signed portBASE_TYPE result;
+	task_t *woken = VirtualKernel_Give((semaphore_t*)semaphore, &result);
+
+	if(woken != NULL)
+		VirtualKernel_SwitchIfHigher(woken);
+	return result;
+}
+
+
+signed portBASE_TYPE xSemaphoreGiveFromISR(xSemaphoreHandle semaphore, signed portBASE_TYPE *higherPriorityTaskWoken)
+{
+	signed portBASE_TYPE result;
+	task_t *woken = VirtualKernel_Give((semaphore_t*)semaphore, &result);
+
+	if((woken != NULL) && (_currentTask != NULL) && (higherPriorityTaskWoken != NULL)
+		&& ((woken->priority > _currentTask->priority) || (_currentTask == _hardwareTask)))
+	{
+		*higherPriorityTaskWoken = pdTRUE;
+	}
+	return result;
+}
+
+xQueueHandle xQueueCreate(unsigned portBASE_TYPE queueLength, unsigned portBASE_TYPE itemSize)
+{
+	queue_t *queue = malloc(sizeof(queue_t));
+
+	if(queue == NULL)
+		return NULL;
+	queue->storage = malloc(queueLength*itemSize);
+	if(queue->storage == NULL)
+	{
+		free(queue);
+		return NULL;
+	}
+	queue->length = queueLength;
+	queue->itemSize = itemSize;
+	queue->head = 0;
+	queue->count = 0;
+	queue->notEmpty.isGiven = 0;
+	queue->notFull.isGiven = 0;
+	return queue;
+}
+
+
+signed portBASE_TYPE xQueueSendToBack(xQueueHandle queue, const void *item, portTickType blockTime)
+{
+	queue_t *fifo = (queue_t*)queue;
+	portTickType endTick = _tick + blockTime;
+
+	for(;;)
+	{
+		VirtualKernel_CheckProgress();
+		if(fifo->count < fifo->length)
+		{
+			task_t *woken;
+
+			memcpy(&fifo->storage[((fifo->head + fifo->count) % fifo->length)*fifo->itemSize], item, fifo->itemSize);
+			fifo->count++;
+			woken = VirtualKernel_WakeWaiter(&fifo->notEmpty);
+			if(woken != NULL)
+				VirtualKernel_SwitchIfHigher(woken);
+			return pdTRUE;
+		}
+		if((blockTime == 0) || (_currentTask == NULL)
+			|| (VirtualKernel_WaitOnQueue(&fifo->notFull, endTick, (blockTime != portMAX_DELAY) ? 1 : 0) == 0))
+		{
+			return errQUEUE_FULL;
+		}
+	}
+}
+
+
+signed portBASE_TYPE xQueueReceive(xQueueHandle queue, void *buffer, portTickType blockTime)
+{
+	queue_t *fifo = (queue_t*)queue;
+	portTickType endTick = _tick + blockTime;
+
+	for(;;)
+	{
+		VirtualKernel_CheckProgress();
+		if(fifo->count != 0)
+		{
+			task_t *woken;
+
+			memcpy(buffer, &fifo->storage[fifo->head*fifo->itemSize], fifo->itemSize);
+			fifo->head = (fifo->head + 1) % fifo->length;
+			fifo->count--;
+			woken = VirtualKernel_WakeWaiter(&fifo->notFull);
+			if(woken != NULL)
+				VirtualKernel_SwitchIfHigher(woken);
+			return pdTRUE;
+		}
+		if((blockTime == 0) || (_currentTask == NULL)
+			|| (VirtualKernel_WaitOnQueue(&fifo->notEmpty, endTick, (blockTime != portMAX_DELAY) ? 1 : 0) == 0))
+		{
+			return errQUEUE_EMPTY;
+		}
+	}
+}
+
+//===============================================================================================//
+//==================================== PRIVATE FUNCTIONS ========================================//
+//===============================================================================================//
+
+//! @brief		Runs a task's function. A task which returns is deleted.
+//! @private
+static void VirtualKernel_TaskEntry(int taskIndex)
+{
+	task_t *task = &_tasks[taskIndex];
+
+	task->code(task->parameters);
+	task->state = TASK_DELETED;
+	// Returns to the scheduler through uc_link
+}
+
+
+//! @brief		Hands back to the scheduler, which runs the highest priority ready task
+//! @private
+static void VirtualKernel_Yield(void)
+{
+	if(_currentTask != NULL)
+		swapcontext(&_currentTask->context, &_schedulerContext);
+}
+
+
+//! @private
+static void VirtualKernel_MakeReady(task_t *task)
+{
+	task->state = TASK_READY;
+	task->waitingOn = NULL;
+	task->hasTimeout = 0;
+	task->sequence = ++_sequence;
+}
+
+
+//! @brief		Blocks the current task on a semaphore (or NULL) for up to blockTime ticks
+//! @private
+static void VirtualKernel_Block(semaphore_t *semaphore, portTickType blockTime)
+{
+	task_t *task = _currentTask;
+
+	task->state = TASK_BLOCKED;
+	task->waitingOn = semaphore;
+	task->hasTimeout = (blockTime != portMAX_DELAY) ? 1 : 0;
+	task->wakeTick = _tick + blockTime;
+	task->takeResult = pdFALSE;
+	task->sequence = ++_sequence;
+}
+
+
+//! @brief		Switches to a task just made ready if it has a higher priority, at the end of the
+//!				critical section if in one
+//! @private
+static void VirtualKernel_SwitchIfHigher(task_t *woken)
+{
+	if((_currentTask == NULL) || (woken->priority <= _currentTask->priority))
+		return;
+
+	if(_criticalNesting != 0)
+		_isYieldPending = 1;
+	else
+		VirtualKernel_Yield();
+}
+
+
+//! @brief		Gives a semaphore, to the highest priority task waiting for it if there is one
+//! @returns	The task woken, or NULL
+//! @private
+static task_t* VirtualKernel_Give(semaphore_t *semaphore, signed portBASE_TYPE *result)
+{
+	task_t *woken = VirtualKernel_WakeWaiter(semaphore);
+
+	if(woken != NULL)
+	{
+		*result = pdTRUE;
+		return woken;
+	}
+
+	// Already given, a binary semaphore can't be given twice
+	*result = (semaphore->isGiven != 0) ? pdFAIL : pdTRUE;
+	semaphore->isGiven = 1;
+	return NULL;
+}
+
+
+//! @brief		Wakes the highest priority task waiting on a semaphore (or one side of a queue),
+//!				the one waiting longest if there are several
+//! @returns	The task woken, or NULL if none was waiting
+//! @private
+static task_t* VirtualKernel_WakeWaiter(semaphore_t *semaphore)
+{
+	task_t *woken = NULL;
+	uint32_t i;
+
+	for(i = 0; i < _numTasks; i++)
+	{
+		task_t *task = &_tasks[i];
+		if((task->state == TASK_BLOCKED) && (task->waitingOn == semaphore)
+			&& ((woken == NULL) || (task->priority > woken->priority)
+				|| ((task->priority == woken->priority) && (task->sequence < woken->sequence))))
+		{
+			woken = task;
+		}
+	}
+
+	if(woken != NULL)
+	{
+		VirtualKernel_MakeReady(woken);
+		woken->takeResult = pdTRUE;
+	}
+	return woken;
+}
+
+
+//! @brief		Blocks the current task on one side of a queue until it is woken or endTick
+//! @details	Like FreeRTOS, a task which is woken tries again, and only waits for what is
+//!				left of its block time if another task got there first.
+//! @returns	0 if it timed out, otherwise 1
+//! @private
+static uint8_t VirtualKernel_WaitOnQueue(semaphore_t *semaphore, portTickType endTick, uint8_t hasTimeout)
+{
+	if(hasTimeout != 0)
+	{
+		if((int32_t)(endTick - _tick) <= 0)
+			return 0;
+		VirtualKernel_Block(semaphore, endTick - _tick);
+	}
+	else
+	{
+		VirtualKernel_Block(semaphore, portMAX_DELAY);
+	}
+	VirtualKernel_Yield();
+	return (_currentTask->takeResult == pdTRUE) ? 1 : 0;
+}
+
+
+//! @brief		Returns the highest priority ready task, the one ready longest if there are several
+//! @details	A hardware task preempted by its own interrupt only runs again once no other task
+//!				is ready.
+//! @private
+static task_t* VirtualKernel_PickReady(void)
+{
+	task_t *best = NULL;
+	uint32_t i;
+
+	for(i = 0; i < _numTasks; i++)
+	{
+		task_t *task = &_tasks[i];
+		if((task->state == TASK_READY) && ((task != _hardwareTask) || (_isHardwarePreempted == 0))
+			&& ((best == NULL) || (task->priority > best->priority)
+				|| ((task->priority == best->priority) && (task->sequence < best->sequence))))
+		{
+			best = task;
+		}
+	}
+
+	if((best == NULL) && (_isHardwarePreempted != 0))
+	{
+		_isHardwarePreempted = 0;
+		best = _hardwareTask;
+	}
+	return best;
+}
+
+
+//! @brief		Moves the tick on to the next timeout, and wakes every task due then
+//! @returns	0 once the end tick is reached (or nothing will ever wake up), otherwise 1
+//! @private
+static uint8_t VirtualKernel_AdvanceTick(void)
+{
+	portTickType nextTick = _endTick;
+	uint32_t i;
+
+	for(i = 0; i < _numTasks; i++)
+	{
+		if((_tasks[i].state == TASK_BLOCKED) && (_tasks[i].hasTimeout != 0) && (_tasks[i].wakeTick < nextTick))
+			nextTick = _tasks[i].wakeTick;
+	}
+
+	_tick = nextTick;
+	_numStepsThisTick = 0;
+	if(_tick >= _endTick)
+		return 0;
+
+	for(i = 0; i < _numTasks; i++)
+	{
+		if((_tasks[i].state == TASK_BLOCKED) && (_tasks[i].hasTimeout != 0) && (_tasks[i].wakeTick <= _tick))
+			VirtualKernel_MakeReady(&_tasks[i]);
+	}
+	return 1;
+}
+
+
+//! @brief		Aborts the run if the tick has been stuck for MAX_STEPS_PER_TICK steps
+//! @private
+static void VirtualKernel_CheckProgress(void)
+{
+	if(++_numStepsThisTick <= MAX_STEPS_PER_TICK)
+		return;
+
+	fprintf(stderr, "VirtualKernel: stuck at tick %u, \"%s\" keeps running without blocking\n",
+		(unsigned)_tick, (_currentTask != NULL) ? _currentTask->name : "main");
+	abort();
+}
+
+
+//! @brief		Host CPU time of this thread, in ns
+//! @private
+static uint64_t VirtualKernel_CpuNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	return (uint64_t)now.tv_sec*1000000000u + (uint64_t)now.tv_nsec;
+}
+
+// EOF
@@ -0,0 +1,77 @@
+//!
+//! @file 		VirtualKernel.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Deterministic virtual-time scheduler behind the benchmark's FreeRTOS API
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Runs FreeRTOS tasks as coroutines (ucontext) on one host thread, with the same
+//!		fixed-priority preemptive rules as FreeRTOS: the highest priority ready task runs,
+//!		tasks of equal priority run in the order they became ready, and giving a semaphore
+//!		or queue item to a higher priority task switches to it straight away (or at the end
+//!		of the critical section). Code takes no virtual time, the tick only moves on when every
+//!		task is blocked, and then straight to the next timeout. A run is therefore the same
+//!		every time, whatever the host is doing, and runs much faster than real time.
+//!
+//!		The POSIX backend's emulator task (baud rate, FIFO depth and interrupts) runs on it
+//!		unchanged. Mark it with VirtualKernel_SetHardwareTask(): an emulated interrupt which
+//!		wakes a task then lets the tasks run straight away, part way through the tick, before
+//!		the emulator carries on clocking bytes, as the CPU would while the UART kept shifting.
+//!		Without it the TX task could only start one write per tick, which would cap the
+//!		throughput of short writes at high baud rates.
+//!
+//!		The host CPU time each task takes is measured on every switch. A run in
+//!		which the tasks never all block (so virtual time would stop) is aborted.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added queues (queue.h) and xSemaphoreCreateMutex().
+//!
+
+#ifndef VIRTUAL_KERNEL_H
+#define VIRTUAL_KERNEL_H
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+//===============================================================================================//
+//=================================== PUBLIC FUNCTION PROTOTYPES ================================//
+//===============================================================================================//
+
+//! @brief		Sets the tick vTaskStartScheduler() returns at
+//! @note		Call before creating any tasks. Only one run per process.
+void 		VirtualKernel_Init(portTickType endTick);
+
+//! @brief		Host CPU time (in ns) a task has taken so far
+uint64_t 	VirtualKernel_GetTaskCpuNs(xTaskHandle task);
+
+//! @brief		Number of context switches so far
+uint32_t 	VirtualKernel_GetNumContextSwitches(void);
+
+//! @brief		Marks the task which emulates hardware (see above)
+void 		VirtualKernel_SetHardwareTask(xTaskHandle task);
+
+//! @brief		Finds a task by the name it was created with, e.g. to measure a task created
+//!				inside a driver
+//! @returns	The task, or NULL if there isn't one
+xTaskHandle VirtualKernel_GetTaskByName(const char *name);
+
+#endif // #ifndef VIRTUAL_KERNEL_H
+
+// EOF
@@ -0,0 +1,40 @@
+//!
+//! @file 		queue.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		FreeRTOS queue API implemented by the benchmark's virtual-time kernel
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added xQueueCreate(), xQueueSendToBack() and xQueueReceive(), for the
+//!				queue of single bytes (UartComms v1.1.0) the benchmark measures as a baseline.
+//!
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef void * xQueueHandle;
+
+#define errQUEUE_EMPTY							(0)
+#define errQUEUE_FULL							(0)
+
+xQueueHandle xQueueCreate(unsigned portBASE_TYPE queueLength, unsigned portBASE_TYPE itemSize);
+signed portBASE_TYPE xQueueSendToBack(xQueueHandle queue, const void *item, portTickType blockTime);
+signed portBASE_TYPE xQueueReceive(xQueueHandle queue, void *buffer, portTickType blockTime);
+
+#endif // #ifndef QUEUE_H
+
+// EOF
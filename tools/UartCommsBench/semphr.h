@@ -0,0 +1,42 @@
+//!
+//! @file 		semphr.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		FreeRTOS binary semaphore API implemented by the benchmark's virtual-time kernel
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.1.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!			v1.1.0 -> Added xSemaphoreCreateMutex().
+//!
+
+#ifndef SEMPHR_H
+#define SEMPHR_H
+
+#include "queue.h"
+
+typedef xQueueHandle xSemaphoreHandle;
+
+//! Creates a binary semaphore, given (as in FreeRTOS v7), or 0 if out of memory
+xSemaphoreHandle xVirtualKernel_CreateBinarySemaphore(void);
+#define vSemaphoreCreateBinary(semaphore)		do { (semaphore) = xVirtualKernel_CreateBinarySemaphore(); } while(0)
+//! A binary semaphore, without priority inheritance
+#define xSemaphoreCreateMutex()					xVirtualKernel_CreateBinarySemaphore()
+
+signed portBASE_TYPE xSemaphoreTake(xSemaphoreHandle semaphore, portTickType blockTime);
+signed portBASE_TYPE xSemaphoreGive(xSemaphoreHandle semaphore);
+signed portBASE_TYPE xSemaphoreGiveFromISR(xSemaphoreHandle semaphore, signed portBASE_TYPE *higherPriorityTaskWoken);
+
+#endif // #ifndef SEMPHR_H
+
+// EOF
@@ -0,0 +1,49 @@
+//!
+//! @file 		task.h
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		FreeRTOS task API subset implemented by the benchmark's virtual-time kernel
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void * xTaskHandle;
+typedef void (*pdTASK_CODE)(void *pvParameters);
+
+#define taskENTER_CRITICAL()					vPortEnterCritical()
+#define taskEXIT_CRITICAL()						vPortExitCritical()
+
+signed portBASE_TYPE xTaskCreate(
+	pdTASK_CODE taskCode,
+	const signed portCHAR *name,
+	unsigned short stackDepth,
+	void *parameters,
+	unsigned portBASE_TYPE priority,
+	xTaskHandle *createdTask);
+portTickType xTaskGetTickCount(void);
+portTickType xTaskGetTickCountFromISR(void);
+void vTaskDelay(portTickType ticksToDelay);
+void vTaskSuspendAll(void);
+signed portBASE_TYPE xTaskResumeAll(void);
+void vTaskStartScheduler(void);
+
+#endif // #ifndef TASK_H
+
+// EOF
@@ -0,0 +1,241 @@
+//!
+//! @file 		UartCommsLogTool.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Host tool which formats the log records sent by UartComms_Log()
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Build (with the same format table as the target):
+//!			gcc -O2 -Isrc -o UartCommsLogTool tools/UartCommsLogTool.c src/UartCommsLog.c src/UartCommsFrame.c
+//!		or, for an application's own table:
+//!			gcc -O2 -Isrc -Iapp -DconfigUART_COMMS_LOG_FORMATS='"AppLogFormats.def"' ...
+//!
+//!		Usage:
+//!			UartCommsLogTool [-c channel] [-r tickRate] < capture.bin > log.txt
+//!				Decodes a capture of the UART (e.g. from a pseudo-terminal or logic analyser).
+//!				Log record frames are formatted, with the time they were logged in front,
+//!				in ticks or, with -r, in seconds. Everything else (plain text) is passed
+//!				through. Frames which fail the CRC are dropped, and decoding picks up again
+//!				at the next delimiter. A summary, including how many bytes the records
+//!				saved, is printed to stderr.
+//!
+//!		channel must match configUART_COMMS_LOG_CHANNEL on the target. With compression on,
+//!		decompress first: UartCommsLzssTool < capture.bin | UartCommsLogTool
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// User includes
+#include "UartCommsLog.h"
+#include "UartCommsFrame.h"
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Default, the same as UartComms.h
+#define DEFAULT_CHANNEL							(0xFE)
+
+//! Largest payload of a log record frame (channel ID and record)
+#define MAX_PAYLOAD_SIZE						(1 + UART_COMMS_LOG_RECORD_SIZE(UART_COMMS_LOG_MAX_ARGS))
+
+//! Largest log record frame on the wire
+#define MAX_FRAME_SIZE							(UART_COMMS_FRAME_MAX_ENCODED_SIZE(MAX_PAYLOAD_SIZE))
+
+//! Longest formatted record
+#define MAX_TEXT_LENGTH							(1024)
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! What the decoder found
+typedef struct
+{
+	unsigned long numRecords;			//!< Records formatted
+	unsigned long numRecordBytes;		//!< Bytes those records took on the wire, with both delimiters
+	unsigned long numTextBytes;			//!< Bytes of text they were formatted into
+	unsigned long numRawBytes;			//!< Bytes passed through as they were
+	unsigned long numBadRecords;		//!< Records which passed the CRC but couldn't be parsed, or had an unknown format ID
+} decodeStats_t;
+
+//===============================================================================================//
+//=================================== PRIVATE VARIABLES =========================================//
+//===============================================================================================//
+
+//! Format strings, indexed by format ID
+static const char * const formats[] =
+{
+	#define UART_COMMS_LOG_FORMAT(id, format)	format,
+	#include configUART_COMMS_LOG_FORMATS
+	#undef UART_COMMS_LOG_FORMAT
+};
+
+//===============================================================================================//
+//===================================== PRIVATE FUNCTIONS =======================================//
+//===============================================================================================//
+
+//! @brief		Formats a record, with the time it was logged in front
+//! @details	A record with a format ID which isn't in the table (the tool was built with a
+//!				different table to the target) is printed as its ID and arguments.
+//! @returns	Number of bytes of text written, 0 if its format ID isn't in the table
+static uint32 FormatRecord(const UartCommsLog_Record_t *record, double tickRate, FILE *out)
+{
+	static char text[MAX_TEXT_LENGTH];
+	uint32 length;
+	uint32 i;
+
+	if(tickRate > 0)
+		fprintf(out, "[%10.3f] ", record->time/tickRate);
+	else
+		fprintf(out, "[%10u] ", record->time);
+
+	if(record->formatId >= sizeof(formats)/sizeof(formats[0]))
+	{
+		fprintf(out, "(format %u isn't in the table", record->formatId);
+		for(i = 0; i < record->numArgs; i++)
+			fprintf(out, "%s 0x%08X", (i == 0) ? ", arguments" : "", record->args[i]);
+		fprintf(out, ")\r\n");
+		return 0;
+	}
+
+	length = UartCommsLog_Format(text, sizeof(text), formats[record->formatId], record->args, record->numArgs);
+	fwrite(text, 1, length, out);
+	return length;
+}
+
+//! @brief		Decodes the bytes between two delimiters
+//! @details	A segment which is a good frame on the log channel is formatted, anything else
+//!				is raw output and is written as it is.
+static void DecodeSegment(const uint8 *segment, uint32 length, uint8 channel, double tickRate, FILE *out, decodeStats_t *stats)
+{
+	static uint8 payload[MAX_PAYLOAD_SIZE + UART_COMMS_FRAME_CRC_SIZE];
+	UartCommsFrameDecoder_t decoder;
+	UartCommsLog_Record_t record;
+	uint32 i;
+
+	if(length == 0)
+		return;
+
+	UartCommsFrameDecoder_Init(&decoder, payload, sizeof(payload));
+	for(i = 0; i < length; i++)
+		UartCommsFrameDecoder_Feed(&decoder, segment[i]);
+
+	if((UartCommsFrameDecoder_Feed(&decoder, UART_COMMS_FRAME_DELIMITER) == UART_COMMS_FRAME_COMPLETE)
+		&& (decoder.length >= 1) && (payload[0] == channel))
+	{
+		uint32 textLength;
+
+		if(UartCommsLog_ParseRecord(&payload[1], decoder.length - 1, &record) == 0)
+		{
+			// Not from UartComms_Log(), so not text either
+			stats->numBadRecords++;
+			return;
+		}
+
+		textLength = FormatRecord(&record, tickRate, out);
+		if(textLength == 0)
+		{
+			stats->numBadRecords++;
+			return;
+		}
+
+		stats->numRecords++;
+		stats->numRecordBytes += length + 2;
+		stats->numTextBytes += textLength;
+		return;
+	}
+
+	fwrite(segment, 1, length, out);
+	stats->numRawBytes += length;
+}
+
+//! @brief		Decodes a capture from in to out
+static void Decode(FILE *in, FILE *out, uint8 channel, double tickRate, decodeStats_t *stats)
+{
+	static uint8 segment[MAX_FRAME_SIZE];
+	uint32 length = 0;
+	int byte;
+
+	while((byte = fgetc(in)) != EOF)
+	{
+		if(byte == UART_COMMS_FRAME_DELIMITER)
+		{
+			DecodeSegment(segment, length, channel, tickRate, out, stats);
+			length = 0;
+			continue;
+		}
+
+		// Longer than any frame, so it's raw output
+		if(length == sizeof(segment))
+		{
+			fwrite(segment, 1, length, out);
+			stats->numRawBytes += length;
+			length = 0;
+		}
+		segment[length++] = (uint8)byte;
+	}
+
+	// No delimiter after it, so it can't be a frame
+	fwrite(segment, 1, length, out);
+	stats->numRawBytes += length;
+}
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+int main(int argc, char **argv)
+{
+	uint8 channel = DEFAULT_CHANNEL;
+	double tickRate = 0;
+	decodeStats_t stats = { 0, 0, 0, 0, 0 };
+	int option;
+
+	while((option = getopt(argc, argv, "c:r:")) != -1)
+	{
+		switch(option)
+		{
+			case 'c':
+				channel = (uint8)strtoul(optarg, NULL, 0);
+				break;
+			case 'r':
+				tickRate = strtod(optarg, NULL);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-c channel] [-r tickRate] < capture > log\n", argv[0]);
+				return 2;
+		}
+	}
+
+	Decode(stdin, stdout, channel, tickRate, &stats);
+	fprintf(stderr, "%lu records formatted, %lu raw bytes, %lu bad records\n",
+		stats.numRecords, stats.numRawBytes, stats.numBadRecords);
+	if(stats.numRecords != 0)
+		fprintf(stderr, "records took %lu bytes on the wire for %lu bytes of text (%.2fx smaller)\n",
+			stats.numRecordBytes, stats.numTextBytes, (double)stats.numTextBytes/stats.numRecordBytes);
+	return 0;
+}
+
+// EOF
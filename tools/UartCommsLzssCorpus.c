@@ -0,0 +1,209 @@
+//!
+//! @file 		UartCommsLzssCorpus.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Host tool which writes the synthetic logs the compression figures in the README
+//!				were measured on
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Build:
+//!			gcc -O2 -o UartCommsLzssCorpus tools/UartCommsLzssCorpus.c
+//!
+//!		Usage:
+//!			UartCommsLzssCorpus [-n numLines] [-r seed] telemetry|debug > corpus.log
+//!				telemetry: periodic sensor readings (tick stamp, ADC channel and counts,
+//!				temperature, battery voltage and state), 6000 lines by default.
+//!				debug: messages from a mix of modules, like the driver's own debug
+//!				prints, with a line number in front, 5000 lines by default.
+//!				Lines end with "\r\n", as UartComms_PutString() users send them. The same
+//!				arguments always give the same bytes, so
+//!					UartCommsLzssCorpus telemetry > telemetry.log
+//!					UartCommsLzssCorpus debug > debug.log
+//!					UartCommsLzssTool -b telemetry.log debug.log README.rst
+//!					UartCommsLzssTool -b -s 1024 telemetry.log debug.log README.rst
+//!				give the table in the README.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Defaults
+#define DEFAULT_NUM_TELEMETRY_LINES				(6000)
+#define DEFAULT_NUM_DEBUG_LINES					(5000)
+#define DEFAULT_SEED							(7)
+
+//! Number of elements in an array
+#define NUM_OF(array)							(sizeof(array)/sizeof((array)[0]))
+
+//===============================================================================================//
+//=================================== PRIVATE VARIABLES =========================================//
+//===============================================================================================//
+
+//! States in the telemetry lines, repeated to weight them
+static const char *const telemetryStates[] = { "IDLE", "IDLE", "RUN", "RUN", "RUN", "SLEEP" };
+
+//! Gaps between telemetry lines, in ticks
+static const uint32_t telemetryGaps[] = { 10, 10, 10, 11, 9 };
+
+//! Words in unknown commands
+static const char *const debugWords[] = { "foo", "bar", "xyz" };
+
+//===============================================================================================//
+//===================================== PRIVATE FUNCTIONS =======================================//
+//===============================================================================================//
+
+//! @brief		Returns the next number from a xorshift generator
+static uint32_t NextRandom(uint32_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+//! @brief		Returns a number from min to max, inclusive
+static uint32_t RandomRange(uint32_t *state, uint32_t min, uint32_t max)
+{
+	return min + NextRandom(state) % (max - min + 1);
+}
+
+//! @brief		Writes the telemetry corpus
+static void WriteTelemetry(uint32_t numLines, uint32_t *random)
+{
+	uint32_t tick = 0;
+	uint32_t i;
+
+	for(i = 0; i < numLines; i++)
+	{
+		// Temperature in tenths of a degree, battery in hundredths of a volt
+		uint32_t adc;
+		uint32_t temperature;
+		uint32_t battery;
+
+		tick += telemetryGaps[NextRandom(random) % NUM_OF(telemetryGaps)];
+		adc = RandomRange(random, 980, 1023);
+		temperature = RandomRange(random, 200, 249);
+		battery = RandomRange(random, 360, 379);
+		printf("[%8u] ADC ch%u=%4u temp=%u.%uC vbat=%u.%02uV state=%s\r\n",
+			tick, i % 4, adc, temperature/10, temperature % 10, battery/100, battery % 100,
+			telemetryStates[NextRandom(random) % NUM_OF(telemetryStates)]);
+	}
+}
+
+//! @brief		Writes the debug corpus
+static void WriteDebug(uint32_t numLines, uint32_t *random)
+{
+	uint32_t i;
+
+	for(i = 0; i < numLines; i++)
+	{
+		printf("%06u ", i);
+		switch(NextRandom(random) % 9)
+		{
+			case 0:
+				printf("UART_COMMS: Woke up comms UART.");
+				break;
+			case 1:
+				printf("UART_COMMS: Comms Uart TX task started.");
+				break;
+			case 2:
+				printf("MOTOR: set speed %u rpm", RandomRange(random, 0, 2000));
+				break;
+			case 3:
+				printf("MOTOR: stall detected on axis %u, retrying", RandomRange(random, 0, 2000));
+				break;
+			case 4:
+				{
+					uint32_t id = RandomRange(random, 0, 2000);
+					printf("CAN: rx id 0x%03X len %u", id, RandomRange(random, 0, 2000));
+				}
+				break;
+			case 5:
+				printf("CAN: tx queue full, dropped %u frames", RandomRange(random, 0, 2000));
+				break;
+			case 6:
+				printf("POWER: entering sleep, wakeup in %u ms", RandomRange(random, 0, 2000));
+				break;
+			case 7:
+				printf("CMD: unknown command '%s'", debugWords[NextRandom(random) % NUM_OF(debugWords)]);
+				break;
+			default:
+				printf("I2C: NACK from 0x%02X", RandomRange(random, 0, 2000));
+				break;
+		}
+		printf("\r\n");
+	}
+}
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+int main(int argc, char **argv)
+{
+	uint32_t numLines = 0;
+	uint32_t random = DEFAULT_SEED;
+	int option;
+
+	while((option = getopt(argc, argv, "n:r:")) != -1)
+	{
+		switch(option)
+		{
+			case 'n':
+				numLines = (uint32_t)strtoul(optarg, NULL, 0);
+				break;
+			case 'r':
+				random = (uint32_t)strtoul(optarg, NULL, 0);
+				break;
+			default:
+				optind = argc;
+				break;
+		}
+	}
+
+	if((optind != argc - 1) || (random == 0))
+	{
+		fprintf(stderr, "Usage: %s [-n numLines] [-r seed] telemetry|debug > corpus.log\n"
+						"seed must not be 0\n", argv[0]);
+		return 2;
+	}
+
+	if(strcmp(argv[optind], "telemetry") == 0)
+		WriteTelemetry((numLines != 0) ? numLines : DEFAULT_NUM_TELEMETRY_LINES, &random);
+	else if(strcmp(argv[optind], "debug") == 0)
+		WriteDebug((numLines != 0) ? numLines : DEFAULT_NUM_DEBUG_LINES, &random);
+	else
+	{
+		fprintf(stderr, "Unknown corpus %s, must be telemetry or debug\n", argv[optind]);
+		return 2;
+	}
+
+	return 0;
+}
+
+// EOF
@@ -0,0 +1,301 @@
+//!
+//! @file 		UartCommsLzssTool.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Host tool which decodes the output of a UartComms port with compression on, and
+//!				measures how well a log compresses
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Build:
+//!			gcc -O2 -Isrc -o UartCommsLzssTool tools/UartCommsLzssTool.c src/UartCommsLzss.c src/UartCommsFrame.c
+//!
+//!		Usage:
+//!			UartCommsLzssTool [-c channel] < capture.bin > log.txt
+//!				Decodes a capture of the UART (e.g. from a pseudo-terminal or logic analyser).
+//!				Compressed block frames are decompressed, everything else (urgent writes and
+//!				blocks which didn't compress) is passed through. Frames which fail the CRC are
+//!				dropped, and decoding picks up again at the next delimiter.
+//!			UartCommsLzssTool -b [-s blockSize] [-c channel] corpus.txt
+//!				Compresses a log the way the TX task does, checks it decodes back to the
+//!				same bytes, and prints the bytes saved and the effective throughput gain.
+//!
+//!		channel and blockSize must match configUART_COMMS_COMPRESS_CHANNEL and
+//!		configUART_COMMS_COMPRESS_BLOCK_SIZE on the target.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// Needed for fmemopen() and open_memstream()
+#define _GNU_SOURCE
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// User includes
+#include "UartCommsLzss.h"
+#include "UartCommsFrame.h"
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Defaults, the same as UartComms.h
+#define DEFAULT_CHANNEL							(0xFF)
+#define DEFAULT_BLOCK_SIZE						(256)
+
+//! Largest payload of a compressed block frame (channel ID and compressed block)
+#define MAX_PAYLOAD_SIZE						(1 + UART_COMMS_LZSS_MAX_COMPRESSED_SIZE(UART_COMMS_LZSS_MAX_BLOCK_SIZE))
+
+//! Largest compressed block frame on the wire
+#define MAX_FRAME_SIZE							(UART_COMMS_FRAME_MAX_ENCODED_SIZE(MAX_PAYLOAD_SIZE))
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! What the decoder found
+typedef struct
+{
+	unsigned long numBlocks;			//!< Compressed blocks decoded
+	unsigned long numRawBytes;			//!< Bytes passed through as they were
+	unsigned long numBadBlocks;			//!< Compressed blocks which passed the CRC but didn't decompress
+} decodeStats_t;
+
+//===============================================================================================//
+//===================================== PRIVATE FUNCTIONS =======================================//
+//===============================================================================================//
+
+//! @brief		Decodes the bytes between two delimiters
+//! @details	A segment which is a good frame on the compression channel is decompressed,
+//!				anything else is raw output and is written as it is.
+static void DecodeSegment(const uint8 *segment, uint32 length, uint8 channel, FILE *out, decodeStats_t *stats)
+{
+	static uint8 payload[MAX_PAYLOAD_SIZE + UART_COMMS_FRAME_CRC_SIZE];
+	static uint8 block[UART_COMMS_LZSS_MAX_BLOCK_SIZE];
+	UartCommsFrameDecoder_t decoder;
+	uint32 i;
+
+	if(length == 0)
+		return;
+
+	UartCommsFrameDecoder_Init(&decoder, payload, sizeof(payload));
+	for(i = 0; i < length; i++)
+		UartCommsFrameDecoder_Feed(&decoder, segment[i]);
+
+	if((UartCommsFrameDecoder_Feed(&decoder, UART_COMMS_FRAME_DELIMITER) == UART_COMMS_FRAME_COMPLETE)
+		&& (decoder.length >= 1) && (payload[0] == channel))
+	{
+		uint32 blockLength = UartCommsLzss_Decompress(&payload[1], decoder.length - 1, block, sizeof(block));
+		if(blockLength != UART_COMMS_LZSS_ERROR)
+		{
+			fwrite(block, 1, blockLength, out);
+			stats->numBlocks++;
+			return;
+		}
+		stats->numBadBlocks++;
+	}
+
+	fwrite(segment, 1, length, out);
+	stats->numRawBytes += length;
+}
+
+//! @brief		Decodes a capture from in to out
+static void Decode(FILE *in, FILE *out, uint8 channel, decodeStats_t *stats)
+{
+	static uint8 segment[MAX_FRAME_SIZE];
+	uint32 length = 0;
+	int byte;
+
+	while((byte = fgetc(in)) != EOF)
+	{
+		if(byte == UART_COMMS_FRAME_DELIMITER)
+		{
+			DecodeSegment(segment, length, channel, out, stats);
+			length = 0;
+			continue;
+		}
+
+		// Longer than any frame, so it's raw output
+		if(length == sizeof(segment))
+		{
+			fwrite(segment, 1, length, out);
+			stats->numRawBytes += length;
+			length = 0;
+		}
+		segment[length++] = (uint8)byte;
+	}
+
+	// No delimiter after it, so it can't be a frame
+	fwrite(segment, 1, length, out);
+	stats->numRawBytes += length;
+}
+
+//! @brief		Reads a whole file into memory
+static uint8* ReadFile(const char *fileName, uint32 *length)
+{
+	FILE *file = fopen(fileName, "rb");
+	uint8 *data = NULL;
+	long size;
+
+	if(file == NULL)
+		return NULL;
+	if((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) >= 0) && (fseek(file, 0, SEEK_SET) == 0))
+	{
+		data = malloc(size + 1);
+		if((data != NULL) && (fread(data, 1, size, file) != (size_t)size))
+		{
+			free(data);
+			data = NULL;
+		}
+		*length = (uint32)size;
+	}
+	fclose(file);
+	return data;
+}
+
+//! @brief		Compresses a corpus in blocks, as the TX task would, and reports the gain
+//! @details	Assumes every block is full, which is what a busy log (the case compression is
+//!				for) gives. Blocks sent before they are full, on the deadline, compress less.
+//! @returns	0 if the stream decodes back to the corpus, otherwise 1
+static int Bench(const char *fileName, uint32 blockSize, uint8 channel)
+{
+	static UartCommsLzss_Encoder_t encoder;
+	static uint8 compressed[UART_COMMS_LZSS_MAX_COMPRESSED_SIZE(UART_COMMS_LZSS_MAX_BLOCK_SIZE)];
+	const uint8 header[1] = { channel };
+	uint32 corpusLength = 0;
+	uint8 *corpus = ReadFile(fileName, &corpusLength);
+	uint8 *stream;
+	uint32 streamLength = 0;
+	uint32 numCompressed = 0;
+	uint32 numBlocks = 0;
+	uint32 i;
+	char *decoded = NULL;
+	size_t decodedLength = 0;
+	FILE *decodedFile;
+	decodeStats_t stats = { 0, 0, 0 };
+	int isMatch;
+
+	if(corpus == NULL)
+	{
+		fprintf(stderr, "Could not read %s\n", fileName);
+		return 1;
+	}
+
+	// Never bigger than the corpus plus a delimiter per block
+	stream = malloc(corpusLength + corpusLength/blockSize + 1);
+
+	for(i = 0; i < corpusLength; i += blockSize)
+	{
+		uint32 length = (corpusLength - i < blockSize) ? corpusLength - i : blockSize;
+		uint32 compressedLength = UartCommsLzss_Compress(&encoder, &corpus[i], length, compressed);
+		uint32 frameLength = 1 + UartCommsFrame_EncodeWithHeader(header, 1, compressed, compressedLength, NULL);
+
+		numBlocks++;
+		if(frameLength < length)
+		{
+			stream[streamLength] = UART_COMMS_FRAME_DELIMITER;
+			UartCommsFrame_EncodeWithHeader(header, 1, compressed, compressedLength, &stream[streamLength + 1]);
+			streamLength += frameLength;
+			numCompressed++;
+		}
+		else
+		{
+			memcpy(&stream[streamLength], &corpus[i], length);
+			streamLength += length;
+		}
+	}
+
+	// Check it decodes back to the corpus
+	decodedFile = open_memstream(&decoded, &decodedLength);
+	{
+		FILE *streamFile = fmemopen(stream, streamLength, "rb");
+		Decode(streamFile, decodedFile, channel, &stats);
+		fclose(streamFile);
+	}
+	fclose(decodedFile);
+	isMatch = (decodedLength == corpusLength) && (memcmp(decoded, corpus, corpusLength) == 0);
+
+	printf("%s: %u bytes, %u byte blocks (%u of %u compressed)\n", fileName, corpusLength, blockSize, numCompressed, numBlocks);
+	printf("  on the wire: %u bytes (%.1f%% of the original)\n", streamLength, 100.0*streamLength/corpusLength);
+	printf("  effective throughput gain: %.2fx\n", (double)corpusLength/streamLength);
+	printf("  round trip: %s\n", isMatch ? "OK" : "MISMATCH");
+
+	free(decoded);
+	free(stream);
+	free(corpus);
+	return isMatch ? 0 : 1;
+}
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+int main(int argc, char **argv)
+{
+	uint8 channel = DEFAULT_CHANNEL;
+	uint32 blockSize = DEFAULT_BLOCK_SIZE;
+	int isBench = 0;
+	int option;
+
+	while((option = getopt(argc, argv, "bc:s:")) != -1)
+	{
+		switch(option)
+		{
+			case 'b':
+				isBench = 1;
+				break;
+			case 'c':
+				channel = (uint8)strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				blockSize = (uint32)strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-c channel] < capture > log\n"
+								"       %s -b [-s blockSize] [-c channel] corpus...\n", argv[0], argv[0]);
+				return 2;
+		}
+	}
+
+	if((blockSize == 0) || (blockSize > UART_COMMS_LZSS_MAX_BLOCK_SIZE))
+	{
+		fprintf(stderr, "Block size must be 1 to %u\n", UART_COMMS_LZSS_MAX_BLOCK_SIZE);
+		return 2;
+	}
+
+	if(isBench)
+	{
+		int result = 0;
+		for(; optind < argc; optind++)
+			result |= Bench(argv[optind], blockSize, channel);
+		return result;
+	}
+	else
+	{
+		decodeStats_t stats = { 0, 0, 0 };
+		Decode(stdin, stdout, channel, &stats);
+		fprintf(stderr, "%lu blocks decompressed, %lu raw bytes, %lu bad blocks\n",
+			stats.numBlocks, stats.numRawBytes, stats.numBadBlocks);
+		return 0;
+	}
+}
+
+// EOF
@@ -0,0 +1,316 @@
+//!
+//! @file 		UartCommsRingBufferStress.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Host stress test which hammers a UartCommsRingBuffer from two threads
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Build:
+//!			gcc -O2 -pthread -Isrc -o UartCommsRingBufferStress tools/UartCommsRingBufferStress.c src/UartCommsRingBuffer.c
+//!		and, to also check for data races:
+//!			gcc -O1 -g -fsanitize=thread -pthread -Isrc ...
+//!
+//!		Usage:
+//!			UartCommsRingBufferStress [-n numBytes] [-s size] [-c maxChunk] [-r seed]
+//!				A producer thread writes numBytes through the ring buffer in chunks of 1 to
+//!				maxChunk bytes, and a consumer thread reads them back in chunks of its own,
+//!				with UartCommsRingBuffer_Read() or UartCommsRingBuffer_Peek() and
+//!				UartCommsRingBuffer_Consume(). Every byte depends on its position in the
+//!				stream, so the consumer catches any byte which is lost, repeated, reordered or
+//!				torn. Count() and Space() are checked against the size on both sides.
+//!				Without -s, sizes from 1 to 4096 bytes are run in turn. Exits with 1 if any
+//!				check fails.
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// System includes
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// User includes
+#include "UartCommsRingBuffer.h"
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Defaults
+#define DEFAULT_NUM_BYTES						(4u*1024u*1024u)
+#define DEFAULT_MAX_CHUNK						(64)
+
+//! Largest ring buffer and chunk
+#define MAX_SIZE								(1u << 20)
+
+//! Failures printed before the consumer gives up
+#define MAX_FAILURES							(10)
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! One run, shared by both threads
+typedef struct
+{
+	UartCommsRingBuffer_t ringBuffer;
+	uint32 size;						//!< Size of the ring buffer
+	uint32 numBytes;					//!< Bytes to send through it
+	uint32 maxChunk;					//!< Largest write or read
+	uint32 seed;						//!< Seed for the chunk sizes
+	uint32 numFailures;					//!< Checks which failed, shared by both threads
+	uint32 numWriteCalls;				//!< Writes which moved at least one byte
+	uint32 numReadCalls;				//!< Reads which moved at least one byte
+} run_t;
+
+//===============================================================================================//
+//===================================== PRIVATE FUNCTIONS =======================================//
+//===============================================================================================//
+
+//! @brief		Returns the byte at position index in the stream
+static uint8 StreamByte(uint32 index)
+{
+	return (uint8)((index*2654435761u) >> 24) ^ (uint8)index;
+}
+
+
+//! @brief		Returns the next number from a xorshift generator
+static uint32 NextRandom(uint32 *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+
+//! @brief		Records a failed check
+static void Fail(run_t *run, const char *what, uint32 index, uint32 value)
+{
+	if(__atomic_fetch_add(&run->numFailures, 1, __ATOMIC_RELAXED) < MAX_FAILURES)
+		fprintf(stderr, "size %u: %s at byte %u (got %u)\n", run->size, what, index, value);
+}
+
+
+//! @brief		Checks Count() and Space() can't be more than the size
+static void CheckLevels(run_t *run, uint32 index)
+{
+	uint32 count = UartCommsRingBuffer_Count(&run->ringBuffer);
+	uint32 space = UartCommsRingBuffer_Space(&run->ringBuffer);
+
+	if(count > run->size)
+		Fail(run, "count more than the size", index, count);
+	if(space > run->size)
+		Fail(run, "space more than the size", index, space);
+}
+
+
+//! @brief		Producer thread
+static void *Producer(void *arg)
+{
+	run_t *run = (run_t*)arg;
+	static uint8 chunk[MAX_SIZE];
+	uint32 random = run->seed;
+	uint32 sent = 0;
+
+	while((sent < run->numBytes) && (__atomic_load_n(&run->numFailures, __ATOMIC_RELAXED) < MAX_FAILURES))
+	{
+		uint32 length = 1 + NextRandom(&random) % run->maxChunk;
+		uint32 written;
+		uint32 i;
+
+		if(length > run->numBytes - sent)
+			length = run->numBytes - sent;
+		for(i = 0; i < length; i++)
+			chunk[i] = StreamByte(sent + i);
+
+		CheckLevels(run, sent);
+		written = UartCommsRingBuffer_Write(&run->ringBuffer, chunk, length);
+		if(written > length)
+			Fail(run, "wrote more than asked", sent, written);
+		if(written == 0)
+		{
+			sched_yield();
+			continue;
+		}
+		run->numWriteCalls++;
+		sent += written;
+	}
+
+	return NULL;
+}
+
+
+//! @brief		Consumer thread
+static void *Consumer(void *arg)
+{
+	run_t *run = (run_t*)arg;
+	static uint8 chunk[MAX_SIZE];
+	uint32 random = run->seed ^ 0x9E3779B9u;
+	uint32 received = 0;
+
+	while((received < run->numBytes) && (__atomic_load_n(&run->numFailures, __ATOMIC_RELAXED) < MAX_FAILURES))
+	{
+		uint32 choice = NextRandom(&random);
+		uint32 length = 1 + choice % run->maxChunk;
+		const uint8 *data;
+		uint32 numRead;
+		uint32 i;
+
+		CheckLevels(run, received);
+		if(choice & 0x80000000u)
+		{
+			numRead = UartCommsRingBuffer_Read(&run->ringBuffer, chunk, length);
+			if(numRead > length)
+				Fail(run, "read more than asked", received, numRead);
+			data = chunk;
+		}
+		else
+		{
+			numRead = UartCommsRingBuffer_Peek(&run->ringBuffer, &data);
+			if(numRead > run->size)
+				Fail(run, "peeked more than the size", received, numRead);
+			if(numRead > length)
+				numRead = length;
+		}
+
+		if(numRead == 0)
+		{
+			sched_yield();
+			continue;
+		}
+
+		for(i = 0; i < numRead; i++)
+		{
+			if(data[i] != StreamByte(received + i))
+			{
+				Fail(run, "wrong byte", received + i, data[i]);
+				break;
+			}
+		}
+
+		if(!(choice & 0x80000000u))
+			UartCommsRingBuffer_Consume(&run->ringBuffer, numRead);
+		run->numReadCalls++;
+		received += numRead;
+	}
+
+	return NULL;
+}
+
+
+//! @brief		Runs one size
+//! @returns	Number of failed checks
+static uint32 Run(uint32 size, uint32 numBytes, uint32 maxChunk, uint32 seed)
+{
+	static uint8 storage[MAX_SIZE];
+	static run_t run;
+	pthread_t producer;
+	pthread_t consumer;
+	struct timespec start;
+	struct timespec end;
+	double seconds;
+
+	run.size = size;
+	run.numBytes = numBytes;
+	run.maxChunk = maxChunk;
+	run.seed = seed;
+	run.numFailures = 0;
+	run.numWriteCalls = 0;
+	run.numReadCalls = 0;
+	UartCommsRingBuffer_Init(&run.ringBuffer, storage, size);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if((pthread_create(&consumer, NULL, Consumer, &run) != 0)
+		|| (pthread_create(&producer, NULL, Producer, &run) != 0))
+	{
+		fprintf(stderr, "couldn't create the threads\n");
+		exit(2);
+	}
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	if((run.numFailures == 0) && (UartCommsRingBuffer_Count(&run.ringBuffer) != 0))
+		Fail(&run, "bytes left over", numBytes, UartCommsRingBuffer_Count(&run.ringBuffer));
+
+	seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec)/1e9;
+	printf("size %7u: %u bytes, %u writes, %u reads, %.1f MB/s, %s\n",
+		size, numBytes, run.numWriteCalls, run.numReadCalls, numBytes/seconds/1e6,
+		(run.numFailures == 0) ? "ok" : "FAILED");
+	return run.numFailures;
+}
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+int main(int argc, char **argv)
+{
+	static const uint32 sizes[] = { 1, 2, 16, 64, 256, 4096 };
+	uint32 numBytes = DEFAULT_NUM_BYTES;
+	uint32 size = 0;
+	uint32 maxChunk = DEFAULT_MAX_CHUNK;
+	uint32 seed = 1;
+	uint32 numFailures = 0;
+	uint32 i;
+	int option;
+
+	while((option = getopt(argc, argv, "n:s:c:r:")) != -1)
+	{
+		switch(option)
+		{
+			case 'n':
+				numBytes = (uint32)strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				size = (uint32)strtoul(optarg, NULL, 0);
+				break;
+			case 'c':
+				maxChunk = (uint32)strtoul(optarg, NULL, 0);
+				break;
+			case 'r':
+				seed = (uint32)strtoul(optarg, NULL, 0);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-n numBytes] [-s size] [-c maxChunk] [-r seed]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if(((size & (size - 1)) != 0) || (size > MAX_SIZE) || (maxChunk == 0) || (maxChunk > MAX_SIZE) || (seed == 0))
+	{
+		fprintf(stderr, "size must be a power of two up to %u, maxChunk 1 to %u and seed not 0\n", MAX_SIZE, MAX_SIZE);
+		return 2;
+	}
+
+	if(size != 0)
+		numFailures = Run(size, numBytes, maxChunk, seed);
+	else
+	{
+		for(i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+			numFailures += Run(sizes[i], numBytes, maxChunk, seed);
+	}
+
+	return (numFailures == 0) ? 0 : 1;
+}
+
+// EOF
@@ -0,0 +1,245 @@
+//!
+//! @file 		UartCommsTraceTool.c
+//! @author 	Geoffrey Hunter <gbmhunter@gmail.com> (www.cladlab.com)
+//! @date 		16/10/2026
+//! @brief 		Host tool which prints a UartComms wire trace, or replays its received bytes
+//! @details
+//!		<b>Last Modified:			</b> 16/10/2026					\n
+//!		<b>Version:					</b> v1.0.0						\n
+//!		<b>Company:					</b> CladLabs					\n
+//!		<b>Project:					</b> Free Code Modules			\n
+//!		<b>Language:				</b> C							\n
+//!		<b>Compiler:				</b> GCC						\n
+//! 	<b>uC Model:				</b> Linux (host)				\n
+//!		<b>Computer Architecture:	</b> x86						\n
+//!		<b>Documentation Format:	</b> Doxygen					\n
+//!		<b>License:					</b> GPLv3						\n
+//!
+//!		Build:
+//!			gcc -O2 -Isrc -o UartCommsTraceTool tools/UartCommsTraceTool.c src/UartCommsTrace.c src/UartCommsRingBuffer.c
+//!
+//!		Usage:
+//!			UartCommsTraceTool trace.bin
+//!				Prints every record (time, direction, hex and text) and a summary.
+//!			UartCommsTraceTool -r trace.bin > /dev/ttyUSB0
+//!				Writes the received bytes to stdout at the times they were recorded, e.g. into
+//!				a serial port or the pseudo-terminal of the POSIX backend, so a target sees the
+//!				same traffic again.
+//!			UartCommsTraceTool -m trace.bin > /dev/ttyUSB0
+//!				Same as -r, but as fast as stdout takes them.
+//!
+//!		Trace files are written by UartComms_DumpTrace() (see UartCommsTrace.h for the format).
+//!
+//! 	CHANGELOG:
+//!			v1.0.0 -> Initial version.
+//!
+
+//===============================================================================================//
+//========================================= INCLUDES ============================================//
+//===============================================================================================//
+
+// Needed for nanosleep()
+#define _GNU_SOURCE
+
+// System includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// User includes
+#include "UartCommsTrace.h"
+
+//===============================================================================================//
+//==================================== PRIVATE DEFINES ==========================================//
+//===============================================================================================//
+
+//! Data bytes printed per line
+#define BYTES_PER_LINE							(16)
+
+//===============================================================================================//
+//=================================== PRIVATE TYPEDEF's =========================================//
+//===============================================================================================//
+
+//! What to do with the trace
+typedef enum
+{
+	MODE_PRINT,							//!< Print it
+	MODE_REPLAY_REAL_TIME,				//!< Write the received bytes at their recorded times
+	MODE_REPLAY_MAX_SPEED				//!< Write the received bytes back to back
+} toolMode_t;
+
+//===============================================================================================//
+//===================================== PRIVATE FUNCTIONS =======================================//
+//===============================================================================================//
+
+//! @brief		Reads a whole file into memory
+static uint8* ReadFile(const char *fileName, uint32 *length)
+{
+	FILE *file = fopen(fileName, "rb");
+	uint8 *data = NULL;
+	long size;
+
+	if(file == NULL)
+		return NULL;
+	if((fseek(file, 0, SEEK_END) == 0) && ((size = ftell(file)) >= 0) && (fseek(file, 0, SEEK_SET) == 0))
+	{
+		data = malloc(size + 1);
+		if((data != NULL) && (fread(data, 1, size, file) != (size_t)size))
+		{
+			free(data);
+			data = NULL;
+		}
+		*length = (uint32)size;
+	}
+	fclose(file);
+	return data;
+}
+
+//! @brief		Prints one record's data, BYTES_PER_LINE bytes per line in hex and as text
+static void PrintData(const UartCommsTrace_Record_t *record, double time)
+{
+	uint32 line;
+
+	for(line = 0; line < record->numBytes; line += BYTES_PER_LINE)
+	{
+		uint32 i;
+
+		if(line == 0)
+			printf("%12.3f %s ", time, (record->direction == UART_COMMS_TRACE_DIR_TX) ? "TX" : "RX");
+		else
+			printf("%15s ", "");
+
+		for(i = line; i < line + BYTES_PER_LINE; i++)
+		{
+			if(i < record->numBytes)
+				printf(" %02X", record->data[i]);
+			else
+				printf("   ");
+		}
+		printf("  |");
+		for(i = line; (i < line + BYTES_PER_LINE) && (i < record->numBytes); i++)
+			putchar(((record->data[i] >= 0x20) && (record->data[i] < 0x7F)) ? record->data[i] : '.');
+		printf("|\n");
+	}
+}
+
+//! @brief		Sleeps until time (in seconds after start)
+static void SleepUntil(const struct timespec *start, double time)
+{
+	struct timespec now;
+	double elapsed;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	elapsed = (double)(now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec)/1e9;
+	if(time > elapsed)
+	{
+		struct timespec delay;
+		delay.tv_sec = (time_t)(time - elapsed);
+		delay.tv_nsec = (long)((time - elapsed - delay.tv_sec)*1e9);
+		nanosleep(&delay, NULL);
+	}
+}
+
+//===============================================================================================//
+//===================================== PUBLIC FUNCTIONS ========================================//
+//===============================================================================================//
+
+int main(int argc, char **argv)
+{
+	toolMode_t mode = MODE_PRINT;
+	uint8 *trace;
+	uint32 length = 0;
+	uint32 pos = UART_COMMS_TRACE_FILE_HEADER_SIZE;
+	uint16 ticksPerSecond;
+	unsigned long traceTicks = 0;
+	unsigned long numBytes[2] = { 0, 0 };
+	unsigned long numGaps = 0;
+	struct timespec start;
+	int option;
+
+	while((option = getopt(argc, argv, "rm")) != -1)
+	{
+		switch(option)
+		{
+			case 'r':
+				mode = MODE_REPLAY_REAL_TIME;
+				break;
+			case 'm':
+				mode = MODE_REPLAY_MAX_SPEED;
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-r | -m] trace.bin\n", argv[0]);
+				return 2;
+		}
+	}
+	if(optind != argc - 1)
+	{
+		fprintf(stderr, "Usage: %s [-r | -m] trace.bin\n", argv[0]);
+		return 2;
+	}
+
+	trace = ReadFile(argv[optind], &length);
+	if(trace == NULL)
+	{
+		fprintf(stderr, "Could not read %s\n", argv[optind]);
+		return 1;
+	}
+	ticksPerSecond = UartCommsTrace_DecodeFileHeader(trace, length);
+	if(ticksPerSecond == 0)
+	{
+		fprintf(stderr, "%s is not a trace file\n", argv[optind]);
+		free(trace);
+		return 1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while(pos < length)
+	{
+		UartCommsTrace_Record_t record;
+		uint32 recordSize = UartCommsTrace_ParseRecord(&trace[pos], length - pos, &record);
+		double time;
+
+		if(recordSize == 0)
+		{
+			fprintf(stderr, "Trace ends part way through a record\n");
+			break;
+		}
+		pos += recordSize;
+		traceTicks += record.tickDelta;
+		time = (double)traceTicks/ticksPerSecond;
+
+		if(record.numBytes == 0)
+		{
+			numGaps++;
+			if(mode == MODE_PRINT)
+				printf("%12.3f    -- trace ring was full, bytes lost --\n", time);
+			continue;
+		}
+		numBytes[(record.direction == UART_COMMS_TRACE_DIR_TX) ? 1 : 0] += record.numBytes;
+
+		if(mode == MODE_PRINT)
+		{
+			PrintData(&record, time);
+		}
+		else if(record.direction == UART_COMMS_TRACE_DIR_RX)
+		{
+			if(mode == MODE_REPLAY_REAL_TIME)
+				SleepUntil(&start, time);
+			fwrite(record.data, 1, record.numBytes, stdout);
+			fflush(stdout);
+		}
+	}
+
+	if(mode == MODE_PRINT)
+	{
+		printf("%lu RX bytes, %lu TX bytes, %lu gaps, %.3f s (%u ticks per second)\n",
+			numBytes[0], numBytes[1], numGaps, (double)traceTicks/ticksPerSecond, ticksPerSecond);
+	}
+
+	free(trace);
+	return 0;
+}
+
+// EOF